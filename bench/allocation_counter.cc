@@ -0,0 +1,119 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "allocation_counter.h"
+
+namespace {
+
+/** The number of allocations made so far. */
+std::atomic<uint64_t> allocations(0);
+
+/** Allocate memory, counting the allocation.
+ * @param size the required size, in octets
+ * @return a pointer to the allocated memory, or 0 if unsuccessful
+ */
+void* counted_alloc(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+/** Allocate aligned memory, counting the allocation.
+ * @param size the required size, in octets
+ * @param align the required alignment, in octets
+ * @return a pointer to the allocated memory, or 0 if unsuccessful
+ */
+void* counted_alloc(std::size_t size, std::align_val_t align) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = 0;
+	if (posix_memalign(&ptr, std::max(std::size_t(align), sizeof(void*)),
+		size ? size : 1)) {
+
+		return 0;
+	}
+	return ptr;
+}
+
+} /* anonymous namespace */
+
+namespace horace {
+
+uint64_t allocation_count() {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+} /* namespace horace */
+
+void* operator new(std::size_t size) {
+	if (void* ptr = counted_alloc(size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	if (void* ptr = counted_alloc(size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+	if (void* ptr = counted_alloc(size, align)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+	if (void* ptr = counted_alloc(size, align)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+	std::free(ptr);
+}
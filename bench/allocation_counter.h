@@ -0,0 +1,22 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_ALLOCATION_COUNTER
+#define LIBHOLMES_HORACE_ALLOCATION_COUNTER
+
+#include <cstdint>
+
+namespace horace {
+
+/** Get the number of dynamic memory allocations made so far.
+ * This counts every call to the global operator new, in any thread and
+ * in any loaded module, since the benchmark program replaces it.
+ * @return the number of allocations
+ */
+uint64_t allocation_count();
+
+} /* namespace horace */
+
+#endif
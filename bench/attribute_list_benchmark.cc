@@ -0,0 +1,56 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/unsigned_integer_attribute.h"
+
+#include "attribute_list_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of attributes in each list. */
+const int attr_count = 8;
+
+/** A sink for attribute content, to prevent it from being optimised
+ * away. */
+volatile uint64_t sink;
+
+} /* anonymous namespace */
+
+attribute_list_benchmark::attribute_list_benchmark(bool find):
+	benchmark(find ? "attribute_list.find" : "attribute_list.insert"),
+	_find(find) {}
+
+void attribute_list_benchmark::setup() {
+	for (int i = 0; i != attr_count; ++i) {
+		_attrs.insert(std::make_unique<unsigned_integer_attribute>(
+			i, i * 1000));
+	}
+}
+
+uint64_t attribute_list_benchmark::run(uint64_t count) {
+	uint64_t octets = 0;
+	if (_find) {
+		uint64_t total = 0;
+		for (uint64_t i = 0; i != count; ++i) {
+			total += _attrs.find_one<unsigned_integer_attribute>(
+				i % attr_count).content();
+		}
+		sink = total;
+	} else {
+		for (uint64_t i = 0; i != count; ++i) {
+			attribute_list attrs;
+			for (int j = 0; j != attr_count; ++j) {
+				attrs.insert(std::make_unique<
+					unsigned_integer_attribute>(j, i));
+			}
+			octets += attrs.length();
+		}
+	}
+	return octets;
+}
+
+} /* namespace horace */
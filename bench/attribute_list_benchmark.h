@@ -0,0 +1,39 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_ATTRIBUTE_LIST_BENCHMARK
+#define LIBHOLMES_HORACE_ATTRIBUTE_LIST_BENCHMARK
+
+#include "horace/attribute_list.h"
+
+#include "benchmark.h"
+
+namespace horace {
+
+/** A benchmark for building or searching attribute lists.
+ * The lists used are of a similar size and composition to those found
+ * in a typical packet record.
+ */
+class attribute_list_benchmark:
+	public benchmark {
+private:
+	/** True to measure searching, false to measure building. */
+	bool _find;
+
+	/** An attribute list to be searched. */
+	attribute_list _attrs;
+public:
+	/** Construct attribute list benchmark.
+	 * @param find true to measure searching, false to measure building
+	 */
+	explicit attribute_list_benchmark(bool find);
+
+	virtual void setup();
+	virtual uint64_t run(uint64_t count);
+};
+
+} /* namespace horace */
+
+#endif
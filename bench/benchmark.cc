@@ -0,0 +1,77 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** Perform a single timed run of a benchmark.
+ * @param bm the benchmark
+ * @param count the number of iterations
+ * @return the result
+ */
+benchmark::result timed_run(benchmark& bm, uint64_t count) {
+	bm.prepare(count);
+	benchmark::result res;
+	res.count = count;
+	uint64_t alloc_start = allocation_count();
+	auto start = std::chrono::steady_clock::now();
+	res.octets = bm.run(count);
+	auto finish = std::chrono::steady_clock::now();
+	res.allocations = allocation_count() - alloc_start;
+	res.elapsed = std::chrono::duration<double>(finish - start).count();
+	return res;
+}
+
+} /* anonymous namespace */
+
+benchmark::benchmark(const std::string& name):
+	_name(name) {}
+
+void benchmark::setup() {}
+
+void benchmark::prepare(uint64_t count) {}
+
+void benchmark::teardown() {}
+
+benchmark::result benchmark::measure(double min_time,
+	unsigned int repeats) {
+
+	setup();
+
+	// Calibrate by doubling the iteration count until a run takes
+	// a significant fraction of the minimum time, then scale it up
+	// (with some margin) to reach the minimum time.
+	uint64_t count = 1;
+	result res = timed_run(*this, count);
+	while (res.elapsed < min_time / 16) {
+		count *= 2;
+		res = timed_run(*this, count);
+	}
+	count = std::max<uint64_t>(count,
+		count * (min_time * 1.25 / res.elapsed));
+
+	std::vector<result> results;
+	for (unsigned int i = 0; i != std::max(repeats, 1U); ++i) {
+		results.push_back(timed_run(*this, count));
+	}
+
+	teardown();
+
+	std::sort(results.begin(), results.end(),
+		[](const result& lhs, const result& rhs) {
+			return lhs.elapsed < rhs.elapsed;
+		});
+	return results[results.size() / 2];
+}
+
+} /* namespace horace */
@@ -0,0 +1,90 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_BENCHMARK
+#define LIBHOLMES_HORACE_BENCHMARK
+
+#include <cstdint>
+#include <string>
+
+namespace horace {
+
+/** An abstract base class to represent a benchmark.
+ * Each benchmark performs some number of iterations of an operation,
+ * where one iteration normally corresponds to one record. The number of
+ * iterations is chosen by the caller so that each measurement takes a
+ * roughly constant amount of time.
+ */
+class benchmark {
+private:
+	/** The name of this benchmark. */
+	std::string _name;
+public:
+	/** A structure to hold the result of a measurement. */
+	struct result {
+		/** The number of iterations performed. */
+		uint64_t count;
+
+		/** The elapsed time, in seconds. */
+		double elapsed;
+
+		/** The number of octets processed. */
+		uint64_t octets;
+
+		/** The number of dynamic memory allocations made. */
+		uint64_t allocations;
+	};
+
+	/** Construct benchmark.
+	 * @param name the name of this benchmark
+	 */
+	explicit benchmark(const std::string& name);
+
+	virtual ~benchmark() = default;
+
+	/** Get the name of this benchmark.
+	 * @return the name
+	 */
+	const std::string& name() const {
+		return _name;
+	}
+
+	/** Prepare to perform any number of measurements.
+	 * This is not timed. By default no action is taken.
+	 */
+	virtual void setup();
+
+	/** Prepare to perform a given number of iterations.
+	 * This is not timed, and is called before each call to run.
+	 * By default no action is taken.
+	 * @param count the number of iterations
+	 */
+	virtual void prepare(uint64_t count);
+
+	/** Perform a given number of iterations.
+	 * @param count the number of iterations
+	 * @return the number of octets processed
+	 */
+	virtual uint64_t run(uint64_t count) = 0;
+
+	/** Clean up after all measurements have been performed.
+	 * This is not timed. By default no action is taken.
+	 */
+	virtual void teardown();
+
+	/** Measure the performance of this benchmark.
+	 * The number of iterations is first calibrated so that each run
+	 * takes at least the given minimum time. A number of runs are then
+	 * performed, and the median (by rate) is returned.
+	 * @param min_time the minimum time for each run, in seconds
+	 * @param repeats the number of runs
+	 * @return the median result
+	 */
+	result measure(double min_time, unsigned int repeats);
+};
+
+} /* namespace horace */
+
+#endif
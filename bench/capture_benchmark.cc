@@ -0,0 +1,80 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <filesystem>
+
+#include "horace/record.h"
+#include "horace/hash.h"
+#include "horace/endpoint.h"
+#include "horace/session_builder.h"
+#include "horace/new_session_writer.h"
+
+#include "endpoint_loader.h"
+#include "synthetic_event_reader.h"
+#include "capture_benchmark.h"
+
+namespace horace {
+
+capture_benchmark::capture_benchmark(const endpoint_loader& loader,
+	bool spool, size_t length, const std::string& algorithm):
+	benchmark(std::string(spool ? "capture.spool" : "capture.null") +
+		(algorithm.empty() ? "" : "+" + algorithm) +
+		"." + std::to_string(length)),
+	_loader(&loader),
+	_spool(spool),
+	_length(length),
+	_algorithm(algorithm) {}
+
+capture_benchmark::~capture_benchmark() {}
+
+void capture_benchmark::setup() {
+	if (_spool) {
+		_tmpdir = std::make_unique<temporary_directory>();
+	}
+}
+
+void capture_benchmark::prepare(uint64_t count) {
+	std::string epname = "null:";
+	if (_tmpdir) {
+		std::string pathname = _tmpdir->pathname() + "/spool";
+		std::filesystem::remove_all(pathname);
+		std::filesystem::create_directory(pathname);
+		epname = "horace+file:" + pathname;
+	}
+
+	_ep = _loader->make(epname);
+	_sb = std::make_unique<session_builder>("bench", "utc");
+	_src = std::make_unique<synthetic_event_reader>(*_sb, _length);
+	if (!_algorithm.empty()) {
+		_hashfn = hash::make(_algorithm);
+	}
+	_nsw = std::make_unique<new_session_writer>(*_ep, *_sb, "bench",
+		_hashfn.get());
+	_srec = _sb->build();
+	_nsw->begin_session(*_srec);
+}
+
+uint64_t capture_benchmark::run(uint64_t count) {
+	for (uint64_t i = 0; i != count; ++i) {
+		_nsw->write_event(_src->read());
+	}
+	_nsw->end_session();
+
+	// Destroying the session writer flushes any buffered records,
+	// so must be included in the measurement.
+	_nsw = 0;
+	return count * _length;
+}
+
+void capture_benchmark::teardown() {
+	_srec = 0;
+	_hashfn = 0;
+	_src = 0;
+	_sb = 0;
+	_ep = 0;
+	_tmpdir = 0;
+}
+
+} /* namespace horace */
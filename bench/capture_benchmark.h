@@ -0,0 +1,91 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_CAPTURE_BENCHMARK
+#define LIBHOLMES_HORACE_CAPTURE_BENCHMARK
+
+#include <memory>
+
+#include "benchmark.h"
+#include "temporary_directory.h"
+
+namespace horace {
+
+class endpoint;
+class endpoint_loader;
+class session_builder;
+class synthetic_event_reader;
+class new_session_writer;
+class record;
+class hash;
+
+/** A benchmark for capturing synthetic packets to an endpoint.
+ * Packets are written by means of a new_session_writer, as they would
+ * be by the horace capture command. Either the null endpoint or a
+ * spool directory can be used as the destination, the latter being
+ * placed in a temporary directory which is emptied before each run.
+ * Records can optionally be hashed, as they would be by the -D option.
+ */
+class capture_benchmark:
+	public benchmark {
+private:
+	/** The endpoint loader. */
+	const endpoint_loader* _loader;
+
+	/** True to capture to a spool directory, false to capture to
+	 * the null endpoint. */
+	bool _spool;
+
+	/** The packet length, in octets. */
+	size_t _length;
+
+	/** The hash algorithm to apply to each record,
+	 * or the empty string if none. */
+	std::string _algorithm;
+
+	/** The hash function for the current run, or null if none. */
+	std::unique_ptr<hash> _hashfn;
+
+	/** A temporary directory for the spool, or null if not
+	 * required. */
+	std::unique_ptr<temporary_directory> _tmpdir;
+
+	/** The destination endpoint. */
+	std::unique_ptr<endpoint> _ep;
+
+	/** A session builder for the current run. */
+	std::unique_ptr<session_builder> _sb;
+
+	/** A source of synthetic packets for the current run. */
+	std::unique_ptr<synthetic_event_reader> _src;
+
+	/** The session writer for the current run. */
+	std::unique_ptr<new_session_writer> _nsw;
+
+	/** The session record for the current run. */
+	std::unique_ptr<record> _srec;
+public:
+	/** Construct capture benchmark.
+	 * @param loader the endpoint loader
+	 * @param spool true to capture to a spool directory, false to
+	 *  capture to the null endpoint
+	 * @param length the packet length, in octets
+	 * @param algorithm the hash algorithm to apply to each record,
+	 *  or the empty string if none
+	 */
+	capture_benchmark(const endpoint_loader& loader, bool spool,
+		size_t length, const std::string& algorithm = std::string());
+
+	virtual ~capture_benchmark();
+
+	virtual void setup();
+	virtual void prepare(uint64_t count);
+	virtual uint64_t run(uint64_t count);
+	virtual void teardown();
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,46 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <dlfcn.h>
+
+#include "horace/endpoint_error.h"
+#include "horace/endpoint.h"
+
+#include "endpoint_loader.h"
+
+namespace horace {
+
+endpoint_loader::endpoint_loader(const std::string& pathname):
+	_pathname(pathname) {}
+
+std::unique_ptr<endpoint> endpoint_loader::make(
+	const std::string& name) const {
+
+	size_t index = name.find(':');
+	if (index == std::string::npos) {
+		throw endpoint_error("missing prefix in endpoint " + name);
+	}
+	std::string prefix = name.substr(0, index);
+
+	std::string pathname = _pathname + "/" + prefix + "/" +
+		prefix + ".so";
+	void* dlh = dlopen(pathname.c_str(), RTLD_NOW);
+	if (!dlh) {
+		throw endpoint_error(
+			std::string("failed to load endpoint driver: ") +
+			dlerror());
+	}
+
+	typedef std::unique_ptr<endpoint> endpoint_maker(std::string name);
+	endpoint_maker* maker = reinterpret_cast<endpoint_maker*>(
+		dlsym(dlh, "make_endpoint"));
+	if (!maker) {
+		throw endpoint_error(
+			"make_endpoint function missing from driver");
+	}
+	return (*maker)(name);
+}
+
+} /* namespace horace */
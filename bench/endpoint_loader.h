@@ -0,0 +1,41 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_ENDPOINT_LOADER
+#define LIBHOLMES_HORACE_ENDPOINT_LOADER
+
+#include <memory>
+#include <string>
+
+namespace horace {
+
+class endpoint;
+
+/** A class for loading endpoint drivers from a build tree.
+ * This differs from endpoint::make in that the drivers are loaded from
+ * the directory in which they were built, as opposed to the directory
+ * in which they would be installed, so that benchmarks can be run
+ * without first installing the software.
+ */
+class endpoint_loader {
+private:
+	/** The pathname of the endpoints directory. */
+	std::string _pathname;
+public:
+	/** Construct endpoint loader.
+	 * @param pathname the pathname of the endpoints directory
+	 */
+	explicit endpoint_loader(const std::string& pathname);
+
+	/** Make endpoint from name.
+	 * @param name the name of the endpoint
+	 * @return the resulting endpoint
+	 */
+	std::unique_ptr<endpoint> make(const std::string& name) const;
+};
+
+} /* namespace horace */
+
+#endif
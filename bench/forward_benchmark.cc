@@ -0,0 +1,166 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <filesystem>
+#include <thread>
+
+#include "horace/horace_error.h"
+#include "horace/record.h"
+#include "horace/endpoint.h"
+#include "horace/session_builder.h"
+#include "horace/session_listener.h"
+#include "horace/session_listener_endpoint.h"
+#include "horace/session_reader.h"
+#include "horace/session_writer.h"
+#include "horace/session_writer_endpoint.h"
+#include "horace/new_session_writer.h"
+
+#include "endpoint_loader.h"
+#include "synthetic_event_reader.h"
+#include "forward_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** Get an endpoint as a session listener endpoint.
+ * @param ep the endpoint
+ * @return the endpoint as a session listener endpoint
+ */
+session_listener_endpoint& as_listener_endpoint(endpoint& ep) {
+	auto* slep = dynamic_cast<session_listener_endpoint*>(&ep);
+	if (!slep) {
+		throw horace_error("endpoint unable to listen for sessions");
+	}
+	return *slep;
+}
+
+/** Get an endpoint as a session writer endpoint.
+ * @param ep the endpoint
+ * @return the endpoint as a session writer endpoint
+ */
+session_writer_endpoint& as_writer_endpoint(endpoint& ep) {
+	auto* swep = dynamic_cast<session_writer_endpoint*>(&ep);
+	if (!swep) {
+		throw horace_error("endpoint unable to receive sessions");
+	}
+	return *swep;
+}
+
+} /* anonymous namespace */
+
+forward_benchmark::forward_benchmark(const endpoint_loader& loader,
+	unsigned int port, size_t length):
+	benchmark("forward.spool.tcp." + std::to_string(length)),
+	_loader(&loader),
+	_port(port),
+	_length(length) {}
+
+forward_benchmark::~forward_benchmark() {}
+
+void forward_benchmark::setup() {
+	_tmpdir = std::make_unique<temporary_directory>();
+	std::string port = std::to_string(_port);
+	_rx_ep = _loader->make("horace+tcp://:" + port);
+	_rx_listener = as_listener_endpoint(*_rx_ep).make_session_listener();
+	_null_ep = _loader->make("null:");
+	_tx_ep = _loader->make("horace+tcp://127.0.0.1:" + port);
+}
+
+void forward_benchmark::prepare(uint64_t count) {
+	std::string pathname = _tmpdir->pathname() + "/spool";
+	std::filesystem::remove_all(pathname);
+	std::filesystem::create_directory(pathname);
+	_spool_ep = _loader->make("horace+file:" + pathname);
+
+	// Capture the required number of packets to the spool directory.
+	{
+		session_builder sb("bench", "utc");
+		synthetic_event_reader src(sb, _length);
+		new_session_writer nsw(*_spool_ep, sb, "bench", nullptr);
+		std::unique_ptr<record> srec = sb.build();
+		nsw.begin_session(*srec);
+		for (uint64_t i = 0; i != count; ++i) {
+			nsw.write_event(src.read());
+		}
+		nsw.end_session();
+	}
+
+	auto spool_listener =
+		as_listener_endpoint(*_spool_ep).make_session_listener();
+	_spool_sr = spool_listener->accept();
+}
+
+void forward_benchmark::_receive() {
+	std::unique_ptr<session_reader> rx_sr = _rx_listener->accept();
+	std::unique_ptr<record> srec = rx_sr->read();
+	std::string srcid = "bench";
+	std::unique_ptr<session_writer> null_sw =
+		as_writer_endpoint(*_null_ep).make_session_writer(srcid);
+	null_sw->write(*srec);
+
+	while (true) {
+		std::unique_ptr<record> rec = rx_sr->read();
+		null_sw->write(*rec);
+		if (rec->channel_id() == channel_sync) {
+			rx_sr->write(*null_sw->read());
+		} else if (rec->channel_id() == channel_end) {
+			break;
+		}
+	}
+}
+
+uint64_t forward_benchmark::run(uint64_t count) {
+	std::exception_ptr rx_ex;
+	std::thread rx_thread([&]() {
+		try {
+			_receive();
+		} catch (...) {
+			rx_ex = std::current_exception();
+		}
+	});
+
+	try {
+		std::unique_ptr<record> srec = _spool_sr->read();
+		std::unique_ptr<session_writer> tx_sw =
+			as_writer_endpoint(*_tx_ep).make_session_writer("bench");
+		tx_sw->write(*srec);
+
+		while (true) {
+			std::unique_ptr<record> rec = _spool_sr->read();
+			tx_sw->write(*rec);
+			if (rec->channel_id() == channel_sync) {
+				_spool_sr->write(*tx_sw->read());
+			} else if (rec->channel_id() == channel_end) {
+				break;
+			}
+		}
+
+		// Destroying the session writer flushes any buffered
+		// records, so must be included in the measurement.
+		tx_sw = 0;
+	} catch (...) {
+		rx_thread.detach();
+		throw;
+	}
+	rx_thread.join();
+	if (rx_ex) {
+		std::rethrow_exception(rx_ex);
+	}
+
+	_spool_sr = 0;
+	_spool_ep = 0;
+	return count * _length;
+}
+
+void forward_benchmark::teardown() {
+	_tx_ep = 0;
+	_null_ep = 0;
+	_rx_listener = 0;
+	_rx_ep = 0;
+	_tmpdir = 0;
+}
+
+} /* namespace horace */
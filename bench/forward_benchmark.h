@@ -0,0 +1,83 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_FORWARD_BENCHMARK
+#define LIBHOLMES_HORACE_FORWARD_BENCHMARK
+
+#include <memory>
+
+#include "benchmark.h"
+#include "temporary_directory.h"
+
+namespace horace {
+
+class endpoint;
+class endpoint_loader;
+class session_listener;
+class session_reader;
+
+/** A benchmark for forwarding from a spool directory over TCP.
+ * Before each run, the required number of synthetic packets are
+ * captured to a spool directory. These are then forwarded to a
+ * horace+tcp endpoint within the same process, as they would be by
+ * the horace forward command, and from there to the null endpoint.
+ * Each run ends when the receiving side has seen the end of the
+ * session.
+ */
+class forward_benchmark:
+	public benchmark {
+private:
+	/** The endpoint loader. */
+	const endpoint_loader* _loader;
+
+	/** The TCP port number. */
+	unsigned int _port;
+
+	/** The packet length, in octets. */
+	size_t _length;
+
+	/** A temporary directory for the spool. */
+	std::unique_ptr<temporary_directory> _tmpdir;
+
+	/** The receiving TCP endpoint. */
+	std::unique_ptr<endpoint> _rx_ep;
+
+	/** The listener for the receiving TCP endpoint. */
+	std::unique_ptr<session_listener> _rx_listener;
+
+	/** The null endpoint. */
+	std::unique_ptr<endpoint> _null_ep;
+
+	/** The sending TCP endpoint. */
+	std::unique_ptr<endpoint> _tx_ep;
+
+	/** The spool endpoint for the current run. */
+	std::unique_ptr<endpoint> _spool_ep;
+
+	/** The session reader for the current run. */
+	std::unique_ptr<session_reader> _spool_sr;
+
+	/** Receive records until the end of the session. */
+	void _receive();
+public:
+	/** Construct forward benchmark.
+	 * @param loader the endpoint loader
+	 * @param port the TCP port number to use
+	 * @param length the packet length, in octets
+	 */
+	forward_benchmark(const endpoint_loader& loader, unsigned int port,
+		size_t length);
+
+	virtual ~forward_benchmark();
+
+	virtual void setup();
+	virtual void prepare(uint64_t count);
+	virtual uint64_t run(uint64_t count);
+	virtual void teardown();
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,50 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/hash.h"
+#include "horace/record.h"
+
+#include "hash_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of distinct records to be hashed. */
+const size_t record_count = 1024;
+
+} /* anonymous namespace */
+
+hash_benchmark::hash_benchmark(const std::string& algorithm,
+	size_t length):
+	benchmark("hash." + algorithm + "." + std::to_string(length)),
+	_algorithm(algorithm),
+	_sb("bench", "utc"),
+	_src(_sb, length) {}
+
+hash_benchmark::~hash_benchmark() {}
+
+void hash_benchmark::setup() {
+	_hashfn = hash::make(_algorithm);
+	_records.reserve(record_count);
+	for (size_t i = 0; i != record_count; ++i) {
+		_records.push_back(_src.read());
+	}
+}
+
+uint64_t hash_benchmark::run(uint64_t count) {
+	size_t hash_len = _hashfn->length();
+	std::basic_string<unsigned char> prev_hash(hash_len, 0);
+	for (uint64_t i = 0; i != count; ++i) {
+		_hashfn->write(prev_hash.data(), hash_len);
+		_records[i % record_count].write(*_hashfn);
+		const void* hash = _hashfn->final();
+		prev_hash.assign(static_cast<const unsigned char*>(hash),
+			hash_len);
+	}
+	return count * _src.length();
+}
+
+} /* namespace horace */
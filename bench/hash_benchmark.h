@@ -0,0 +1,58 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_HASH_BENCHMARK
+#define LIBHOLMES_HORACE_HASH_BENCHMARK
+
+#include <memory>
+#include <vector>
+
+#include "horace/session_builder.h"
+
+#include "benchmark.h"
+#include "synthetic_event_reader.h"
+
+namespace horace {
+
+class hash;
+class record;
+
+/** A benchmark for hashing event records.
+ * Each record is hashed in the same way as by new_session_writer,
+ * with the session hash prepended.
+ */
+class hash_benchmark:
+	public benchmark {
+private:
+	/** The name of the hash function. */
+	std::string _algorithm;
+
+	/** A session builder for the synthetic packets. */
+	session_builder _sb;
+
+	/** A source of synthetic packets. */
+	synthetic_event_reader _src;
+
+	/** The hash function. */
+	std::unique_ptr<hash> _hashfn;
+
+	/** The packet records to be hashed. */
+	std::vector<record> _records;
+public:
+	/** Construct hash benchmark.
+	 * @param algorithm the name of the hash function
+	 * @param length the packet length, in octets
+	 */
+	hash_benchmark(const std::string& algorithm, size_t length);
+
+	virtual ~hash_benchmark();
+
+	virtual void setup();
+	virtual uint64_t run(uint64_t count);
+};
+
+} /* namespace horace */
+
+#endif
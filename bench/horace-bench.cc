@@ -0,0 +1,151 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <getopt.h>
+
+#include "horace/logger.h"
+#include "horace/stderr_logger.h"
+
+#include "endpoint_loader.h"
+#include "benchmark.h"
+#include "varint_benchmark.h"
+#include "attribute_list_benchmark.h"
+#include "record_benchmark.h"
+#include "hash_benchmark.h"
+#include "syslog_benchmark.h"
+#include "capture_benchmark.h"
+#include "forward_benchmark.h"
+
+using namespace horace;
+
+/** Print help text.
+ * @param out the ostream to which the help text should be written
+ */
+void write_help(std::ostream& out) {
+	out << "Usage: horace-bench [<args>] [<filter>]" << std::endl;
+	out << std::endl;
+	out << "Options:" << std::endl;
+	out << std::endl;
+	out << "  -E  directory from which to load endpoints" << std::endl;
+	out << "  -h  display this help text then exit" << std::endl;
+	out << "  -l  list benchmarks then exit" << std::endl;
+	out << "  -p  TCP port number for network benchmarks" << std::endl;
+	out << "  -r  number of runs per benchmark" << std::endl;
+	out << "  -t  minimum time per run, in seconds" << std::endl;
+	out << std::endl;
+	out << "If a filter is given then only benchmarks with names" << std::endl;
+	out << "containing it are run." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	// Initialise default options.
+	std::string epdir = "endpoints";
+	unsigned int port = 40998;
+	unsigned int repeats = 3;
+	double min_time = 1.0;
+	bool list_only = false;
+
+	// Parse command line options.
+	int opt;
+	while ((opt = getopt(argc, argv, "+E:hlp:r:t:")) != -1) {
+		switch (opt) {
+		case 'E':
+			epdir = optarg;
+			break;
+		case 'h':
+			write_help(std::cout);
+			return 0;
+		case 'l':
+			list_only = true;
+			break;
+		case 'p':
+			port = std::stoul(optarg);
+			break;
+		case 'r':
+			repeats = std::stoul(optarg);
+			break;
+		case 't':
+			min_time = std::stod(optarg);
+			break;
+		}
+	}
+	const char* filter = (optind != argc) ? argv[optind++] : "";
+
+	// Initialise logger. Messages are written synchronously, since
+	// the benchmarks should not be competing with a logging thread.
+	log = std::make_unique<stderr_logger>();
+	log->severity(logger::log_warning);
+
+	// Construct benchmarks.
+	endpoint_loader loader(epdir);
+	std::vector<std::unique_ptr<benchmark>> benchmarks;
+	benchmarks.push_back(std::make_unique<varint_benchmark>(false));
+	benchmarks.push_back(std::make_unique<varint_benchmark>(true));
+	benchmarks.push_back(std::make_unique<attribute_list_benchmark>(false));
+	benchmarks.push_back(std::make_unique<attribute_list_benchmark>(true));
+	for (size_t length : {64, 1500}) {
+		for (bool templates : {false, true}) {
+			benchmarks.push_back(std::make_unique<record_benchmark>(
+				false, length, templates));
+			benchmarks.push_back(std::make_unique<record_benchmark>(
+				true, length, templates));
+		}
+	}
+	for (size_t length : {1500, 9000}) {
+		for (const char* algorithm : {"sha256", "sha512", "blake3"}) {
+			benchmarks.push_back(std::make_unique<hash_benchmark>(
+				algorithm, length));
+		}
+	}
+	benchmarks.push_back(std::make_unique<syslog_benchmark>(false));
+	benchmarks.push_back(std::make_unique<syslog_benchmark>(true));
+	for (size_t length : {64, 1500}) {
+		benchmarks.push_back(std::make_unique<capture_benchmark>(
+			loader, false, length));
+		benchmarks.push_back(std::make_unique<capture_benchmark>(
+			loader, true, length));
+		for (const char* algorithm : {"sha256", "blake3"}) {
+			benchmarks.push_back(std::make_unique<capture_benchmark>(
+				loader, true, length, algorithm));
+		}
+		benchmarks.push_back(std::make_unique<forward_benchmark>(
+			loader, port, length));
+	}
+
+	// Run benchmarks, printing the results as a table.
+	if (!list_only) {
+		printf("%-28s %12s %10s %12s\n",
+			"benchmark", "records/s", "MB/s", "allocs/rec");
+	}
+	for (auto& bm : benchmarks) {
+		if (!strstr(bm->name().c_str(), filter)) {
+			continue;
+		}
+		if (list_only) {
+			printf("%s\n", bm->name().c_str());
+			continue;
+		}
+
+		try {
+			benchmark::result res = bm->measure(min_time, repeats);
+			printf("%-28s %12.0f %10.1f %12.2f\n",
+				bm->name().c_str(),
+				res.count / res.elapsed,
+				res.octets / res.elapsed / 1e6,
+				double(res.allocations) / res.count);
+			fflush(stdout);
+		} catch (std::exception& ex) {
+			std::cerr << bm->name() << ": " << ex.what() << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
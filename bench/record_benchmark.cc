@@ -0,0 +1,98 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/octet_reader.h"
+#include "horace/octet_writer.h"
+#include "horace/record.h"
+
+#include "record_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of distinct records to be serialised. */
+const size_t record_count = 1024;
+
+} /* anonymous namespace */
+
+record_benchmark::record_benchmark(bool parse, size_t length,
+	bool templates):
+	benchmark(std::string(parse ? "record.parse" : "record.write") +
+		(templates ? "+templates" : "") + "." + std::to_string(length)),
+	_parse(parse),
+	_templates(templates),
+	_sb("bench", "utc"),
+	_src(_sb, length),
+	_buffer_size(0) {}
+
+void record_benchmark::setup() {
+	_srec = _sb.build();
+	_records.reserve(record_count);
+	for (size_t i = 0; i != record_count; ++i) {
+		_records.push_back(_src.read());
+	}
+
+	// Parse the session record once, so that the session context
+	// contains the necessary attribute and channel definitions.
+	// If templates are in use then the record which declares the
+	// template is parsed too, so that the template is in effect
+	// for all of the records in the buffer.
+	size_t srec_size = _srec->attributes().length() + _src.length() + 256;
+	auto srec_buffer = std::make_unique<char[]>(srec_size);
+	octet_writer srec_out(srec_buffer.get(), srec_size);
+	_srec->write(srec_out);
+	if (_templates) {
+		_encoder.encode(*_srec);
+		_encoder.encode(_records.front()).write(srec_out);
+	}
+	octet_reader srec_in(srec_buffer.get(), srec_size, srec_size);
+	record srec(_session, srec_in);
+	if (_templates) {
+		record rec(_session, srec_in);
+	}
+
+	// Allow ample space for record headers.
+	size_t buffer_size = record_count * (_src.length() + 256);
+	_buffer = std::make_unique<char[]>(buffer_size);
+	_buffer_size = buffer_size;
+	octet_writer out(_buffer.get(), _buffer_size);
+	for (const record& rec : _records) {
+		if (_templates) {
+			_encoder.encode(rec).write(out);
+		} else {
+			rec.write(out);
+		}
+	}
+}
+
+uint64_t record_benchmark::run(uint64_t count) {
+	uint64_t octets = 0;
+	while (count) {
+		size_t batch = std::min<uint64_t>(count, record_count);
+		if (_parse) {
+			octet_reader in(_buffer.get(), _buffer_size,
+				_buffer_size);
+			for (size_t i = 0; i != batch; ++i) {
+				record rec(_session, in);
+				octets += _src.length();
+			}
+		} else {
+			octet_writer out(_buffer.get(), _buffer_size);
+			for (size_t i = 0; i != batch; ++i) {
+				if (_templates) {
+					_encoder.encode(_records[i]).write(out);
+				} else {
+					_records[i].write(out);
+				}
+				octets += _src.length();
+			}
+		}
+		count -= batch;
+	}
+	return octets;
+}
+
+} /* namespace horace */
@@ -0,0 +1,71 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_RECORD_BENCHMARK
+#define LIBHOLMES_HORACE_RECORD_BENCHMARK
+
+#include <memory>
+#include <vector>
+
+#include "horace/session_builder.h"
+#include "horace/session_context.h"
+#include "horace/template_encoder.h"
+
+#include "benchmark.h"
+#include "synthetic_event_reader.h"
+
+namespace horace {
+
+class record;
+
+/** A benchmark for serialising or parsing packet records. */
+class record_benchmark:
+	public benchmark {
+private:
+	/** True to measure parsing, false to measure serialisation. */
+	bool _parse;
+
+	/** True to use record templates, otherwise false. */
+	bool _templates;
+
+	/** A session builder for the synthetic packets. */
+	session_builder _sb;
+
+	/** A source of synthetic packets. */
+	synthetic_event_reader _src;
+
+	/** The session record. */
+	std::unique_ptr<record> _srec;
+
+	/** The packet records to be serialised. */
+	std::vector<record> _records;
+
+	/** A session context for parsing. */
+	session_context _session;
+
+	/** An encoder for applying record templates. */
+	template_encoder _encoder;
+
+	/** A buffer to hold the serialised records. */
+	std::unique_ptr<char[]> _buffer;
+
+	/** The size of the buffer, in octets. */
+	size_t _buffer_size;
+public:
+	/** Construct record benchmark.
+	 * @param parse true to measure parsing, false to measure
+	 *  serialisation
+	 * @param length the packet length, in octets
+	 * @param templates true to use record templates, otherwise false
+	 */
+	record_benchmark(bool parse, size_t length, bool templates = false);
+
+	virtual void setup();
+	virtual uint64_t run(uint64_t count);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,62 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstring>
+
+#include "horace/attribute_list.h"
+#include "horace/session_builder.h"
+
+#include "synthetic_event_reader.h"
+
+namespace horace {
+
+namespace {
+
+/** Define a channel for synthetic packets.
+ * @param session the applicable session builder
+ * @return the channel number
+ */
+int define_synthetic_channel(session_builder& session) {
+	attribute_list attrs;
+	return session.define_channel("packets", std::move(attrs));
+}
+
+} /* anonymous namespace */
+
+synthetic_event_reader::synthetic_event_reader(session_builder& session,
+	size_t length):
+	_builder(session, define_synthetic_channel(session)),
+	_content(std::make_unique<unsigned char[]>(length)),
+	_length(length),
+	_ts{1577836800, 0},
+	_count(0) {
+
+	// Fill the content with a fixed pseudo-random sequence.
+	uint32_t state = 0x12345678;
+	for (size_t i = 0; i != length; ++i) {
+		state = state * 1103515245 + 12345;
+		_content[i] = state >> 24;
+	}
+}
+
+const record& synthetic_event_reader::read() {
+	// Vary the start of the content so that no two packets are
+	// identical (which matters when hashing).
+	memcpy(_content.get(), &_count,
+		std::min(sizeof(_count), _length));
+	_count += 1;
+
+	// Advance the timestamp by one microsecond per packet.
+	_ts.tv_nsec += 1000;
+	if (_ts.tv_nsec >= 1000000000) {
+		_ts.tv_nsec -= 1000000000;
+		_ts.tv_sec += 1;
+	}
+
+	_builder.build_packet(&_ts, _content.get(), _length, _length, 0);
+	return *_builder.next();
+}
+
+} /* namespace horace */
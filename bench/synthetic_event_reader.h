@@ -0,0 +1,62 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYNTHETIC_EVENT_READER
+#define LIBHOLMES_HORACE_SYNTHETIC_EVENT_READER
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+
+#include "horace/event_reader.h"
+#include "horace/packet_record_builder.h"
+
+namespace horace {
+
+class session_builder;
+
+/** A class for generating synthetic packet records.
+ * Packets are of a fixed length, with content and timestamps which are
+ * deterministic but which differ from one packet to the next. Records
+ * are built in the same way as for a packet capture endpoint, so that
+ * benchmarks which use them are representative of real capture.
+ */
+class synthetic_event_reader:
+	public event_reader {
+private:
+	/** A builder for making packet records. */
+	packet_record_builder _builder;
+
+	/** The packet content. */
+	std::unique_ptr<unsigned char[]> _content;
+
+	/** The packet length, in octets. */
+	size_t _length;
+
+	/** The timestamp for the next packet. */
+	struct timespec _ts;
+
+	/** The number of packets generated. */
+	uint64_t _count;
+public:
+	/** Construct synthetic event reader.
+	 * @param session the applicable session builder
+	 * @param length the required packet length, in octets
+	 */
+	synthetic_event_reader(session_builder& session, size_t length);
+
+	virtual const record& read();
+
+	/** Get the packet length.
+	 * @return the packet length, in octets
+	 */
+	size_t length() const {
+		return _length;
+	}
+};
+
+} /* namespace horace */
+
+#endif
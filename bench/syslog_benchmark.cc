@@ -0,0 +1,98 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/attribute_list.h"
+#include "horace/syslog_parser.h"
+
+#include "syslog_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of distinct messages to be parsed. */
+const size_t message_count = 1024;
+
+/** Hostnames for use in synthetic messages. */
+const char* hostnames[] = {
+	"www", "mail.example.com", "fw-03", "db2.internal.example.org" };
+
+/** Application names for use in synthetic messages. */
+const char* appnames[] = {
+	"sshd", "postfix/smtpd", "kernel", "CRON", "nginx" };
+
+/** Message texts for use in synthetic messages. */
+const char* texts[] = {
+	"session opened for user root by (uid=0)",
+	"connect from unknown[192.0.2.17]",
+	"[UFW BLOCK] IN=eth0 OUT= MAC=52:54:00:12:34:56:52:54:00:65:43:21:"
+		"08:00 SRC=198.51.100.4 DST=203.0.113.9 LEN=60 TOS=0x00 "
+		"PREC=0x00 TTL=52 ID=4711 DF PROTO=TCP SPT=51234 DPT=22 "
+		"WINDOW=29200 RES=0x00 SYN URGP=0",
+	"(root) CMD (run-parts /etc/cron.hourly)",
+	"GET /index.html HTTP/1.1 200" };
+
+/** Month names for RFC 3164 timestamps. */
+const char* months[] = {
+	"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+	"Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+} /* anonymous namespace */
+
+syslog_benchmark::syslog_benchmark(bool rfc5424):
+	benchmark(rfc5424 ? "syslog.parse.rfc5424" : "syslog.parse.rfc3164"),
+	_rfc5424(rfc5424),
+	_sb("bench", "utc") {
+
+	attribute_list attrs;
+	int channel = _sb.define_channel("log", std::move(attrs));
+	_builder = std::make_unique<log_record_builder>(_sb, channel);
+}
+
+void syslog_benchmark::setup() {
+	char buffer[1024];
+	_messages.reserve(message_count);
+	for (size_t i = 0; i != message_count; ++i) {
+		unsigned int priority = (i * 7) % 192;
+		const char* hostname = hostnames[i % 4];
+		const char* appname = appnames[i % 5];
+		const char* text = texts[(i / 5) % 5];
+		unsigned int second = i % 60;
+		int length = 0;
+		if (_rfc5424) {
+			const char* sd = (i % 3) ? "-" :
+				"[origin ip=\"192.0.2.1\"][meta sequenceId=\"1\"]";
+			length = snprintf(buffer, sizeof(buffer),
+				"<%u>1 2020-03-14T15:09:%02u.%06uZ %s %s %u - %s %s",
+				priority, second, unsigned(i * 997 % 1000000),
+				hostname, appname, unsigned(1000 + i), sd, text);
+		} else {
+			length = snprintf(buffer, sizeof(buffer),
+				"<%u>%s %2u 15:09:%02u %s %s[%u]: %s",
+				priority, months[i % 12], unsigned(1 + i % 28),
+				second, hostname, appname, unsigned(1000 + i),
+				text);
+		}
+		_messages.emplace_back(buffer, length);
+	}
+}
+
+uint64_t syslog_benchmark::run(uint64_t count) {
+	uint64_t octets = 0;
+	while (count) {
+		size_t batch = std::min<uint64_t>(count, message_count);
+		for (size_t i = 0; i != batch; ++i) {
+			const std::string& message = _messages[i];
+			syslog_parser parser(message.data(), message.length());
+			parser.read_message(*_builder);
+			_builder->build();
+			octets += message.length();
+		}
+		count -= batch;
+	}
+	return octets;
+}
+
+} /* namespace horace */
@@ -0,0 +1,51 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYSLOG_BENCHMARK
+#define LIBHOLMES_HORACE_SYSLOG_BENCHMARK
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "horace/session_builder.h"
+#include "horace/log_record_builder.h"
+
+#include "benchmark.h"
+
+namespace horace {
+
+/** A benchmark for parsing syslog messages into log records.
+ * The corpus consists of synthetic messages in either RFC 3164 or
+ * RFC 5424 format, with varying field lengths. Each iteration parses
+ * one message and builds the corresponding record.
+ */
+class syslog_benchmark:
+	public benchmark {
+private:
+	/** True for RFC 5424 messages, false for RFC 3164. */
+	bool _rfc5424;
+
+	/** A session builder for the log records. */
+	session_builder _sb;
+
+	/** A builder for log records. */
+	std::unique_ptr<log_record_builder> _builder;
+
+	/** The messages to be parsed. */
+	std::vector<std::string> _messages;
+public:
+	/** Construct syslog benchmark.
+	 * @param rfc5424 true for RFC 5424 messages, false for RFC 3164
+	 */
+	explicit syslog_benchmark(bool rfc5424);
+
+	virtual void setup();
+	virtual uint64_t run(uint64_t count);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,30 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdlib>
+#include <filesystem>
+
+#include "horace/libc_error.h"
+
+#include "temporary_directory.h"
+
+namespace horace {
+
+temporary_directory::temporary_directory() {
+	const char* tmpdir = getenv("TMPDIR");
+	std::string templ = std::string(tmpdir ? tmpdir : "/tmp") +
+		"/horace-bench.XXXXXX";
+	if (!mkdtemp(templ.data())) {
+		throw libc_error();
+	}
+	_pathname = templ;
+}
+
+temporary_directory::~temporary_directory() {
+	std::error_code ec;
+	std::filesystem::remove_all(_pathname, ec);
+}
+
+} /* namespace horace */
@@ -0,0 +1,41 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_TEMPORARY_DIRECTORY
+#define LIBHOLMES_HORACE_TEMPORARY_DIRECTORY
+
+#include <string>
+
+namespace horace {
+
+/** A class to represent a temporary directory.
+ * The directory is created with a unique name, and is removed along
+ * with its content when the object is destroyed.
+ */
+class temporary_directory {
+private:
+	/** The pathname of the directory. */
+	std::string _pathname;
+public:
+	/** Create temporary directory. */
+	temporary_directory();
+
+	/** Remove temporary directory. */
+	~temporary_directory();
+
+	temporary_directory(const temporary_directory&) = delete;
+	temporary_directory& operator=(const temporary_directory&) = delete;
+
+	/** Get the pathname of this directory.
+	 * @return the pathname
+	 */
+	const std::string& pathname() const {
+		return _pathname;
+	}
+};
+
+} /* namespace horace */
+
+#endif
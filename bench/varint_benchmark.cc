@@ -0,0 +1,78 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/octet_reader.h"
+#include "horace/octet_writer.h"
+#include "horace/unsigned_base128_integer.h"
+
+#include "varint_benchmark.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of distinct values to be encoded. */
+const size_t value_count = 1024;
+
+/** The size of the buffer, which must be large enough to hold all of
+ * the encoded values. */
+const size_t buffer_size = value_count * 10;
+
+/** A sink for decoded values, to prevent them from being optimised
+ * away. */
+volatile uint64_t sink;
+
+} /* anonymous namespace */
+
+varint_benchmark::varint_benchmark(bool decode):
+	benchmark(decode ? "varint.decode" : "varint.encode"),
+	_decode(decode),
+	_values(std::make_unique<uint64_t[]>(value_count)),
+	_buffer(std::make_unique<char[]>(buffer_size)),
+	_encoded_length(0) {}
+
+void varint_benchmark::setup() {
+	uint64_t state = 0x0123456789abcdef;
+	for (size_t i = 0; i != value_count; ++i) {
+		state = state * 6364136223846793005 + 1442695040888963407;
+		_values[i] = state >> (i % 64);
+	}
+
+	octet_writer out(_buffer.get(), buffer_size);
+	for (size_t i = 0; i != value_count; ++i) {
+		unsigned_base128_integer value(_values[i]);
+		value.write(out);
+		_encoded_length += value.length();
+	}
+}
+
+uint64_t varint_benchmark::run(uint64_t count) {
+	uint64_t octets = 0;
+	while (count) {
+		size_t batch = std::min<uint64_t>(count, value_count);
+		if (_decode) {
+			octet_reader in(_buffer.get(), buffer_size,
+				_encoded_length);
+			uint64_t total = 0;
+			for (size_t i = 0; i != batch; ++i) {
+				unsigned_base128_integer value(in);
+				total += value;
+				octets += value.length();
+			}
+			sink = total;
+		} else {
+			octet_writer out(_buffer.get(), buffer_size);
+			for (size_t i = 0; i != batch; ++i) {
+				unsigned_base128_integer value(_values[i]);
+				value.write(out);
+				octets += value.length();
+			}
+		}
+		count -= batch;
+	}
+	return octets;
+}
+
+} /* namespace horace */
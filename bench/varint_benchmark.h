@@ -0,0 +1,46 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_VARINT_BENCHMARK
+#define LIBHOLMES_HORACE_VARINT_BENCHMARK
+
+#include <memory>
+
+#include "benchmark.h"
+
+namespace horace {
+
+/** A benchmark for encoding or decoding unsigned base-128 integers.
+ * The values used vary in magnitude so that all encoded lengths from
+ * one to ten octets are exercised.
+ */
+class varint_benchmark:
+	public benchmark {
+private:
+	/** True to measure decoding, false to measure encoding. */
+	bool _decode;
+
+	/** The values to be encoded. */
+	std::unique_ptr<uint64_t[]> _values;
+
+	/** A buffer to hold the encoded values. */
+	std::unique_ptr<char[]> _buffer;
+
+	/** The number of octets in the buffer when all values have been
+	 * encoded. */
+	size_t _encoded_length;
+public:
+	/** Construct varint benchmark.
+	 * @param decode true to measure decoding, false to measure encoding
+	 */
+	explicit varint_benchmark(bool decode);
+
+	virtual void setup();
+	virtual uint64_t run(uint64_t count);
+};
+
+} /* namespace horace */
+
+#endif
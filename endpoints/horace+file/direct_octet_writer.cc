@@ -0,0 +1,136 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+
+#include "horace/libc_error.h"
+
+#include "direct_octet_writer.h"
+
+namespace horace {
+
+namespace {
+
+/** Choose the capacity of the buffer.
+ * This must be a whole number of blocks, and large enough to hold a
+ * retained partial block while still having room for more.
+ * @param bufsize the requested buffer size, in octets
+ * @return the capacity, in octets
+ */
+size_t buffer_capacity(size_t bufsize) {
+	const size_t alignment = direct_octet_writer::alignment;
+	size_t capacity = (bufsize + alignment - 1) & ~(alignment - 1);
+	return std::max(capacity, alignment * 2);
+}
+
+/** Allocate an aligned buffer.
+ * @param size the required size, in octets
+ * @return the buffer
+ */
+char* aligned_buffer(size_t size) {
+	void* ptr = 0;
+	if (int err = posix_memalign(&ptr, direct_octet_writer::alignment,
+		size)) {
+
+		throw libc_error(err);
+	}
+	return static_cast<char*>(ptr);
+}
+
+} /* anonymous namespace */
+
+void direct_octet_writer::_append(const void* buf, size_t nbyte) {
+	const char* ptr = static_cast<const char*>(buf);
+
+	// Octets which were written into the buffer by the base class
+	// are already in the right place, so need only be counted.
+	if (ptr == _buffer.get() + _used) {
+		_used += nbyte;
+		return;
+	}
+
+	while (nbyte) {
+		size_t count = std::min(nbyte, _capacity - _used);
+		memcpy(_buffer.get() + _used, ptr, count);
+		_used += count;
+		ptr += count;
+		nbyte -= count;
+		if (_used == _capacity) {
+			_write_blocks();
+		}
+	}
+}
+
+void direct_octet_writer::_write_blocks() {
+	size_t whole = _used & ~(alignment - 1);
+	if (whole) {
+		_dfd.write(_buffer.get(), whole);
+		_offset += whole;
+		_used -= whole;
+		memmove(_buffer.get(), _buffer.get() + whole, _used);
+	}
+}
+
+void direct_octet_writer::_rebuffer() {
+	_set_buffer(_buffer.get() + _used, _capacity - _used);
+}
+
+void direct_octet_writer::_write_direct(const void* buf, size_t nbyte) {
+	_append(buf, nbyte);
+	_write_blocks();
+	_rebuffer();
+}
+
+void direct_octet_writer::_writev_direct(struct iovec* iov, int iovcnt) {
+	for (int i = 0; i != iovcnt; ++i) {
+		_append(iov[i].iov_base, iov[i].iov_len);
+	}
+	_write_blocks();
+	_rebuffer();
+}
+
+direct_octet_writer::direct_octet_writer(const std::string& pathname,
+	file_descriptor& fd, size_t bufsize):
+	_dfd(pathname, O_WRONLY|O_DIRECT),
+	_fd(&fd),
+	_capacity(buffer_capacity(bufsize)),
+	_buffer(aligned_buffer(_capacity), free),
+	_used(0),
+	_offset(0) {
+
+	_rebuffer();
+}
+
+direct_octet_writer::~direct_octet_writer() {
+	try {
+		flush();
+		publish();
+	} catch (std::exception& ex) {
+		std::cerr << ex.what() << std::endl;
+	}
+}
+
+void direct_octet_writer::publish() {
+	const char* ptr = _buffer.get();
+	size_t nbyte = _used;
+	off_t offset = _offset;
+	while (nbyte) {
+		ssize_t count = pwrite(*_fd, ptr, nbyte, offset);
+		if (count == -1) {
+			throw libc_error();
+		}
+		ptr += count;
+		nbyte -= count;
+		offset += count;
+	}
+}
+
+} /* namespace horace */
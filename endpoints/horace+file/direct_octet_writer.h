@@ -0,0 +1,105 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_DIRECT_OCTET_WRITER
+#define LIBHOLMES_HORACE_DIRECT_OCTET_WRITER
+
+#include <cstdlib>
+#include <memory>
+
+#include "horace/file_descriptor.h"
+#include "horace/octet_writer.h"
+
+namespace horace {
+
+/** An octet writer class for writing to a file using O_DIRECT.
+ * Direct I/O bypasses the page cache, but requires that the buffer
+ * address, file offset and length of each write be aligned to the
+ * logical block size of the filesystem. This class therefore writes
+ * only whole blocks using direct I/O, and retains any partial block at
+ * the end of the buffer until it can be completed.
+ *
+ * So that readers are not kept waiting for the retained octets, they
+ * can be made visible by calling publish, which writes them using a
+ * second file descriptor without O_DIRECT. This touches at most one
+ * block of the page cache, which is superseded when the block is later
+ * completed and rewritten directly.
+ */
+class direct_octet_writer:
+	public octet_writer {
+public:
+	/** The alignment required for direct I/O, in octets. */
+	static const size_t alignment = 0x1000;
+private:
+	/** The file descriptor for direct writes. */
+	file_descriptor _dfd;
+
+	/** The file descriptor for publishing partial blocks. */
+	file_descriptor* _fd;
+
+	/** The size of the buffer, in octets. */
+	size_t _capacity;
+
+	/** The aligned buffer. */
+	std::unique_ptr<char[], void(*)(void*)> _buffer;
+
+	/** The number of octets at the start of the buffer which have
+	 * been consumed but not yet written directly. */
+	size_t _used;
+
+	/** The file offset corresponding to the start of the buffer. */
+	off_t _offset;
+
+	/** Append octets to the buffer, writing whole blocks directly
+	 * whenever it becomes full.
+	 * @param buf the octets to be appended
+	 * @param nbyte the number of octets to append
+	 */
+	void _append(const void* buf, size_t nbyte);
+
+	/** Write any whole blocks in the buffer directly, then move the
+	 * remaining partial block to the start of the buffer. */
+	void _write_blocks();
+
+	/** Make the remainder of the buffer available to the base class. */
+	void _rebuffer();
+protected:
+	virtual void _write_direct(const void* buf, size_t nbyte);
+	virtual void _writev_direct(struct iovec* iov, int iovcnt);
+public:
+	/** Construct direct octet writer.
+	 * The file is reopened with O_DIRECT, and the existing file
+	 * descriptor is used only for publishing partial blocks.
+	 * @param pathname the pathname of the file, which must be empty
+	 * @param fd a file descriptor for the file, without O_DIRECT
+	 * @param bufsize the required buffer size, in octets, which is
+	 *  rounded up to a whole number of blocks
+	 */
+	direct_octet_writer(const std::string& pathname, file_descriptor& fd,
+		size_t bufsize);
+
+	direct_octet_writer(const direct_octet_writer&) = delete;
+	direct_octet_writer& operator=(const direct_octet_writer&) = delete;
+
+	virtual ~direct_octet_writer();
+
+	/** Get the number of octets consumed by this writer.
+	 * This excludes any octets in the buffer of the base class which
+	 * have not yet been flushed.
+	 * @return the number of octets
+	 */
+	off_t position() const {
+		return _offset + _used;
+	}
+
+	/** Write any retained partial block without O_DIRECT.
+	 * The octet writer buffer should be flushed first.
+	 */
+	void publish();
+};
+
+} /* namespace horace */
+
+#endif
@@ -14,10 +14,22 @@
 
 namespace horace {
 
-static const size_t buffer_size =
-	sizeof(struct inotify_event) + NAME_MAX + 1;
+namespace {
 
-directory_watcher::directory_watcher(const std::string& pathname):
+/** The size of the event buffer, in octets.
+ * This must be large enough to hold at least one event with a name of
+ * maximum length, but is made much larger than that so that a burst of
+ * events can be collected using a single call to read.
+ */
+const size_t buffer_size = 0x10000;
+
+static_assert(buffer_size >= sizeof(struct inotify_event) + NAME_MAX + 1,
+	"inotify buffer too small");
+
+} /* anonymous namespace */
+
+directory_watcher::directory_watcher(const std::string& pathname,
+	uint32_t mask):
 	_fd(inotify_init()),
 	_buffer(std::make_unique<char[]>(buffer_size)),
 	_count(0),
@@ -27,26 +39,31 @@ directory_watcher::directory_watcher(const std::string& pathname):
 		throw libc_error();
 	}
 	_fd.interruptible(true);
-	inotify_add_watch(_fd, pathname.c_str(), IN_CREATE|IN_MODIFY);
+	watch(pathname, mask);
+}
+
+void directory_watcher::watch(const std::string& pathname, uint32_t mask) {
+	if (inotify_add_watch(_fd, pathname.c_str(), mask) == -1) {
+		throw libc_error();
+	}
 }
 
-std::string directory_watcher::read() {
+directory_watcher::event directory_watcher::read() {
 	while (true) {
 		// If the buffer is non-empty then return the next
-		// buffered filename.
+		// buffered event. Note that the name is absent (and the
+		// length zero) for events such as IN_Q_OVERFLOW which do
+		// not refer to a particular entry.
 		if (_index < _count) {
 			char* ptr = _buffer.get() + _index;
-			struct inotify_event* event =
+			struct inotify_event* ev =
 				reinterpret_cast<struct inotify_event*>(ptr);
-			std::string filename(event->name);
-			size_t size = sizeof(struct inotify_event) +
-				event->len;
-			_index += size;
-			return filename;
+			_index += sizeof(struct inotify_event) + ev->len;
+			return event((ev->len) ? ev->name : "", ev->mask);
 		}
 
-		// If the buffer is empty then fill it (blocking if
-		// necessary).
+		// If the buffer is empty then fill it with as many events
+		// as are available (blocking if there are none).
 		_count = _fd.read(_buffer.get(), buffer_size);
 		_index = 0;
 	}
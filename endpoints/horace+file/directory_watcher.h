@@ -6,15 +6,69 @@
 #ifndef LIBHOLMES_HORACE_DIRECTORY_WATCHER
 #define LIBHOLMES_HORACE_DIRECTORY_WATCHER
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include <sys/inotify.h>
+
 #include "horace/file_descriptor.h"
 
 namespace horace {
 
-/** A class for monitoring a directory for newly-created entries. */
+/** A class for monitoring a directory for changes to its entries.
+ * Events are read from inotify in batches, so that a burst of activity
+ * can be processed without making one system call per event.
+ */
 class directory_watcher {
+public:
+	/** The default set of events to be monitored. */
+	static const uint32_t default_mask =
+		IN_CREATE|IN_MODIFY|IN_MOVED_TO;
+
+	/** A class to represent a single directory event. */
+	class event {
+	private:
+		/** The name of the entry to which the event refers,
+		 * or the empty string if none. */
+		std::string _name;
+
+		/** The inotify event mask. */
+		uint32_t _mask;
+	public:
+		/** Construct directory event.
+		 * @param name the name of the entry
+		 * @param mask the inotify event mask
+		 */
+		event(const std::string& name, uint32_t mask):
+			_name(name),
+			_mask(mask) {}
+
+		/** Get the name of the entry to which the event refers.
+		 * @return the name, or the empty string if none
+		 */
+		const std::string& name() const {
+			return _name;
+		}
+
+		/** Determine whether events have been lost.
+		 * If this is the case then the state of the directory must
+		 * be re-established by some other means, such as a scan.
+		 * @return true if the inotify queue overflowed, otherwise false
+		 */
+		bool overflow() const {
+			return _mask & IN_Q_OVERFLOW;
+		}
+
+		/** Determine whether an entry has been added.
+		 * This includes entries which have been moved into the
+		 * directory, as well as those which have been created.
+		 * @return true if an entry was added, otherwise false
+		 */
+		bool added() const {
+			return _mask & (IN_CREATE|IN_MOVED_TO);
+		}
+	};
 private:
 	/** The file descriptor used to watch the directory. */
 	file_descriptor _fd;
@@ -31,15 +85,25 @@ private:
 public:
 	/** Watch directory.
 	 * @param pathname the directory pathname
+	 * @param mask the set of inotify events to be monitored
+	 */
+	explicit directory_watcher(const std::string& pathname,
+		uint32_t mask = default_mask);
+
+	/** Watch an additional directory.
+	 * Events for all watched directories are returned by the same
+	 * read function, and are not distinguished from each other.
+	 * @param pathname the directory pathname
+	 * @param mask the set of inotify events to be monitored
 	 */
-	directory_watcher(const std::string& pathname);
+	void watch(const std::string& pathname, uint32_t mask = default_mask);
 
-	/** Read the next file/directory name.
-	 * If there are no names waiting to be read then this function
+	/** Read the next event.
+	 * If there are no events waiting to be read then this function
 	 * will block until one is available.
-	 * @return the name of a newly-created file or directory
+	 * @return the event
 	 */
-	std::string read();
+	event read();
 };
 
 } /* namespace horace */
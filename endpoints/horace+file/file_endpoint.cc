@@ -13,6 +13,7 @@
 
 #include "free_space_checker.h"
 #include "spoolfile_writer.h"
+#include "spoolfile_pruner.h"
 #include "file_session_listener.h"
 #include "file_session_writer.h"
 #include "file_endpoint.h"
@@ -22,38 +23,98 @@ namespace horace {
 /** The default size to which spoolfiles are permitted to grow, in octets. */
 static size_t default_filesize = 0x1000000;
 
+/** The default size of the buffers used for reading and writing
+ * spoolfiles, in octets. */
+static size_t default_bufsize = 0x10000;
+
 file_endpoint::file_endpoint(const std::string& name):
 	endpoint(name),
 	_pathname(this->name().path()),
-	_fd(_pathname, O_RDONLY),
 	_filesize(default_filesize),
-	_nodelete(false) {
+	_nodelete(false),
+	_retain_size(0),
+	_retain_age(0),
+	_odirect(false),
+	_delta(false),
+	_templates(false),
+	_stripes{_pathname} {
 
+	long long bufsize = default_bufsize;
 	if (std::optional<std::string> query = this->name().query()) {
 		query_string params(*query);
 		_filesize = params.find<long>("filesize").value_or(_filesize);
 		_nodelete = params.find<bool>("nodelete").value_or(_nodelete);
+		_odirect = params.find<bool>("odirect").value_or(_odirect);
+		_delta = params.find<bool>("delta").value_or(_delta);
+		_templates = params.find<bool>("templates").value_or(_templates);
+		_dictionary = params.find<std::vector<std::string>>("dictionary")
+			.value_or(_dictionary);
+		long long retain_size = params.find<long long>("retain")
+			.value_or(_retain_size);
+		_retain_age = params.find<long>("retain_age").value_or(_retain_age);
+		if (retain_size < 0) {
+			throw endpoint_error("retain must not be negative");
+		}
+		if (_retain_age < 0) {
+			throw endpoint_error("retain_age must not be negative");
+		}
+		_retain_size = retain_size;
+		bufsize = params.find<long long>("bufsize").value_or(bufsize);
+		if (std::optional<std::string> stripe =
+			params.find<std::string>("stripe")) {
+
+			// Additional stripes are separated by colons.
+			size_t start = 0;
+			while (start <= stripe->length()) {
+				size_t end = stripe->find(':', start);
+				if (end == std::string::npos) {
+					end = stripe->length();
+				}
+				if (end == start) {
+					throw endpoint_error("empty pathname in stripe");
+				}
+				_stripes.push_back(stripe->substr(start, end - start));
+				start = end + 1;
+			}
+		}
 		std::optional<std::string> hwm = params.find<std::string>("hwm");
 		std::optional<std::string> lwm = params.find<std::string>("lwm");
 		if (hwm && lwm) {
-			_fschecker = std::make_unique<free_space_checker>(
-				_pathname, *hwm, *lwm);
+			for (const auto& pathname : _stripes) {
+				_fscheckers.push_back(
+					std::make_unique<free_space_checker>(
+					pathname, *hwm, *lwm));
+			}
 		} else if (hwm) {
 			throw endpoint_error("horace+file endpoint with hwm but not lwm");
 		} else if (lwm) {
 			throw endpoint_error("horace+file endpoint with lwm but not hwm");
 		}
 	}
+	for (const auto& pathname : _stripes) {
+		_fds.emplace_back(pathname, O_RDONLY);
+	}
+	if (bufsize <= 0) {
+		throw endpoint_error("bufsize must be greater than zero");
+	}
+	_pool = std::make_unique<buffer_pool>(bufsize);
 }
 
 bool file_endpoint::writable() {
-	return _fschecker ? *_fschecker : true;
+	// Every checker is evaluated, rather than stopping at the first
+	// which fails, so that the hysteresis state of each is kept up
+	// to date.
+	bool result = true;
+	for (auto& fschecker : _fscheckers) {
+		result &= bool(*fschecker);
+	}
+	return result;
 }
 
 std::unique_ptr<session_listener> file_endpoint::make_session_listener() {
 	std::unique_ptr<session_listener> listener =
 		std::make_unique<file_session_listener>(*this);
-	_fd.fsync();
+	_fds[0].fsync();
 	return listener;
 }
 
@@ -62,7 +123,9 @@ std::unique_ptr<session_writer> file_endpoint::make_session_writer(
 
 	std::unique_ptr<session_writer> writer =
 		std::make_unique<file_session_writer>(*this, srcid);
-	_fd.fsync();
+	for (auto& fd : _fds) {
+		fd.fsync();
+	}
 	return writer;
 }
 
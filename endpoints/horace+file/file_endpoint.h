@@ -7,8 +7,10 @@
 #define LIBHOLMES_HORACE_FILE_ENDPOINT
 
 #include <string>
+#include <vector>
 
 #include "horace/file_descriptor.h"
+#include "horace/buffer_pool.h"
 #include "horace/endpoint.h"
 #include "horace/session_listener_endpoint.h"
 #include "horace/session_writer_endpoint.h"
@@ -26,8 +28,9 @@ private:
 	/** The pathname for this endpoint. */
 	std::string _pathname;
 
-	/** A file descriptor for synchronising the directory. */
-	file_descriptor _fd;
+	/** File descriptors for synchronising the base directory of
+	 * each stripe. */
+	std::vector<file_descriptor> _fds;
 
 	/** The size to which spoolfiles are permitted to grow, in octets. */
 	size_t _filesize;
@@ -35,8 +38,39 @@ private:
 	/** True if deletion of spoolfiles should be suppressed, otherwise false. */
 	bool _nodelete;
 
-	/** An optional object for checking free space thresholds. */
-	std::unique_ptr<free_space_checker> _fschecker;
+	/** The maximum combined size of the spoolfiles for each source,
+	 * in octets, or 0 if unlimited. */
+	unsigned long long _retain_size;
+
+	/** The maximum age of a spoolfile, in seconds, or 0 if
+	 * unlimited. */
+	long _retain_age;
+
+	/** True if spoolfiles should be written using O_DIRECT,
+	 * otherwise false. */
+	bool _odirect;
+
+	/** True if records should be delta encoded, otherwise false. */
+	bool _delta;
+
+	/** True if record templates should be used, otherwise false. */
+	bool _templates;
+
+	/** The labels of the attributes to which a string dictionary
+	 * should be applied. */
+	std::vector<std::string> _dictionary;
+
+	/** The base directory pathnames for each stripe.
+	 * The first stripe is always the pathname for this endpoint.
+	 */
+	std::vector<std::string> _stripes;
+
+	/** Optional objects for checking free space thresholds,
+	 * one for each stripe. */
+	std::vector<std::unique_ptr<free_space_checker>> _fscheckers;
+
+	/** A pool of buffers for reading and writing spoolfiles. */
+	std::unique_ptr<buffer_pool> _pool;
 public:
 	/** Construct file endpoint.
 	 * @param name the name of this endpoint
@@ -50,6 +84,31 @@ public:
 		return _pathname;
 	}
 
+	/** Get the number of stripes.
+	 * @return the number of stripes
+	 */
+	size_t stripe_count() const {
+		return _stripes.size();
+	}
+
+	/** Get the stripe to which a given spoolfile belongs.
+	 * Spoolfiles are allocated to stripes in round-robin order.
+	 * @param filenum the filenum of the spoolfile
+	 * @return the stripe index
+	 */
+	size_t stripe(unsigned long filenum) const {
+		return filenum % _stripes.size();
+	}
+
+	/** Get the pathname of the filestore for a given source and stripe.
+	 * @param srcid the source ID
+	 * @param index the stripe index
+	 * @return the filestore pathname
+	 */
+	std::string pathname(const std::string& srcid, size_t index) const {
+		return _stripes[index] + "/" + srcid;
+	}
+
 	/** Get the size to which spoolfiles are permitted to grow.
 	 * @return the size, in octets
 	 */
@@ -64,9 +123,65 @@ public:
 		return _nodelete;
 	}
 
+	/** Get the maximum combined size of the spoolfiles for each source.
+	 * Once exceeded, the oldest spoolfiles are discarded even if they
+	 * have not been read.
+	 * @return the size, in octets, or 0 if unlimited
+	 */
+	unsigned long long retain_size() const {
+		return _retain_size;
+	}
+
+	/** Get the maximum age of a spoolfile.
+	 * Once exceeded, the spoolfile is discarded even if it has not
+	 * been read.
+	 * @return the age, in seconds, or 0 if unlimited
+	 */
+	long retain_age() const {
+		return _retain_age;
+	}
+
+	/** Check whether spoolfiles should be written using O_DIRECT.
+	 * @return true to use O_DIRECT, otherwise false
+	 */
+	bool odirect() const {
+		return _odirect;
+	}
+
+	/** Check whether records should be delta encoded.
+	 * @return true to delta encode, otherwise false
+	 */
+	bool delta() const {
+		return _delta;
+	}
+
+	/** Check whether record templates should be used.
+	 * @return true to use record templates, otherwise false
+	 */
+	bool templates() const {
+		return _templates;
+	}
+
+	/** Get the labels of the attributes to which a string dictionary
+	 * should be applied.
+	 * @return the attribute labels, or an empty list if none
+	 */
+	const std::vector<std::string>& dictionary() const {
+		return _dictionary;
+	}
+
+	/** Get the pool of buffers for reading and writing spoolfiles.
+	 * @return the buffer pool
+	 */
+	buffer_pool& pool() const {
+		return *_pool;
+	}
+
 	/** Test whether the endpoint is writable.
 	 * This function should have the same behaviour as
-	 * horace::session_writer::writable.
+	 * horace::session_writer::writable. When striping, all of the
+	 * stripes must have sufficient free space, because spoolfiles
+	 * cannot be allocated to them out of order.
 	 * @return true if writable, otherwise false
 	 */
 	bool writable();
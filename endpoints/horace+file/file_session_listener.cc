@@ -15,33 +15,35 @@
 
 namespace horace {
 
+void file_session_listener::_add(const std::string& srcid) {
+	// Exclude names beginning with a dot to ensure that session
+	// readers are not created for the current directory, the parent
+	// directory, or any lockfiles.
+	if (srcid.empty() || (srcid[0] == '.')) {
+		return;
+	}
+
+	// Exclude sources in the accepted set, to avoid creating more
+	// than one session reader for a given source.
+	// (No need to check the pending set because inserting a second
+	// time would have no effect.)
+	if (_accepted.find(srcid) == _accepted.end()) {
+		_pending.insert(srcid);
+	}
+}
+
 void file_session_listener::_scan() {
 	// Iterate over the names in the directory.
 	directory dir(_pathname);
 	while (dir) {
-		std::string filename = dir.read();
-
-		// Exclude names beginning with a dot to ensure that
-		// session readers are not created for the current
-		// directory, the parent directory, or any lockfiles.
-		if (!filename.empty() && (filename[0] != '.')) {
-			// Exclude sources in the accepted set, to avoid
-			// creating more than one session reader for a
-			// given source.
-			// (No need to check the pending set because it
-			// shouldn't be in there, and even if it was
-			// inserting a second time would have no effect.)
-			if (_accepted.find(filename) == _accepted.end()) {
-				_pending.insert(filename);
-			}
-		}
+		_add(dir.read());
 	}
 }
 
 file_session_listener::file_session_listener(file_endpoint& src_ep):
 	_src_ep(&src_ep),
 	_pathname(src_ep.pathname()),
-	_watcher(_pathname) {
+	_watcher(_pathname, IN_CREATE|IN_MOVED_TO|IN_ONLYDIR) {
 
 	// Existing sources will not be detected by inotify, therefore
 	// an initial scan is needed.
@@ -61,19 +63,15 @@ std::unique_ptr<session_reader> file_session_listener::accept() {
 				*_src_ep, srcid);
 		}
 
-		// Wait for any addition to the directory.
-		// Occasional false positives are tolerable here, since the
-		// objective is merely to avoid having to scan the
-		//  directory continuously.
-		_watcher.read();
-
-		// Rescan the directory to pick up any new sources.
-		// This method is somewhat inefficient, but new sources are
-		// expected to be sufficiently infrequent for that not to
-		// be a concern. It does have the virtue of not needing to
-		// detect and handle overruns in the inotify queue, which
-		// might otherwise cause sources to be missed.
-		_scan();
+		// Wait for any addition to the directory, and add it to
+		// the pending set. If the inotify queue has overflowed then
+		// sources may have been missed, so rescan the directory.
+		directory_watcher::event ev = _watcher.read();
+		if (ev.overflow()) {
+			_scan();
+		} else if (ev.added()) {
+			_add(ev.name());
+		}
 	}
 }
 
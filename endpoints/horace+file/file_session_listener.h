@@ -35,6 +35,11 @@ public:
 	/** The set of sources observed but not yet accepted. */
 	std::set<std::string> _pending;
 
+	/** Add a source to the pending set, unless excluded.
+	 * @param srcid the source ID
+	 */
+	void _add(const std::string& srcid);
+
 	/** Scan the directory for new sources. */
 	void _scan();
 public:
@@ -14,6 +14,8 @@
 #include "horace/string_attribute.h"
 #include "horace/timestamp_attribute.h"
 #include "horace/attribute_list.h"
+#include "horace/logger.h"
+#include "horace/log_message.h"
 
 #include "filestore_scanner.h"
 #include "spoolfile.h"
@@ -29,14 +31,27 @@ file_session_reader::file_session_reader(file_endpoint& src_ep,
 	_srcid(srcid),
 	_pathname(src_ep.pathname() + "/" + srcid),
 	_dm(_pathname),
-	_fd(_pathname, O_RDONLY),
 	_watcher(_pathname),
 	_lockfile(_pathname + "/.rdlock"),
 	_next_filenum(0),
 	_minwidth(0),
+	_manifest(_pathname + "/.rdmanifest"),
 	_session_ts({0}),
 	_seqnum(0),
-	_awaiting_sync(false) {}
+	_awaiting_sync(false),
+	_discarded(0),
+	_opened(false) {
+
+	for (size_t i = 0; i != _src_ep->stripe_count(); ++i) {
+		std::string pathname = _src_ep->pathname(srcid, i);
+		directory_maker dm(pathname);
+		if (i != 0) {
+			_watcher.watch(pathname);
+		}
+		_stripes.push_back(pathname);
+		_fds.emplace_back(pathname, O_RDONLY);
+	}
+}
 
 std::string file_session_reader::_next_pathname() {
 	// Construct the filename for the new spoolfile, incrementing the
@@ -50,29 +65,105 @@ std::string file_session_reader::_next_pathname() {
 		throw endpoint_error("file number overflow");
 	}
 
-	// Construct the full pathname for the new spoolfile.
-	return _pathname + "/" + sf.filename();
+	// Construct the full pathname for the new spoolfile, within
+	// the appropriate stripe.
+	return _stripes[_src_ep->stripe(sf.filenum())] + "/" + sf.filename();
+}
+
+bool file_session_reader::_exists(unsigned long filenum,
+	unsigned int minwidth) const {
+
+	return spoolfile(filenum, minwidth).exists(
+		_stripes[_src_ep->stripe(filenum)]);
+}
+
+void file_session_reader::_locate() {
+	// The manifest is not maintained when deletion is suppressed,
+	// because the first spoolfile then never changes.
+	if (_manifest.valid() && !_src_ep->nodelete()) {
+		// The manifest can be trusted if it refers to a spoolfile
+		// which exists and has no predecessor. It may lag by one
+		// spoolfile if the reader stopped between deleting a
+		// spoolfile and updating the manifest.
+		unsigned long filenum = _manifest.filenum();
+		unsigned int minwidth = _manifest.minwidth();
+		bool first = (filenum == 0) || !_exists(filenum - 1, minwidth);
+		if (first && !_exists(filenum, minwidth)) {
+			filenum += 1;
+		}
+		if (first && _exists(filenum, minwidth)) {
+			_next_filenum = filenum;
+			_minwidth = minwidth;
+			return;
+		}
+	}
+
+	// Otherwise fall back to scanning the filestore.
+	filestore_scanner scanner(_stripes);
+	if (scanner.minwidth() != 0) {
+		_next_filenum = scanner.first_filenum();
+		_minwidth = scanner.minwidth();
+	}
+}
+
+bool file_session_reader::_open() {
+	std::string pathname = _next_pathname();
+	std::string next_pathname = _next_pathname();
+	try {
+		_sfr = std::make_unique<spoolfile_reader>(*this,
+			pathname, next_pathname, _src_ep->pool());
+		_opened = true;
+		return true;
+	} catch (libc_error& ex) {
+		if (ex.errno_value() != ENOENT) {
+			throw;
+		}
+		_next_filenum -= 2;
+		return false;
+	}
 }
 
 std::unique_ptr<record> file_session_reader::read() {
-	// If no spoolfile has been opened yet then attempt to open one.
-	if (!_sfr) {
-		// First scan to find first filenum. If the filestore is
+	// If no spoolfile is open then attempt to open one.
+	while (!_sfr) {
+		// First locate the first filenum. If the filestore is
 		// empty then wait until at least one spoolfile is available.
 		while (_minwidth == 0) {
-			filestore_scanner scanner(_pathname);
-			if (scanner.minwidth() != 0) {
-				_next_filenum = scanner.first_filenum();
-				_minwidth = scanner.minwidth();
+			_locate();
+			if (_minwidth == 0) {
+				wait();
+			}
+		}
+
+		// Now open the spoolfile. If it does not exist then it
+		// must have been discarded by a retention policy, in which
+		// case skip forward to the first spoolfile which remains.
+		uint64_t expected = _next_filenum;
+		if (!_open()) {
+			_locate();
+			if (_next_filenum > expected) {
+				_discarded += _next_filenum - expected;
 			} else {
 				wait();
 			}
 		}
+	}
 
-		// Now open the spoolfile.
-		std::string init_pathname = _next_pathname();
-		_sfr = std::make_unique<spoolfile_reader>(*this,
-			init_pathname, _next_pathname());
+	// Report any spoolfiles which were discarded. This is done
+	// after the session record of the spoolfile which follows them
+	// has been read, so that the warning falls within a session.
+	if (_discarded && !_opened) {
+		if (log->enabled(logger::log_warning)) {
+			log_message msg(*log, logger::log_warning);
+			msg << _discarded << " spoolfiles discarded before " <<
+				_sfr->pathname() << " could be read";
+		}
+		attribute_list attrs;
+		attrs.insert(std::make_unique<string_attribute>(attrid_message,
+			std::to_string(_discarded) +
+			" spoolfiles discarded by retention policy"));
+		_discarded = 0;
+		return std::make_unique<record>(channel_warning, std::move(attrs));
 	}
 
 	// If a sync record has already been returned for the current
@@ -86,9 +177,9 @@ std::unique_ptr<record> file_session_reader::read() {
 	// end of file error.
 	try {
 		std::unique_ptr<record> rec = std::make_unique<record>(_session, *_sfr);
+		_opened = false;
 		if (rec->channel_id() == channel_session) {
-			struct timespec new_ts = rec->find_one<timestamp_attribute>(
-				attrid_ts).content();
+			struct timespec new_ts = rec->find_ts().content();
 			if ((new_ts.tv_sec != _session_ts.tv_sec) ||
 				(new_ts.tv_nsec != _session_ts.tv_nsec)) {
 
@@ -96,8 +187,7 @@ std::unique_ptr<record> file_session_reader::read() {
 				_seqnum = 0;
 			}
 		} else if (rec->is_event()) {
-			_seqnum = rec->find_one<unsigned_integer_attribute>(
-				attrid_seqnum).content() + 1;
+			_seqnum = rec->find_seqnum().content() + 1;
 		}
 		return rec;
 	} catch (eof_error& ex) {
@@ -120,26 +210,32 @@ void file_session_reader::_handle_sync(const record& rec) {
 
 	// Check that the sync response record matches the outstanding
 	// sync request.
-	if (rec.find_one<string_attribute>(attrid_source).content() != _srcid) {
+	if (rec.find_source().content() != _srcid) {
 		throw horace_error("incorrect source ID in sync response");
 	}
-	auto sync_ts = rec.find_one<timestamp_attribute>(attrid_ts).content();
+	auto sync_ts = rec.find_ts().content();
 	if ((sync_ts.tv_sec != _session_ts.tv_sec) || (sync_ts.tv_nsec != _session_ts.tv_nsec)) {
 		throw horace_error("incorrect timestamp in sync response");
 	}
-	if (rec.find_one<unsigned_integer_attribute>(attrid_seqnum).content() != _seqnum) {
+	if (rec.find_seqnum().content() != _seqnum) {
 		throw horace_error("incorrect sequence number in sync response");
 	}
 
 	// Delete the current spoolfile, unless deletion suppressed.
+	// The manifest is updated before the directory is synchronised,
+	// so that (in the absence of striping) the rename is made durable
+	// by the same fsync.
 	if (!_src_ep->nodelete()) {
 		_sfr->unlink();
-		_fd.fsync();
+		_manifest.update(_next_filenum - 1, _minwidth);
+		_fds[_src_ep->stripe(_next_filenum - 2)].fsync();
 	}
 
-	// Proceed to the next spoolfile.
-	_sfr = std::make_unique<spoolfile_reader>(*this,
-		_sfr->next_pathname(), _next_pathname());
+	// Proceed to the next spoolfile. This is opened when the next
+	// record is read, so that any which have been discarded in the
+	// meantime can be detected.
+	_sfr = 0;
+	_next_filenum -= 1;
 	_awaiting_sync = false;
 }
 
@@ -168,8 +264,8 @@ bool file_session_reader::reset() {
 	return true;
 }
 
-void file_session_reader::wait() {
-	_watcher.read();
+directory_watcher::event file_session_reader::wait() {
+	return _watcher.read();
 }
 
 } /* namespace horace */
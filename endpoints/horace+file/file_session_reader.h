@@ -6,6 +6,8 @@
 #ifndef LIBHOLMES_HORACE_FILE_SESSION_READER
 #define LIBHOLMES_HORACE_FILE_SESSION_READER
 
+#include <vector>
+
 #include "horace/lockfile.h"
 #include "horace/record.h"
 #include "horace/session_context.h"
@@ -13,6 +15,7 @@
 
 #include "directory_maker.h"
 #include "directory_watcher.h"
+#include "filestore_manifest.h"
 
 namespace horace {
 
@@ -34,8 +37,14 @@ public:
 	/** The filestore subdirectory pathname. */
 	std::string _pathname;
 
-	/** A file descriptor for synchronising the subdirectory. */
-	file_descriptor _fd;
+	/** The filestore subdirectory pathname for each stripe.
+	 * The first of these is the same as _pathname.
+	 */
+	std::vector<std::string> _stripes;
+
+	/** File descriptors for synchronising the subdirectory of
+	 * each stripe. */
+	std::vector<file_descriptor> _fds;
 
 	/** A directory_maker instance for creating the subdirectory. */
 	directory_maker _dm;
@@ -52,6 +61,9 @@ public:
 	/** The minimum permitted width for a filenum, in digits. */
 	unsigned int _minwidth;
 
+	/** The manifest recording the first remaining filenum. */
+	filestore_manifest _manifest;
+
 	/** The current session context. */
 	session_context _session;
 
@@ -67,12 +79,39 @@ public:
 	/** True if waiting for a sync record, otherwise false. */
 	bool _awaiting_sync;
 
+	/** The number of spoolfiles found to have been discarded before
+	 * they could be read, and not yet reported. */
+	uint64_t _discarded;
+
+	/** True if no records have yet been read from the current
+	 * spoolfile, otherwise false. */
+	bool _opened;
+
 	/** Get the pathname at which to look for the next spoolfile.
 	 * This function has the side effect of incrementing the filenum
 	 * each time it is called.
 	 */
 	std::string _next_pathname();
 
+	/** Test whether a given spoolfile exists.
+	 * @param filenum the filenum of the spoolfile
+	 * @param minwidth the minimum filenum width, in digits
+	 * @return true if the spoolfile exists, otherwise false
+	 */
+	bool _exists(unsigned long filenum, unsigned int minwidth) const;
+
+	/** Locate the first spoolfile in the filestore.
+	 * The manifest is used if it is consistent with the filestore,
+	 * otherwise the filestore is scanned. If the filestore is empty
+	 * then _minwidth is left equal to zero.
+	 */
+	void _locate();
+
+	/** Attempt to open the next spoolfile.
+	 * @return true if opened, or false if it does not exist
+	 */
+	bool _open();
+
 	/** Handle a sync record.
 	 * @param rec the sync record
 	 */
@@ -92,8 +131,9 @@ public:
 	/** Wait for a change to the repository.
 	 * This could be a change to an existing file or the creation
 	 * of a new file.
+	 * @return the event which signalled the change
 	 */
-	void wait();
+	directory_watcher::event wait();
 };
 
 } /* namespace horace */
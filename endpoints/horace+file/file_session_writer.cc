@@ -3,13 +3,17 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <ctime>
+
 #include <fcntl.h>
+#include <sys/stat.h>
 
 #include "horace/endpoint_error.h"
 #include "horace/record.h"
 
 #include "spoolfile.h"
 #include "spoolfile_writer.h"
+#include "spoolfile_pruner.h"
 #include "filestore_scanner.h"
 #include "file_endpoint.h"
 #include "file_session_writer.h"
@@ -28,24 +32,61 @@ std::string file_session_writer::_next_pathname() {
 		throw endpoint_error("file number overflow");
 	}
 
-	// Construct the full pathname for the new spoolfile.
-	return _pathname + "/" + sf.filename();
+	// Construct the full pathname for the new spoolfile, within
+	// the appropriate stripe.
+	return _stripes[_dst_ep->stripe(sf.filenum())] + "/" + sf.filename();
+}
+
+void file_session_writer::_prune_existing() {
+	filestore_scanner scanner(_stripes);
+	if (scanner.minwidth() == 0) {
+		return;
+	}
+	for (unsigned long filenum = scanner.first_filenum();
+		filenum != scanner.next_filenum(); ++filenum) {
+
+		spoolfile sf(filenum, scanner.minwidth());
+		std::string pathname =
+			_stripes[_dst_ep->stripe(filenum)] + "/" + sf.filename();
+		struct stat statbuf;
+		if (stat(pathname.c_str(), &statbuf) == 0) {
+			_pruner->add(pathname, statbuf.st_size, statbuf.st_mtime);
+		}
+	}
 }
 
 void file_session_writer::_begin_spoolfile(const record& srec) {
 	if (_sfw) {
 		_sfw->sync();
+		if (_pruner) {
+			_pruner->add(_sfw->pathname(), _sfw->size(), time(0));
+		}
 	}
+	size_t index = _dst_ep->stripe(_next_filenum);
 	_sfw = std::make_unique<spoolfile_writer>(_next_pathname(),
-		_dst_ep->filesize());
+		_dst_ep->filesize(), _dst_ep->pool(), _stats, _dst_ep->odirect(),
+		_dst_ep->delta(), _dst_ep->templates(), _dst_ep->dictionary());
+	_files.add();
 	bool written = _sfw->write(srec);
 	if (!written) {
 		throw endpoint_error(
 			"failed to write session record to new spoolfile");
 	}
-	_fd.fsync();
+	_fds[index].fsync();
 
+	// The manifest is updated only once the new spoolfile is known
+	// to be durable, so that it never refers beyond the end of the
+	// filestore.
+	_manifest.update(_next_filenum, _minwidth);
+
+	_check_writable();
+}
+
+void file_session_writer::_check_writable() {
 	_writable = _dst_ep->writable();
+	if (!_writable && _pruner) {
+		_pruner->request_discard();
+	}
 }
 
 void file_session_writer::_write_record(const record& rec) {
@@ -79,15 +120,47 @@ file_session_writer::file_session_writer(file_endpoint& dst_ep,
 	_dst_ep(&dst_ep),
 	_pathname(dst_ep.pathname() + "/" + srcid),
 	_dm(_pathname),
-	_fd(_pathname, O_RDONLY),
 	_lockfile(_pathname + "/.wrlock"),
+	_manifest(_pathname + "/.wrmanifest"),
+	_stats("spool." + srcid),
+	_files(_stats.counter("files")),
 	_writable(false) {
 
-	filestore_scanner scanner(_pathname);
-	_next_filenum = scanner.next_filenum();
-	_minwidth = scanner.minwidth();
-	if (_minwidth == 0) {
-		_minwidth = 6;
+	for (size_t i = 0; i != _dst_ep->stripe_count(); ++i) {
+		std::string pathname = _dst_ep->pathname(srcid, i);
+		directory_maker dm(pathname);
+		_stripes.push_back(pathname);
+		_fds.emplace_back(pathname, O_RDONLY);
+	}
+
+	if (_manifest.valid()) {
+		// The manifest may lag behind the filestore if the writer
+		// stopped after creating a spoolfile but before updating
+		// the manifest, in which case skip over that spoolfile.
+		_next_filenum = _manifest.filenum();
+		_minwidth = _manifest.minwidth();
+		while (spoolfile(_next_filenum, _minwidth).exists(
+			_stripes[_dst_ep->stripe(_next_filenum)])) {
+
+			_next_filenum += 1;
+		}
+	} else {
+		// Without a manifest, fall back to scanning the filestore.
+		filestore_scanner scanner(_stripes);
+		_next_filenum = scanner.next_filenum();
+		_minwidth = scanner.minwidth();
+		if (_minwidth == 0) {
+			_minwidth = 6;
+		}
+	}
+
+	// Spoolfiles which already exist are candidates for being
+	// discarded, but the spoolfiles created by this session writer
+	// are not until they have been completed.
+	if (_dst_ep->retain_size() || _dst_ep->retain_age()) {
+		_pruner = std::make_unique<spoolfile_pruner>(srcid,
+			_dst_ep->retain_size(), _dst_ep->retain_age());
+		_prune_existing();
 	}
 }
 
@@ -111,9 +184,15 @@ void file_session_writer::handle_event(const record& rec) {
 	_write_record(rec);
 }
 
+void file_session_writer::flush() {
+	if (_sfw) {
+		_sfw->flush();
+	}
+}
+
 bool file_session_writer::writable() {
 	if (!_writable) {
-		_writable = _dst_ep->writable();
+		_check_writable();
 	}
 	return _writable;
 }
@@ -7,15 +7,19 @@
 #define LIBHOLMES_HORACE_FILE_SESSION_WRITER
 
 #include <memory>
+#include <vector>
 
 #include "horace/lockfile.h"
+#include "horace/stats_group.h"
 #include "horace/simple_session_writer.h"
 
 #include "directory_maker.h"
+#include "filestore_manifest.h"
 
 namespace horace {
 
 class spoolfile_writer;
+class spoolfile_pruner;
 class file_endpoint;
 
 /** A class for writing sessions to a filestore. */
@@ -31,8 +35,14 @@ private:
 	/** A directory_maker instance for creating the subdirectory. */
 	directory_maker _dm;
 
-	/** A file descriptor for synchronising the subdirectory. */
-	file_descriptor _fd;
+	/** The filestore subdirectory pathname for each stripe.
+	 * The first of these is the same as _pathname.
+	 */
+	std::vector<std::string> _stripes;
+
+	/** File descriptors for synchronising the subdirectory of
+	 * each stripe. */
+	std::vector<file_descriptor> _fds;
 
 	/** A lockfile for controlling write access to the subdirectory. */
 	lockfile _lockfile;
@@ -43,9 +53,21 @@ private:
 	/** The minimum permitted width for a filenum, in digits. */
 	unsigned int _minwidth;
 
+	/** The manifest recording the next filenum. */
+	filestore_manifest _manifest;
+
+	/** Statistics for this session writer. */
+	stats_group _stats;
+
+	/** A counter for recording spoolfiles created. */
+	stats_counter& _files;
+
 	/** A writer for the spoolfile. */
 	std::unique_ptr<spoolfile_writer> _sfw;
 
+	/** An optional object for discarding old spoolfiles. */
+	std::unique_ptr<spoolfile_pruner> _pruner;
+
 	/** True if the endpoint is writable, otherwise false.
 	 * This contains the cached result of _dst_ep->writable(), which is
 	 * called at the start of each spoolfile but not for each record.
@@ -59,6 +81,17 @@ private:
 	 */
 	std::string _next_pathname();
 
+	/** Pass any existing spoolfiles to the pruner. */
+	void _prune_existing();
+
+	/** Update the cached result of _dst_ep->writable().
+	 * If there is a retention policy and the endpoint is not writable
+	 * then the pruner is asked to discard the oldest spoolfile. This
+	 * happens in the background, so the endpoint may become writable
+	 * on a later call.
+	 */
+	void _check_writable();
+
 	/** Begin new spoolfile.
 	 * @param srec the session record to be written
 	 */
@@ -83,6 +116,7 @@ public:
 		const std::string& srcid);
 
 	virtual bool writable();
+	virtual void flush();
 };
 
 } /* namespace horace */
@@ -0,0 +1,82 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdio>
+
+#include <fcntl.h>
+
+#include "horace/libc_error.h"
+#include "horace/logger.h"
+#include "horace/log_message.h"
+#include "horace/file_descriptor.h"
+
+#include "filestore_manifest.h"
+
+namespace horace {
+
+namespace {
+
+/** The format of a manifest. */
+const char* manifest_format = "horace-manifest 1 %lu %u\n";
+
+/** The maximum length of a manifest, in octets. */
+const size_t max_manifest_length = 64;
+
+} /* anonymous namespace */
+
+filestore_manifest::filestore_manifest(const std::string& pathname):
+	_pathname(pathname),
+	_valid(false),
+	_filenum(0),
+	_minwidth(0) {
+
+	char buffer[max_manifest_length + 1];
+	size_t count = 0;
+	try {
+		file_descriptor fd(_pathname, O_RDONLY);
+		count = fd.read(buffer, max_manifest_length);
+	} catch (libc_error&) {
+		return;
+	}
+	buffer[count] = 0;
+
+	_valid = (sscanf(buffer, manifest_format,
+		&_filenum, &_minwidth) == 2) && (_minwidth != 0);
+
+	if (log->enabled(logger::log_debug)) {
+		log_message msg(*log, logger::log_debug);
+		if (_valid) {
+			msg << "read manifest " << _pathname << " (" <<
+				"filenum=" << _filenum << ", " <<
+				"minwidth=" << _minwidth << ")";
+		} else {
+			msg << "invalid manifest " << _pathname;
+		}
+	}
+}
+
+void filestore_manifest::update(unsigned long filenum,
+	unsigned int minwidth) {
+
+	char buffer[max_manifest_length];
+	int count = snprintf(buffer, sizeof(buffer), manifest_format,
+		filenum, minwidth);
+
+	std::string tmp_pathname = _pathname + ".tmp";
+	{
+		file_descriptor fd(tmp_pathname, O_WRONLY|O_CREAT|O_TRUNC);
+		fd.write(buffer, count);
+		fd.fsync();
+	}
+	if (rename(tmp_pathname.c_str(), _pathname.c_str()) == -1) {
+		throw libc_error();
+	}
+
+	_valid = true;
+	_filenum = filenum;
+	_minwidth = minwidth;
+}
+
+} /* namespace horace */
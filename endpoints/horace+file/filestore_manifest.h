@@ -0,0 +1,80 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_FILESTORE_MANIFEST
+#define LIBHOLMES_HORACE_FILESTORE_MANIFEST
+
+#include <string>
+
+namespace horace {
+
+/** A class to represent the persistent state of a filestore.
+ * This records a filenum and the minimum filenum width, so that the
+ * position within a filestore can be recovered without scanning the
+ * whole directory. The writer and reader each keep a manifest of their
+ * own, so that each manifest has only one owner.
+ *
+ * Updates are made by writing a temporary file then renaming it, so a
+ * manifest is always either the old or the new version. However it
+ * can lag behind the filestore if the process stopped between changing
+ * the filestore and updating the manifest, so the content should be
+ * checked against the filestore before it is relied upon. If that check
+ * fails, or the manifest is missing or unreadable, then the filestore
+ * should be scanned instead.
+ */
+class filestore_manifest {
+private:
+	/** The pathname of the manifest. */
+	std::string _pathname;
+
+	/** True if the manifest was read successfully, otherwise false. */
+	bool _valid;
+
+	/** The recorded filenum. */
+	unsigned long _filenum;
+
+	/** The recorded minimum filenum width, in digits. */
+	unsigned int _minwidth;
+public:
+	/** Read manifest.
+	 * If the manifest does not exist or cannot be parsed then it is
+	 * marked as invalid, but no exception is thrown.
+	 * @param pathname the pathname of the manifest
+	 */
+	explicit filestore_manifest(const std::string& pathname);
+
+	/** Determine whether the manifest was read successfully.
+	 * @return true if valid, otherwise false
+	 */
+	bool valid() const {
+		return _valid;
+	}
+
+	/** Get the recorded filenum.
+	 * @return the filenum
+	 */
+	unsigned long filenum() const {
+		return _filenum;
+	}
+
+	/** Get the recorded minimum filenum width.
+	 * @return the minimum width, in digits
+	 */
+	unsigned int minwidth() const {
+		return _minwidth;
+	}
+
+	/** Update the manifest.
+	 * The new content is synchronised to disc before it replaces the
+	 * old content, but the containing directory is not synchronised.
+	 * @param filenum the filenum to be recorded
+	 * @param minwidth the minimum filenum width to be recorded
+	 */
+	void update(unsigned long filenum, unsigned int minwidth);
+};
+
+} /* namespace horace */
+
+#endif
@@ -15,17 +15,12 @@
 
 namespace horace {
 
-filestore_scanner::filestore_scanner(const std::string& pathname):
-	_first_filenum(ULONG_MAX),
-	_next_filenum(0),
-	_minwidth(UINT_MAX) {
-
+void filestore_scanner::_scan(const std::string& pathname) {
 	if (log->enabled(logger::log_debug)) {
 		log_message msg(*log, logger::log_debug);
 		msg << "scanning filestore " << pathname;
 	}
 
-	bool minwidth_fixed = false;
 	directory dir(pathname);
 	while (dir) {
 		std::string filename = dir.read();
@@ -36,7 +31,7 @@ filestore_scanner::filestore_scanner(const std::string& pathname):
 				throw std::runtime_error("file number overflow");
 			}
 
-			if (!minwidth_fixed) {
+			if (!_minwidth_fixed) {
 				if (sf.has_padding()) {
 					// Had padding, minwidth not yet fixed:
 					// Fix minwidth, after checking that it is
@@ -45,7 +40,7 @@ filestore_scanner::filestore_scanner(const std::string& pathname):
 						throw std::runtime_error("inconsistent padding in filestore");
 					}
 					_minwidth = filename.length();
-					minwidth_fixed = true;
+					_minwidth_fixed = true;
 				} else {
 					// No padding, minwidth not yet fixed:
 					// Cannot be inconsistent with previous
@@ -78,6 +73,21 @@ filestore_scanner::filestore_scanner(const std::string& pathname):
 			}
 		}
 	}
+}
+
+filestore_scanner::filestore_scanner(const std::string& pathname):
+	filestore_scanner(std::vector<std::string>{pathname}) {}
+
+filestore_scanner::filestore_scanner(
+	const std::vector<std::string>& pathnames):
+	_first_filenum(ULONG_MAX),
+	_next_filenum(0),
+	_minwidth(UINT_MAX),
+	_minwidth_fixed(false) {
+
+	for (const auto& pathname : pathnames) {
+		_scan(pathname);
+	}
 
 	if (_first_filenum == ULONG_MAX) {
 		_first_filenum = 0;
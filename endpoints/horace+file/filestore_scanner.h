@@ -7,6 +7,7 @@
 #define LIBHOLMES_HORACE_FILESTORE_SCANNER
 
 #include <string>
+#include <vector>
 
 namespace horace {
 
@@ -24,12 +25,28 @@ private:
 	/** The minimum width of a filenum, in digits, or 0 if the filestore
 	 * is empty. */
 	unsigned int _minwidth;
+
+	/** True if the minimum width has been fixed by a padded filename,
+	 * otherwise false. */
+	bool _minwidth_fixed;
+
+	/** Scan one directory of the filestore.
+	 * @param pathname the directory pathname
+	 */
+	void _scan(const std::string& pathname);
 public:
 	/** Scan filestore.
 	 * @param pathname the filestore pathname
 	 */
 	explicit filestore_scanner(const std::string& pathname);
 
+	/** Scan filestore which is striped across several directories.
+	 * The result is the same as if the spoolfiles were all held
+	 * within a single directory.
+	 * @param pathnames the pathnames of the stripes
+	 */
+	explicit filestore_scanner(const std::vector<std::string>& pathnames);
+
 	/** Get the first file number in the filestore.
 	 * @return the first file number, or 0 if filestore empty
 	 */
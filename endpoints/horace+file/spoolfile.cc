@@ -8,6 +8,8 @@
 #include <sstream>
 #include <iomanip>
 
+#include <unistd.h>
+
 #include "spoolfile.h"
 
 namespace horace {
@@ -44,4 +46,9 @@ spoolfile::spoolfile(unsigned long filenum, unsigned int minwidth):
 	_filename = builder.str();
 }
 
+bool spoolfile::exists(const std::string& pathname) const {
+	std::string sf_pathname = pathname + "/" + _filename;
+	return access(sf_pathname.c_str(), F_OK) == 0;
+}
+
 } /* namespace */
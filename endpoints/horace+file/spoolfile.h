@@ -50,6 +50,12 @@ public:
 	bool has_padding() const {
 		return _filename.length() && (_filename[0] == '0');
 	}
+
+	/** Test whether this spoolfile exists within a given filestore.
+	 * @param pathname the filestore pathname
+	 * @return true if the spoolfile exists, otherwise false
+	 */
+	bool exists(const std::string& pathname) const;
 };
 
 } /* namespace horace */
@@ -0,0 +1,156 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cerrno>
+
+#include <unistd.h>
+
+#include "horace/libc_error.h"
+#include "horace/logger.h"
+#include "horace/log_message.h"
+
+#include "spoolfile_pruner.h"
+
+namespace horace {
+
+spoolfile_pruner::spoolfile_pruner(const std::string& srcid,
+	unsigned long long max_size, long max_age):
+	_max_size(max_size),
+	_max_age(max_age),
+	_size(0),
+	_demand(false),
+	_stopping(false),
+	_stats("retain." + srcid),
+	_files(_stats.counter("files")),
+	_octets(_stats.counter("octets")) {
+
+	_thread = std::thread(&spoolfile_pruner::_run, this);
+}
+
+spoolfile_pruner::~spoolfile_pruner() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_stopping = true;
+	}
+	_cv.notify_one();
+	_thread.join();
+}
+
+bool spoolfile_pruner::_expired(time_t now) const {
+	if (_entries.empty()) {
+		return false;
+	}
+	if (_max_size && (_size > _max_size)) {
+		return true;
+	}
+	if (_max_age && (now - _entries.front().mtime > _max_age)) {
+		return true;
+	}
+	return false;
+}
+
+void spoolfile_pruner::_run() {
+	std::unique_lock<std::mutex> lk(_mutex);
+	while (!_stopping) {
+		// Wait until a spoolfile is added or requested to be
+		// discarded, or (if there is an age limit) until the oldest
+		// might have expired.
+		if (!_demand) {
+			if (_max_age) {
+				_cv.wait_for(lk, std::chrono::seconds(1));
+			} else {
+				_cv.wait(lk);
+			}
+		}
+		if (_stopping) {
+			break;
+		}
+
+		_reconcile(lk);
+		if (_demand) {
+			_demand = false;
+			if (!_entries.empty()) {
+				_discard(lk);
+			}
+		}
+		while (!_stopping && _expired(time(0))) {
+			_discard(lk);
+		}
+	}
+}
+
+void spoolfile_pruner::_reconcile(std::unique_lock<std::mutex>& lk) {
+	// Entries are removed from the front of the queue only by this
+	// thread, so the front entry cannot change while the mutex is
+	// released.
+	while (!_entries.empty()) {
+		std::string pathname = _entries.front().pathname;
+		lk.unlock();
+		int result = access(pathname.c_str(), F_OK);
+		int err = errno;
+		lk.lock();
+		if (result == 0 || err != ENOENT) {
+			break;
+		}
+		_size -= _entries.front().size;
+		_entries.pop_front();
+	}
+}
+
+void spoolfile_pruner::_discard(std::unique_lock<std::mutex>& lk) {
+	entry oldest = std::move(_entries.front());
+	_entries.pop_front();
+	_size -= oldest.size;
+
+	// The mutex is not needed while deleting the spoolfile, and
+	// should not be held because deletion can take some time.
+	lk.unlock();
+	int result = unlink(oldest.pathname.c_str());
+	int err = errno;
+	lk.lock();
+
+	// A spoolfile which no longer exists has already been read,
+	// so nothing has been lost.
+	if (result == 0) {
+		_files.add();
+		_octets.add(oldest.size);
+		if (log->enabled(logger::log_warning) && _limiter.permit()) {
+			log_message msg(*log, logger::log_warning);
+			msg << "discarded unread spoolfile " <<
+				oldest.pathname << " (retention policy)";
+			if (uint64_t count = _limiter.suppressed()) {
+				msg << ", " << count << " more suppressed";
+			}
+		}
+	} else if (err != ENOENT) {
+		if (log->enabled(logger::log_err)) {
+			log_message msg(*log, logger::log_err);
+			msg << "failed to discard spoolfile " <<
+				oldest.pathname << " (" <<
+				libc_error(err).what() << ")";
+		}
+	}
+}
+
+void spoolfile_pruner::add(const std::string& pathname, size_t size,
+	time_t mtime) {
+
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_entries.push_back(entry{pathname, size, mtime});
+		_size += size;
+	}
+	_cv.notify_one();
+}
+
+void spoolfile_pruner::request_discard() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_demand = true;
+	}
+	_cv.notify_one();
+}
+
+} /* namespace horace */
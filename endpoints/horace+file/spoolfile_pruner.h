@@ -0,0 +1,162 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SPOOLFILE_PRUNER
+#define LIBHOLMES_HORACE_SPOOLFILE_PRUNER
+
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "horace/log_limiter.h"
+#include "horace/stats_group.h"
+
+namespace horace {
+
+/** A class for discarding spoolfiles according to a retention policy.
+ * Spoolfiles are retained until either their combined size exceeds a
+ * given limit, or they exceed a given age, whereupon the oldest are
+ * deleted whether or not they have been forwarded. This allows capture
+ * to continue indefinitely at the expense of older data, as an
+ * alternative to stopping when the filesystem becomes full.
+ *
+ * If a free space threshold is reached before either limit then further
+ * spoolfiles can be discarded on demand, so that capture stops only
+ * once there are none left to discard.
+ *
+ * Completed spoolfiles are passed to the pruner as they are closed,
+ * and deleted by a background thread so that capture is not delayed.
+ * This includes spoolfiles discarded on demand. Readers also delete
+ * the oldest spoolfiles first, so any which have already been read are
+ * at the front of the queue. These are removed from it, and from the
+ * combined size, before the retention limits are applied.
+ */
+class spoolfile_pruner {
+private:
+	/** A structure to describe a completed spoolfile. */
+	struct entry {
+		/** The pathname of the spoolfile. */
+		std::string pathname;
+
+		/** The size of the spoolfile, in octets. */
+		size_t size;
+
+		/** The time at which the spoolfile was completed. */
+		time_t mtime;
+	};
+
+	/** The maximum combined size of the spoolfiles, in octets,
+	 * or 0 if unlimited. */
+	unsigned long long _max_size;
+
+	/** The maximum age of a spoolfile, in seconds, or 0 if
+	 * unlimited. */
+	long _max_age;
+
+	/** A mutex to protect _entries, _size, _demand and _stopping. */
+	std::mutex _mutex;
+
+	/** A condition variable for waking the background thread. */
+	std::condition_variable _cv;
+
+	/** The completed spoolfiles, oldest first. */
+	std::deque<entry> _entries;
+
+	/** The combined size of the entries, in octets. */
+	unsigned long long _size;
+
+	/** True if a spoolfile should be discarded on demand,
+	 * otherwise false. */
+	bool _demand;
+
+	/** True if the background thread should stop, otherwise false. */
+	bool _stopping;
+
+	/** Statistics for this pruner. */
+	stats_group _stats;
+
+	/** A counter for recording spoolfiles discarded. */
+	stats_counter& _files;
+
+	/** A counter for recording octets discarded. */
+	stats_counter& _octets;
+
+	/** A limiter for warnings about discarded spoolfiles. */
+	log_limiter _limiter;
+
+	/** The background thread. */
+	std::thread _thread;
+
+	/** Test whether the oldest entry should be discarded.
+	 * The mutex must be held when this function is called.
+	 * @param now the current time
+	 * @return true if it should be discarded, otherwise false
+	 */
+	bool _expired(time_t now) const;
+
+	/** Remove entries for spoolfiles which have already been deleted.
+	 * Only entries at the front of the queue are checked, since
+	 * readers delete the oldest spoolfiles first.
+	 * The mutex must be held when this function is called. It is
+	 * released while each spoolfile is checked.
+	 * @param lk a lock holding the mutex
+	 */
+	void _reconcile(std::unique_lock<std::mutex>& lk);
+
+	/** Discard the oldest spoolfile.
+	 * The mutex must be held when this function is called, and there
+	 * must be at least one entry. It is released while the spoolfile
+	 * is deleted.
+	 * @param lk a lock holding the mutex
+	 */
+	void _discard(std::unique_lock<std::mutex>& lk);
+
+	/** Discard spoolfiles as they expire until asked to stop. */
+	void _run();
+public:
+	/** Construct spoolfile pruner.
+	 * @param srcid the source ID, for reporting purposes
+	 * @param max_size the maximum combined size of the spoolfiles,
+	 *  in octets, or 0 if unlimited
+	 * @param max_age the maximum age of a spoolfile, in seconds,
+	 *  or 0 if unlimited
+	 */
+	spoolfile_pruner(const std::string& srcid,
+		unsigned long long max_size, long max_age);
+
+	/** Destroy spoolfile pruner.
+	 * The background thread is stopped before the destructor returns.
+	 */
+	~spoolfile_pruner();
+
+	spoolfile_pruner(const spoolfile_pruner&) = delete;
+	spoolfile_pruner& operator=(const spoolfile_pruner&) = delete;
+
+	/** Add a completed spoolfile.
+	 * Spoolfiles must be added in the order in which they would be
+	 * read.
+	 * @param pathname the pathname of the spoolfile
+	 * @param size the size of the spoolfile, in octets
+	 * @param mtime the time at which the spoolfile was completed
+	 */
+	void add(const std::string& pathname, size_t size, time_t mtime);
+
+	/** Request that the oldest spoolfile be discarded, regardless of
+	 * whether it has exceeded the retention limits.
+	 * This allows space to be reclaimed on demand when the filesystem
+	 * is too full for capture to continue. The spoolfile is deleted by
+	 * the background thread, so this function does not block. Requests
+	 * made before the previous one has been acted upon are coalesced,
+	 * so at most one spoolfile is discarded per request.
+	 */
+	void request_discard();
+};
+
+} /* namespace horace */
+
+#endif
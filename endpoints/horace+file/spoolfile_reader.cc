@@ -3,6 +3,8 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <cerrno>
+
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -26,22 +28,39 @@ size_t spoolfile_reader::_read_direct(void* buf, size_t nbyte) {
 			// Must not return zero unless the observation of
 			// _next_pathname preceded the attempt to read data.
 			return 0;
-		} else if (access(_next_pathname.c_str(), F_OK) == 0) {
+		} else if (_next_exists) {
 			eof = true;
 		} else {
-			_fsr->wait();
+			// Wait for the following spoolfile to be added, rather
+			// than polling for it. Only if events have been lost
+			// is it necessary to check the filesystem directly.
+			directory_watcher::event ev = _fsr->wait();
+			if (ev.overflow()) {
+				_next_exists =
+					(access(_next_pathname.c_str(), F_OK) == 0);
+			} else if (ev.added() && (ev.name() == _next_filename)) {
+				_next_exists = true;
+			}
 		}
 	}
 }
 
 spoolfile_reader::spoolfile_reader(file_session_reader& fsr,
-	const std::string& pathname, const std::string& next_pathname):
-	buffer(0x40),
+	const std::string& pathname, const std::string& next_pathname,
+	buffer_pool& pool):
+	buffer(pool),
 	octet_reader(buffer_ptr(), buffer_size(), 0),
 	_fsr(&fsr),
 	_fd(pathname, O_RDONLY),
 	_pathname(pathname),
-	_next_pathname(next_pathname) {
+	_next_pathname(next_pathname),
+	_next_filename(next_pathname.substr(next_pathname.rfind('/') + 1)),
+	_next_exists(false) {
+
+	// The following spoolfile may already exist, in which case no
+	// event will be received for it. Any spoolfile created after
+	// this check will be reported by the directory watcher.
+	_next_exists = (access(_next_pathname.c_str(), F_OK) == 0);
 
 	if (log->enabled(logger::log_info)) {
 		log_message msg(*log, logger::log_info);
@@ -50,7 +69,12 @@ spoolfile_reader::spoolfile_reader(file_session_reader& fsr,
 }
 
 void spoolfile_reader::unlink() {
+	// The spoolfile may already have been discarded by a retention
+	// policy, which is not an error.
 	if (::unlink(_pathname.c_str()) == -1) {
+		if (errno == ENOENT) {
+			return;
+		}
 		throw libc_error();
 	}
 
@@ -13,6 +13,7 @@
 namespace horace {
 
 class record;
+class buffer_pool;
 class file_session_reader;
 
 /** An octet reader class for reading from a spoolfile. */
@@ -31,6 +32,14 @@ private:
 
 	/** The pathname of the following spoolfile. */
 	std::string _next_pathname;
+
+	/** The filename of the following spoolfile, without the
+	 * directory. */
+	std::string _next_filename;
+
+	/** True if the following spoolfile is known to exist,
+	 * otherwise false. */
+	bool _next_exists;
 protected:
 	virtual size_t _read_direct(void* buf, size_t nbyte);
 public:
@@ -38,9 +47,11 @@ public:
 	 * @param fsr the file session reader which is reading the spoolfile
 	 * @param pathname the pathname of the spoolfile to be read
 	 * @param next_pathname the pathname of the following spoolfile
+	 * @param pool the pool from which to acquire a buffer
 	 */
-	explicit spoolfile_reader(file_session_reader& fsr,
-		const std::string& pathname, const std::string& next_pathname);
+	spoolfile_reader(file_session_reader& fsr,
+		const std::string& pathname, const std::string& next_pathname,
+		buffer_pool& pool);
 
 	/** Attempt to read record from spoolfile.
 	 * If a record cannot be read immediately then this function will
@@ -3,28 +3,73 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <iostream>
+
+#include <unistd.h>
 #include <fcntl.h>
 
+#include "horace/libc_error.h"
 #include "horace/logger.h"
 #include "horace/log_message.h"
-#include "horace/unsigned_base128_integer.h"
-#include "horace/signed_base128_integer.h"
 #include "horace/unsigned_integer_attribute.h"
 #include "horace/attribute_list.h"
 #include "horace/record.h"
+#include "horace/dictionary_encoder.h"
+#include "horace/delta_encoder.h"
+#include "horace/template_encoder.h"
+#include "horace/stats_group.h"
+#include "horace/stats_timer.h"
 
+#include "direct_octet_writer.h"
 #include "spoolfile_writer.h"
 
 namespace horace {
 
 spoolfile_writer::spoolfile_writer(const std::string& pathname,
-	size_t capacity):
+	size_t capacity, buffer_pool& pool, stats_group& stats,
+	bool odirect, bool delta, bool templates,
+	const std::vector<std::string>& dictionary):
 	_pathname(pathname),
 	_fd(pathname, O_RDWR|O_CREAT|O_EXCL, 0666),
-	_ow(_fd),
+	_dow(0),
 	_size(0),
 	_capacity(capacity),
-	_first(true) {
+	_first(true),
+	_records(&stats.counter("records")),
+	_octets(&stats.counter("octets")),
+	_sync_ns(&stats.histogram("sync_ns")) {
+
+	if (odirect) {
+		// Preallocate without changing the file size, so that
+		// readers never see the unwritten space. Failure is not
+		// fatal, since it affects only performance.
+		if (fallocate(_fd, FALLOC_FL_KEEP_SIZE, 0, capacity) == -1) {
+			if (log->enabled(logger::log_warning)) {
+				log_message msg(*log, logger::log_warning);
+				msg << "failed to preallocate spoolfile " <<
+					_pathname << " (" << libc_error().what() << ")";
+			}
+		}
+
+		auto dow = std::make_unique<direct_octet_writer>(
+			pathname, _fd, pool.size());
+		_dow = dow.get();
+		_ow = std::move(dow);
+	} else {
+		_ow = std::make_unique<file_octet_writer>(_fd, pool);
+	}
+
+	// Each spoolfile has its own encoding state, so that it can be
+	// decoded independently of any others.
+	if (!dictionary.empty()) {
+		_senc = std::make_unique<dictionary_encoder>(dictionary);
+	}
+	if (delta) {
+		_denc = std::make_unique<delta_encoder>();
+	}
+	if (templates) {
+		_tenc = std::make_unique<template_encoder>();
+	}
 
 	if (log->enabled(logger::log_info)) {
 		log_message msg(*log, logger::log_info);
@@ -32,8 +77,34 @@ spoolfile_writer::spoolfile_writer(const std::string& pathname,
 	}
 }
 
-void spoolfile_writer::sync() const {
-	_fd.fsync();
+spoolfile_writer::~spoolfile_writer() {
+	// Release any preallocated space which was not used, once the
+	// last record has been written in full.
+	if (_dow) {
+		try {
+			flush();
+			if (ftruncate(_fd, _dow->position()) == -1) {
+				throw libc_error();
+			}
+		} catch (std::exception& ex) {
+			std::cerr << ex.what() << std::endl;
+		}
+	}
+}
+
+void spoolfile_writer::flush() {
+	_ow->flush();
+	if (_dow) {
+		_dow->publish();
+	}
+}
+
+void spoolfile_writer::sync() {
+	flush();
+	{
+		stats_timer timer(*_sync_ns);
+		_fd.fsync();
+	}
 
 	if (log->enabled(logger::log_info)) {
 		log_message msg(*log, logger::log_info);
@@ -41,14 +112,17 @@ void spoolfile_writer::sync() const {
 	}
 }
 
-bool spoolfile_writer::write(const record& rec) {
+bool spoolfile_writer::write(const record& orig_rec) {
+	// If the record is not written then the encoder state will be
+	// incorrect, however that is acceptable because it is not
+	// possible to write any further records to this spoolfile.
+	const record& srec = (_senc) ? _senc->encode(orig_rec) : orig_rec;
+	const record& drec = (_denc) ? _denc->encode(srec) : srec;
+	const record& rec = (_tenc) ? _tenc->encode(drec) : drec;
+
 	// Calculate the number of octets required for this record,
 	// including the channel ID and length fields.
-	size_t content_len = rec.attributes().length();
-	size_t full_len =
-		signed_base128_integer(rec.channel_id()).length() +
-		unsigned_base128_integer(content_len).length() +
-		content_len;
+	size_t full_len = rec.length();
 
 	// Return false if this record would cause the spoolfile capacity
 	// to be exceeded, except that it is always permissible to write
@@ -58,9 +132,11 @@ bool spoolfile_writer::write(const record& rec) {
 	}
 
 	// Write the record, updating the spoolfile size.
-	rec.write(_ow);
+	rec.write(*_ow);
 	_size += full_len;
 	_first = false;
+	_records->add();
+	_octets->add(full_len);
 	return true;
 }
 
@@ -7,12 +7,24 @@
 #define LIBHOLMES_HORACE_SPOOLFILE_WRITER
 
 #include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "horace/file_descriptor.h"
 #include "horace/file_octet_writer.h"
 
 namespace horace {
 
+class buffer_pool;
+class direct_octet_writer;
+class dictionary_encoder;
+class delta_encoder;
+class template_encoder;
+class stats_group;
+class stats_counter;
+class stats_histogram;
+
 /** A class for writing records to a spoolfile. */
 class spoolfile_writer {
 private:
@@ -23,7 +35,23 @@ private:
 	file_descriptor _fd;
 
 	/** An octet writer for writing to the spoolfile. */
-	file_octet_writer _ow;
+	std::unique_ptr<octet_writer> _ow;
+
+	/** The octet writer cast to a direct_octet_writer if direct I/O
+	 * is in use, otherwise null. */
+	direct_octet_writer* _dow;
+
+	/** An encoder for applying a string dictionary, or null if a
+	 * string dictionary is not in use. */
+	std::unique_ptr<dictionary_encoder> _senc;
+
+	/** An encoder for delta encoding records, or null if delta
+	 * encoding is not in use. */
+	std::unique_ptr<delta_encoder> _denc;
+
+	/** An encoder for applying record templates, or null if record
+	 * templates are not in use. */
+	std::unique_ptr<template_encoder> _tenc;
 
 	/** The current size of this spoolfile, in octets. */
 	size_t _size;
@@ -33,25 +61,70 @@ private:
 
 	/** True if no event records have been written, otherwise false. */
 	bool _first;
+
+	/** A counter for recording records written. */
+	stats_counter* _records;
+
+	/** A counter for recording octets written. */
+	stats_counter* _octets;
+
+	/** A histogram for recording the time taken to sync the
+	 * spoolfile, in nanoseconds. */
+	stats_histogram* _sync_ns;
 public:
 	/** Construct spoolfile writer.
+	 * If direct I/O is requested then space for the full capacity
+	 * is preallocated, and any which is unused is released when the
+	 * spoolfile writer is destroyed.
 	 * @param pathname the required pathname
 	 * @param capacity the required capacity, in octets
+	 * @param pool the pool from which to acquire a buffer
+	 * @param stats a statistics group for recording activity
+	 * @param odirect true to write using O_DIRECT, otherwise false
+	 * @param delta true to delta encode records, otherwise false
+	 * @param templates true to use record templates, otherwise false
+	 * @param dictionary the labels of the attributes to which a string
+	 *  dictionary should be applied, or an empty list if none
 	 */
-	explicit spoolfile_writer(const std::string& pathname,
-		size_t capacity);
+	spoolfile_writer(const std::string& pathname, size_t capacity,
+		buffer_pool& pool, stats_group& stats, bool odirect = false,
+		bool delta = false, bool templates = false,
+		const std::vector<std::string>& dictionary = {});
+
+	/** Destroy spoolfile writer. */
+	~spoolfile_writer();
 
 	spoolfile_writer(const spoolfile_writer&) = delete;
 	spoolfile_writer& operator=(const spoolfile_writer&) = delete;
 	spoolfile_writer(spoolfile_writer&& that) = delete;
 	spoolfile_writer& operator=(spoolfile_writer&& that) = delete;
 
+	/** Get the pathname of this spoolfile.
+	 * @return the pathname
+	 */
+	const std::string& pathname() const {
+		return _pathname;
+	}
+
+	/** Get the current size of this spoolfile.
+	 * @return the size, in octets
+	 */
+	size_t size() const {
+		return _size;
+	}
+
+	/** Flush any records which have been buffered.
+	 * This makes them visible to readers, but does not ensure that
+	 * they have been written durably.
+	 */
+	void flush();
+
 	/** Ensure that the spoolfile content has been written durably.
-	 * Note that this function does not ensure the durability of the
-	 * spoolfile directory entry, nor of any entries further up the
-	 * directory hierarchy.
+	 * Any buffered records are flushed first. Note that this function
+	 * does not ensure the durability of the spoolfile directory entry,
+	 * nor of any entries further up the directory hierarchy.
 	 */
-	void sync() const;
+	void sync();
 
 	/** Attempt to write record to spoolfile.
 	 * This operation will fail if the spoolfile has insufficient
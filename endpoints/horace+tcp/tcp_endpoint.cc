@@ -3,6 +3,7 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include "horace/endpoint_error.h"
 #include "horace/query_string.h"
 
 #include "tcp_session_listener.h"
@@ -14,7 +15,9 @@ namespace horace {
 tcp_endpoint::tcp_endpoint(const std::string& name):
 	endpoint(name),
 	_retry(30),
-	_diode(false) {
+	_diode(false),
+	_delta(false),
+	_templates(false) {
 
 	std::string hostportname = this->name().authority().value_or("");
 	size_t index = hostportname.rfind(':');
@@ -27,11 +30,21 @@ tcp_endpoint::tcp_endpoint(const std::string& name):
 			index + 1, std::string::npos);
 	}
 
+	long long bufsize = 0x10000;
 	if (std::optional<std::string> query = this->name().query()) {
 		query_string params(*query);
 		_retry = params.find<long>("retry").value_or(_retry);
 		_diode = params.find<bool>("diode").value_or(_diode);
+		_delta = params.find<bool>("delta").value_or(_delta);
+		_templates = params.find<bool>("templates").value_or(_templates);
+		_dictionary = params.find<std::vector<std::string>>("dictionary")
+			.value_or(_dictionary);
+		bufsize = params.find<long long>("bufsize").value_or(bufsize);
 	}
+	if (bufsize <= 0) {
+		throw endpoint_error("bufsize must be greater than zero");
+	}
+	_pool = std::make_unique<buffer_pool>(bufsize);
 }
 
 std::unique_ptr<session_listener> tcp_endpoint::make_session_listener() {
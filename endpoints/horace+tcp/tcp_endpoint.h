@@ -7,7 +7,9 @@
 #define LIBHOLMES_HORACE_TCP_ENDPOINT
 
 #include <string>
+#include <vector>
 
+#include "horace/buffer_pool.h"
 #include "horace/endpoint.h"
 #include "horace/session_listener_endpoint.h"
 #include "horace/session_writer_endpoint.h"
@@ -31,6 +33,19 @@ private:
 
 	/** True for unidirectional operation, false for bidirectional. */
 	bool _diode;
+
+	/** True if records should be delta encoded, otherwise false. */
+	bool _delta;
+
+	/** True if record templates should be used, otherwise false. */
+	bool _templates;
+
+	/** The labels of the attributes to which a string dictionary
+	 * should be applied. */
+	std::vector<std::string> _dictionary;
+
+	/** A pool of buffers for reading and writing records. */
+	std::unique_ptr<buffer_pool> _pool;
 public:
 	/** Construct TCP endpoint.
 	 * @param name the name of this endpoint
@@ -65,6 +80,35 @@ public:
 		return _diode;
 	}
 
+	/** Check whether records should be delta encoded.
+	 * @return true to delta encode, otherwise false
+	 */
+	bool delta() const {
+		return _delta;
+	}
+
+	/** Check whether record templates should be used.
+	 * @return true to use record templates, otherwise false
+	 */
+	bool templates() const {
+		return _templates;
+	}
+
+	/** Get the labels of the attributes to which a string dictionary
+	 * should be applied.
+	 * @return the attribute labels, or an empty list if none
+	 */
+	const std::vector<std::string>& dictionary() const {
+		return _dictionary;
+	}
+
+	/** Get the pool of buffers for reading and writing records.
+	 * @return the buffer pool
+	 */
+	buffer_pool& pool() const {
+		return *_pool;
+	}
+
 	virtual std::unique_ptr<session_listener> make_session_listener();
 	virtual std::unique_ptr<session_writer> make_session_writer(
 		const std::string& srcid);
@@ -17,7 +17,7 @@ tcp_session_reader::tcp_session_reader(tcp_endpoint& src_ep,
 	socket_descriptor&& fd):
 	_src_ep(&src_ep),
 	_fd(std::move(fd)),
-	_fdor(_fd),
+	_fdor(_fd, src_ep.pool()),
 	_fdow(_fd) {
 
 	_fd.interruptible(true);
@@ -22,7 +22,19 @@ namespace horace {
 tcp_session_writer::tcp_session_writer(tcp_endpoint& dst_ep,
 	const std::string& srcid):
 	_dst_ep(&dst_ep),
-	simple_session_writer(srcid) {}
+	simple_session_writer(srcid) {
+
+	if (!_dst_ep->dictionary().empty()) {
+		_senc = std::make_unique<dictionary_encoder>(
+			_dst_ep->dictionary());
+	}
+	if (_dst_ep->delta()) {
+		_denc = std::make_unique<delta_encoder>();
+	}
+	if (_dst_ep->templates()) {
+		_tenc = std::make_unique<template_encoder>();
+	}
+}
 
 void tcp_session_writer::_open() {
 	// Look up the hostname and portname.
@@ -65,7 +77,7 @@ void tcp_session_writer::_open() {
 		}
 	}
 
-	_fdow = file_octet_writer(_fd);
+	_fdow = file_octet_writer(_fd, _dst_ep->pool());
 	_fdor = file_octet_reader(_fd);
 }
 
@@ -77,7 +89,7 @@ void tcp_session_writer::handle_session_start(const record& srec) {
 	if (!_fd) {
 		_open();
 	}
-	srec.write(_fdow);
+	_write(srec);
 }
 
 void tcp_session_writer::handle_session_end(const record& erec) {
@@ -87,7 +99,6 @@ void tcp_session_writer::handle_session_end(const record& erec) {
 void tcp_session_writer::handle_sync(const record& crec) {
 	if (!_dst_ep->diode()) {
 		crec.write(_fdow);
-		simple_session_writer::read();
 	}
 }
 
@@ -100,7 +111,13 @@ void tcp_session_writer::handle_control(const record& rec) {
 }
 
 void tcp_session_writer::handle_event(const record& rec) {
-	rec.write(_fdow);
+	_write(rec);
+}
+
+void tcp_session_writer::flush() {
+	if (_fd) {
+		_fdow.flush();
+	}
 }
 
 bool tcp_session_writer::readable() {
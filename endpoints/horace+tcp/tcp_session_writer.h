@@ -11,6 +11,9 @@
 #include "horace/file_octet_reader.h"
 #include "horace/record.h"
 #include "horace/session_context.h"
+#include "horace/dictionary_encoder.h"
+#include "horace/delta_encoder.h"
+#include "horace/template_encoder.h"
 #include "horace/simple_session_writer.h"
 
 namespace horace {
@@ -36,6 +39,32 @@ private:
 	/** The current session context. */
 	session_context _session;
 
+	/** An encoder for applying a string dictionary, or null if a
+	 * string dictionary is not in use. */
+	std::unique_ptr<dictionary_encoder> _senc;
+
+	/** An encoder for delta encoding records, or null if delta
+	 * encoding is not in use. */
+	std::unique_ptr<delta_encoder> _denc;
+
+	/** An encoder for applying record templates, or null if record
+	 * templates are not in use. */
+	std::unique_ptr<template_encoder> _tenc;
+
+	/** Write a session or event record to the connection, encoding
+	 * it if required.
+	 * @param rec the record to be written
+	 */
+	void _write(const record& rec) {
+		const record& srec = (_senc) ? _senc->encode(rec) : rec;
+		const record& drec = (_denc) ? _denc->encode(srec) : srec;
+		if (_tenc) {
+			_tenc->encode(drec).write(_fdow);
+		} else {
+			drec.write(_fdow);
+		}
+	}
+
 	/** Open a connection. */
 	void _open();
 protected:
@@ -55,6 +84,7 @@ public:
 
 	virtual bool writable();
 //	virtual void write(const record& rec);
+	virtual void flush();
 	virtual bool readable();
 	virtual std::unique_ptr<record> read();
 };
@@ -12,6 +12,7 @@
 #include "horace/signed_integer_attribute.h"
 #include "horace/binary_ref_attribute.h"
 #include "horace/string_attribute.h"
+#include "horace/string_ref_attribute.h"
 #include "horace/timestamp_attribute.h"
 #include "horace/boolean_attribute.h"
 #include "horace/unrecognised_attribute.h"
@@ -39,6 +40,8 @@ void mongodb_session_writer::_append_bson(bson_t& bson, const std::string& attr_
 		bson_append_int64(&bson, attr_label.c_str(), -1, _attr->content());
 	} else if (const string_attribute* _attr = dynamic_cast<const string_attribute*>(&attr)) {
 		bson_append_utf8(&bson, attr_label.c_str(), -1, _attr->content().c_str(), -1);
+	} else if (const string_ref_attribute* _attr = dynamic_cast<const string_ref_attribute*>(&attr)) {
+		bson_append_utf8(&bson, attr_label.c_str(), -1, _attr->content().data(), _attr->content().length());
 	} else if (const binary_ref_attribute* _attr = dynamic_cast<const binary_ref_attribute*>(&attr)) {
 		bson_append_binary(&bson, attr_label.c_str(), -1, BSON_SUBTYPE_BINARY,
 			reinterpret_cast<const uint8_t*>(_attr->content()), _attr->length());
@@ -125,8 +128,7 @@ void mongodb_session_writer::_write_bulk(int channel_id,
 }
 
 void mongodb_session_writer::handle_session_start(const record& srec) {
-	_session_ts = srec.find_one<timestamp_attribute>(
-		attrid_ts).content();
+	_session_ts = srec.find_ts().content();
 	_session = session_context();
 
 	bson_t bson_session;
@@ -198,8 +200,7 @@ void mongodb_session_writer::handle_session_start(const record& srec) {
 }
 
 void mongodb_session_writer::handle_session_end(const record& erec) {
-        struct timespec ts = erec.find_one<timestamp_attribute>(
-                attrid_ts).content();
+        struct timespec ts = erec.find_ts().content();
 
 	bson_t bson_filter;
 	bson_init(&bson_filter);
@@ -237,8 +238,7 @@ void mongodb_session_writer::handle_sync(const record& crec) {
 }
 
 void mongodb_session_writer::handle_event(const record& rec) {
-	uint64_t seqnum = rec.find_one<unsigned_integer_attribute>(
-		attrid_seqnum).content();
+	uint64_t seqnum = rec.find_seqnum().content();
 
 	// Construct event with _id field (which must always be present).
 	bson_t bson_event;
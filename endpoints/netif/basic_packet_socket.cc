@@ -7,6 +7,9 @@
 #include <net/ethernet.h>
 #include <sys/socket.h>
 #include "linux/if_packet.h"
+#include "linux/net_tstamp.h"
+
+#include "horace/stats_group.h"
 
 #include "interface.h"
 #include "basic_packet_socket.h"
@@ -14,7 +17,10 @@
 namespace horace {
 
 basic_packet_socket::basic_packet_socket():
-	socket_descriptor(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL)) {
+	socket_descriptor(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL)),
+	_tstamp(tstamp_sw),
+	_packets_counter(0),
+	_drops_counter(0) {
 
 	interruptible(true);
 	if (lsmonitor) {
@@ -37,6 +43,15 @@ void basic_packet_socket::_update_stats() {
 	getsockopt(SOL_PACKET, PACKET_STATISTICS, stats);
 	_packets += stats.tp_packets - stats.tp_drops;
 	_drops += stats.tp_drops;
+	if (_packets_counter) {
+		_packets_counter->add(stats.tp_packets - stats.tp_drops);
+		_drops_counter->add(stats.tp_drops);
+	}
+}
+
+void basic_packet_socket::request_hw_timestamps() {
+	setsockopt<int>(SOL_PACKET, PACKET_TIMESTAMP,
+		SOF_TIMESTAMPING_RAW_HARDWARE);
 }
 
 void basic_packet_socket::measure() {
@@ -59,6 +74,19 @@ void basic_packet_socket::set_promiscuous(const interface& iface) {
 	setsockopt(SOL_PACKET, PACKET_ADD_MEMBERSHIP, mreq);
 }
 
+void basic_packet_socket::tstamp(int tstamp) {
+	if (tstamp != tstamp_sw) {
+		request_hw_timestamps();
+	}
+	_tstamp = tstamp;
+}
+
+void basic_packet_socket::attach_stats(stats_group& stats) {
+	std::unique_lock lock(_mutex);
+	_packets_counter = &stats.counter("packets");
+	_drops_counter = &stats.counter("drops");
+}
+
 unsigned int basic_packet_socket::drops() {
 	_update_stats();
 	std::unique_lock lock(_mutex);
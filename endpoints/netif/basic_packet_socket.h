@@ -15,8 +15,9 @@
 namespace horace {
 
 class record;
-
 class interface;
+class stats_counter;
+class stats_group;
 
 /** An abstract base class to represent an AF_PACKET socket.
  * This class does not by itself provide the means to read packets from the
@@ -26,6 +27,19 @@ class interface;
 class basic_packet_socket:
 	public socket_descriptor,
 	public leap_second_monitor::measurable {
+public:
+	/** Software timestamps, generated by the kernel on receipt. */
+	static const int tstamp_sw = 0;
+
+	/** Hardware timestamps, generated by the network interface
+	 * controller using a PTP hardware clock which is synchronised to
+	 * the system clock (for example, by phc2sys). */
+	static const int tstamp_hw = 1;
+
+	/** Hardware timestamps, generated by the network interface
+	 * controller using a PTP hardware clock, but otherwise left
+	 * uncorrected. */
+	static const int tstamp_raw = 2;
 private:
 	/** A mutex protecting _packets and _drops. */
 	std::mutex _mutex;
@@ -39,11 +53,45 @@ private:
 	/** The number of dropped packets since last checked. */
 	unsigned int _drops;
 
+	/** The timestamp source. */
+	int _tstamp;
+
+	/** A counter for recording packets received, or 0 if none. */
+	stats_counter* _packets_counter;
+
+	/** A counter for recording dropped packets, or 0 if none. */
+	stats_counter* _drops_counter;
+
 	/** Update _packets and _drops. */
 	void _update_stats();
 protected:
 	/** A leap second corrector for this socket. */
 	leap_second_corrector lsc;
+
+	/** Request hardware timestamps from the socket.
+	 * The default behaviour, which is suitable for ring buffers,
+	 * is to set the PACKET_TIMESTAMP socket option.
+	 */
+	virtual void request_hw_timestamps();
+
+	/** Correct a timestamp for leap seconds, if appropriate.
+	 * Raw hardware timestamps are not derived from the system clock,
+	 * and are therefore left unaltered. (They must nevertheless be
+	 * presented to the leap second corrector, since it counts the
+	 * timestamps which it has seen.)
+	 * @param ts the timestamp to be corrected
+	 * @param hw true if generated by hardware, otherwise false
+	 */
+	void correct(struct timespec& ts, bool hw) {
+		if (detect_leap_seconds) {
+			if (hw && (_tstamp == tstamp_raw)) {
+				struct timespec raw_ts = ts;
+				lsc.correct(raw_ts);
+			} else {
+				lsc.correct(ts);
+			}
+		}
+	}
 public:
 	/** Open basic packet socket. */
 	basic_packet_socket();
@@ -72,6 +120,28 @@ public:
 	 */
 	void set_promiscuous(const interface& iface);
 
+	/** Get the timestamp source.
+	 * @return the timestamp source
+	 */
+	int tstamp() const {
+		return _tstamp;
+	}
+
+	/** Select the timestamp source.
+	 * Hardware timestamps must already have been enabled on the
+	 * network interface controller. Packets for which a hardware
+	 * timestamp is unavailable will fall back to a software timestamp.
+	 * @param tstamp the required timestamp source
+	 */
+	void tstamp(int tstamp);
+
+	/** Attach a statistics group to this socket.
+	 * Packets received and dropped will be counted within the group
+	 * whenever the kernel statistics for the socket are read.
+	 * @param stats the statistics group
+	 */
+	void attach_stats(stats_group& stats);
+
 	/** Get the number of dropped packets.
 	 * @return the number of dropped packets since previous call
 	 */
@@ -3,10 +3,14 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <cerrno>
+
 #include <sys/ioctl.h>
 #include <net/if.h>
 #include <net/if_arp.h>
 #include <net/ethernet.h>
+#include <linux/sockios.h>
+#include <linux/net_tstamp.h>
 
 #include "horace/libc_error.h"
 #include "horace/socket_descriptor.h"
@@ -57,4 +61,51 @@ interface::interface(const std::string& ifname):
 	}
 }
 
+void interface::enable_hw_timestamps() const {
+	if (isany()) {
+		throw libc_error(ENODEV);
+	}
+
+	// The ioctl call below requires an open socket descriptor.
+	socket_descriptor fd(AF_INET, SOCK_DGRAM, 0);
+
+	struct ifreq ifr = {0};
+	if (!if_indextoname(_ifindex, ifr.ifr_name)) {
+		throw libc_error();
+	}
+
+	// Read the current configuration, since the hardware clock may
+	// be shared with other programs (such as ptp4l) which rely on
+	// transmit timestamps or on a particular receive filter. Drivers
+	// which do not support reading the configuration are assumed to
+	// have timestamping disabled.
+	struct hwtstamp_config config = {0};
+	ifr.ifr_data = reinterpret_cast<char*>(&config);
+	if (ioctl(fd, SIOCGHWTSTAMP, &ifr) == -1) {
+		if (errno != EOPNOTSUPP && errno != EINVAL) {
+			throw libc_error();
+		}
+		config = {0};
+		config.tx_type = HWTSTAMP_TX_OFF;
+		config.rx_filter = HWTSTAMP_FILTER_NONE;
+	}
+
+	// Widen the receive filter to match all inbound packets, leaving
+	// the transmit configuration unchanged.
+	if (config.rx_filter != HWTSTAMP_FILTER_ALL) {
+		config.rx_filter = HWTSTAMP_FILTER_ALL;
+		if (ioctl(fd, SIOCSHWTSTAMP, &ifr) == -1) {
+			throw libc_error();
+		}
+	}
+
+	// The driver is permitted to select a different filter from the
+	// one requested. Packets which are not matched will still receive
+	// a software timestamp, so that is acceptable provided that the
+	// filter is not disabled entirely.
+	if (config.rx_filter == HWTSTAMP_FILTER_NONE) {
+		throw libc_error(EOPNOTSUPP);
+	}
+}
+
 } /* namespace horace */
@@ -76,6 +76,16 @@ public:
 	const std::basic_string<unsigned char>& hwaddr() const {
 		return _hwaddr;
 	}
+
+	/** Enable hardware timestamping of received packets.
+	 * This configures the network interface controller to timestamp
+	 * all inbound packets using its PTP hardware clock. The transmit
+	 * configuration is left unchanged, so that other users of the
+	 * clock are not disturbed. An exception
+	 * is thrown if that is not possible, which will be the case for
+	 * virtual interfaces such as veth.
+	 */
+	void enable_hw_timestamps() const;
 };
 
 } /* namespace horace */
@@ -21,13 +21,19 @@ netif_endpoint::netif_endpoint(const std::string& name):
 	endpoint(name),
 	_snaplen(0x40000),
 	_capacity(0x1000000),
-	_promiscuous(false) {
+	_promiscuous(false),
+	_tstamp("sw") {
 
 	std::string ifname = netifname();
 	if (!ifname.empty()) {
 		_if = interface(ifname);
 	}
 
+	long long block_size = 0;
+	long long block_nr = 0;
+	long retire_tov = 0;
+	bool autotune = false;
+
 	std::optional<std::string> query = this->name().query();
 	if (query) {
 		query_string params(*query);
@@ -36,6 +42,24 @@ netif_endpoint::netif_endpoint(const std::string& name):
 		_capacity = params.find<long long>("capacity").value_or(_capacity);
 		_promiscuous = params.find<bool>("promiscuous").
 			value_or(_promiscuous);
+		_tstamp = params.find<std::string>("tstamp").value_or(_tstamp);
+		block_size = params.find<long long>("block_size").
+			value_or(block_size);
+		block_nr = params.find<long long>("block_nr").
+			value_or(block_nr);
+		retire_tov = params.find<long>("retire_tov").
+			value_or(retire_tov);
+		autotune = params.find<bool>("autotune").value_or(autotune);
+	}
+
+	if ((block_size < 0) || (block_nr < 0) || (retire_tov < 0)) {
+		throw endpoint_error("invalid ring buffer geometry");
+	}
+	_tuner = std::make_unique<ring_tuner>(block_size, block_nr,
+		retire_tov, autotune);
+
+	if ((_tstamp != "sw") && (_tstamp != "hw") && (_tstamp != "raw")) {
+		throw endpoint_error("unrecognised timestamp source");
 	}
 }
 
@@ -50,7 +74,8 @@ std::unique_ptr<basic_packet_socket> netif_endpoint::make_basic_packet_socket(
 
 	if (_method.empty()) {
 		try {
-			return std::make_unique<ring_buffer_v3>(builder, snaplen(), capacity());
+			return std::make_unique<ring_buffer_v3>(builder,
+				snaplen(), capacity(), *_tuner);
 		} catch (std::exception& ex) {}
 		try {
 			return std::make_unique<ring_buffer_v2>(builder, snaplen(), capacity());
@@ -60,7 +85,8 @@ std::unique_ptr<basic_packet_socket> netif_endpoint::make_basic_packet_socket(
 		} catch (std::exception& ex) {}
 		return std::make_unique<packet_socket>(builder, snaplen(), capacity());
 	} else if (_method == "ringv3") {
-		return std::make_unique<ring_buffer_v3>(builder, snaplen(), capacity());
+		return std::make_unique<ring_buffer_v3>(builder,
+			snaplen(), capacity(), *_tuner);
 	} else if (_method == "ringv2") {
 		return std::make_unique<ring_buffer_v2>(builder, snaplen(), capacity());
 	} else if (_method == "ringv1") {
@@ -10,6 +10,7 @@
 #include "horace/event_reader_endpoint.h"
 
 #include "interface.h"
+#include "ring_tuner.h"
 
 namespace horace {
 
@@ -32,6 +33,15 @@ private:
 
 	/** True if promiscuous mode requested, otherwise false. */
 	bool _promiscuous;
+
+	/** The requested timestamp source. */
+	std::string _tstamp;
+
+	/** A tuner for choosing the geometry of TPACKET_V3 ring buffers.
+	 * This persists for the lifetime of the endpoint, so that the usage
+	 * of one ring buffer can inform the geometry of the next.
+	 */
+	std::unique_ptr<ring_tuner> _tuner;
 public:
 	/** Construct network interface endpoint.
 	 * @param name the name of this endpoint
@@ -80,6 +90,13 @@ public:
 		return _promiscuous;
 	}
 
+	/** Get the requested timestamp source.
+	 * @return the timestamp source (sw, hw or raw)
+	 */
+	const std::string& tstamp() const {
+		return _tstamp;
+	}
+
 	virtual std::unique_ptr<event_reader> make_event_reader(
 		session_builder& session);
 
@@ -26,7 +26,26 @@ class record;
 
 netif_event_reader::netif_event_reader(const netif_endpoint& ep,
 	session_builder& session):
-	_ep(&ep) {
+	_ep(&ep),
+	_stats("netif." + (ep.netif().isany() ?
+		std::string("any") : ep.netifname())) {
+
+	// Enable hardware timestamps if they have been requested. If
+	// that is not possible then fall back to software timestamps,
+	// so that capture can proceed (for example, from a veth).
+	std::string tstamp = ep.tstamp();
+	if (tstamp != "sw") {
+		try {
+			ep.netif().enable_hw_timestamps();
+		} catch (std::exception& ex) {
+			if (log->enabled(logger::log_warning)) {
+				log_message msg(*log, logger::log_warning);
+				msg << "hardware timestamps unavailable ("
+					<< ex.what() << "), using software";
+			}
+			tstamp = "sw";
+		}
+	}
 
 	attribute_list attrs;
 	attrs.insert(std::make_unique<unsigned_integer_attribute>(
@@ -44,15 +63,25 @@ netif_event_reader::netif_event_reader(const netif_endpoint& ep,
 	attrs.insert(std::make_unique<unsigned_integer_attribute>(
 		session.define_attribute("if_linktype", type_unsigned_integer),
 		_ep->netif().linktype()));
+	attrs.insert(std::make_unique<string_attribute>(
+		session.define_attribute("if_tstamp", type_string),
+		tstamp));
 	_channel = session.define_channel("packets", std::move(attrs));
 
 	_builder = std::make_unique<packet_record_builder>(session, _channel);
 	_sock = ep.make_basic_packet_socket(*_builder);
+	_sock->attach_stats(_stats);
 
 	if (!ep.netif().isany()) {
 		_sock->bind(ep.netif());
 	}
 
+	if (tstamp == "hw") {
+		_sock->tstamp(basic_packet_socket::tstamp_hw);
+	} else if (tstamp == "raw") {
+		_sock->tstamp(basic_packet_socket::tstamp_raw);
+	}
+
 	if (log->enabled(logger::log_notice)) {
 		log_message msg(*log, logger::log_notice);
 		msg << "capturing on ";
@@ -62,6 +91,7 @@ netif_event_reader::netif_event_reader(const netif_endpoint& ep,
 			msg << "interface " << ep.netifname();
 		}
 		msg << " with " << _sock->method() << " socket";
+		msg << " (" << tstamp << " timestamps)";
 	}
 
 	if (ep.promiscuous()) {
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "horace/event_reader.h"
+#include "horace/stats_group.h"
 
 namespace horace {
 
@@ -30,6 +31,9 @@ private:
 	/** A builder for making packet records. */
 	std::unique_ptr<packet_record_builder> _builder;
 
+	/** Statistics for the network interface. */
+	stats_group _stats;
+
 	/** The socket for capturing packets. */
 	std::unique_ptr<basic_packet_socket> _sock;
 public:
@@ -4,6 +4,12 @@
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
 #include <climits>
+#include <ctime>
+
+#include <sys/socket.h>
+
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
 
 #include "horace/endpoint_error.h"
 #include "horace/logger.h"
@@ -35,6 +41,7 @@ packet_socket::packet_socket(packet_record_builder& builder, size_t snaplen,
 	_snaplen = snaplen;
 	_buffer = std::make_unique<char[]>(snaplen);
 	size_t control_size = CMSG_SPACE(sizeof(struct timespec)) +
+		CMSG_SPACE(sizeof(struct scm_timestamping)) +
 		CMSG_SPACE(sizeof(uint32_t));
 	_control = std::make_unique<char[]>(control_size);
 	_iov[0].iov_base = _buffer.get();
@@ -55,6 +62,13 @@ packet_socket::packet_socket(packet_record_builder& builder, size_t snaplen,
 	}
 }
 
+void packet_socket::request_hw_timestamps() {
+	// Software timestamps continue to be provided by SO_TIMESTAMPNS,
+	// so only hardware timestamps need be requested here.
+	setsockopt<int>(SOL_SOCKET, SO_TIMESTAMPING,
+		SOF_TIMESTAMPING_RX_HARDWARE|SOF_TIMESTAMPING_RAW_HARDWARE);
+}
+
 const record& packet_socket::read() {
 	// If there are any records remaining from the last call to this
 	// function then return the next one.
@@ -74,9 +88,12 @@ const record& packet_socket::read() {
 	size_t pkt_snaplen = (message.msg_flags & MSG_TRUNC) ?
 		_snaplen : pkt_origlen;
 
-	// Scan the control buffer, extracting the timestamp (which should
-	// always be present) and the drop count (which may be present).
+	// Scan the control buffer, extracting the software timestamp
+	// (which should always be present), the hardware timestamp (which
+	// may be present if requested) and the drop count (which may be
+	// present).
 	struct timespec* ts = 0;
+	struct timespec* hwts = 0;
 	uint32_t drop_diff = 0;
 	for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg;
 		cmsg = CMSG_NXTHDR(&message, cmsg)) {
@@ -84,6 +101,15 @@ const record& packet_socket::read() {
 		if (cmsg->cmsg_level == SOL_SOCKET) {
 			if (cmsg->cmsg_type == SO_TIMESTAMPNS) {
 				ts = reinterpret_cast<struct timespec*>(CMSG_DATA(cmsg));
+			} else if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+				// The raw hardware timestamp is the third of
+				// the three provided, and is zero if absent.
+				struct scm_timestamping* tss =
+					reinterpret_cast<struct scm_timestamping*>(
+					CMSG_DATA(cmsg));
+				if (tss->ts[2].tv_sec || tss->ts[2].tv_nsec) {
+					hwts = &tss->ts[2];
+				}
 			} else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
 				uint32_t new_drop_count =
 					*reinterpret_cast<uint32_t*>(CMSG_DATA(cmsg));
@@ -93,10 +119,13 @@ const record& packet_socket::read() {
 		}
 	}
 
-        // Correct timestamp.
-        if (detect_leap_seconds) {
-                lsc.correct(*ts);
-        }
+	// Prefer the hardware timestamp if there is one, then correct.
+	if (hwts) {
+		ts = hwts;
+	}
+	if (ts) {
+		correct(*ts, hwts != 0);
+	}
 
 	_builder->build_packet(ts, _buffer.get(), pkt_snaplen, pkt_origlen,
 		drop_diff);
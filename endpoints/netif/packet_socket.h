@@ -47,6 +47,8 @@ private:
 
 	/** A builder for making packet records. */
 	packet_record_builder* _builder;
+protected:
+	virtual void request_hw_timestamps();
 public:
 	/** Open packet socket.
 	 * @param builder a builder for making packet records
@@ -104,9 +104,7 @@ const record& ring_buffer_v1::read() {
 	struct timespec ts;
 	ts.tv_sec = tphdr->tp_sec;
 	ts.tv_nsec = tphdr->tp_usec * 1000;
-	if (detect_leap_seconds) {
-		lsc.correct(ts);
-	}
+	correct(ts, tphdr->tp_status & TP_STATUS_TS_RAW_HARDWARE);
 
 	// Note that whilst the ring buffer as a whole is volatile, the
 	// packet content should be constant for the lifetime of the
@@ -20,32 +20,21 @@
 namespace horace {
 
 ring_buffer_v3::ring_buffer_v3(packet_record_builder& builder, size_t snaplen,
-	size_t buffer_size):
-	_builder(&builder),
+	size_t buffer_size, ring_tuner& tuner):
 	_tpreq({0}),
 	_block_idx(0),
 	_frame_idx(0),
 	_last_block(0),
 	_block(0),
-	_frame(0) {
+	_frame(0),
+	_builder(&builder),
+	_tuner(&tuner) {
 
 	// Select ring buffer protocol version.
 	setsockopt<int>(SOL_PACKET, PACKET_VERSION, TPACKET_V3);
 
-	// Frame size is arbitrary for TPACKET_V3, but set based on snaplen
-	// as per previous protocol versions to provide basis for setting
-	// block size.
-	_tpreq.tp_frame_size = TPACKET_ALIGN(TPACKET3_HDRLEN + ETH_HLEN) +
-		TPACKET_ALIGN(snaplen - ETH_HLEN);
-	_tpreq.tp_block_size = sysconf(_SC_PAGESIZE);
-	while (_tpreq.tp_block_size < _tpreq.tp_frame_size * 3) {
-		_tpreq.tp_block_size <<= 1;
-	}
-	size_t frames_per_block = _tpreq.tp_block_size / _tpreq.tp_frame_size;
-	_tpreq.tp_block_nr = buffer_size / _tpreq.tp_block_size;
-	_tpreq.tp_frame_nr = _tpreq.tp_block_nr * frames_per_block;
-	_tpreq.tp_retire_blk_tov = 60;
-	_tpreq.tp_feature_req_word = 0;
+	// Choose the ring buffer geometry.
+	_tpreq = _tuner->geometry(snaplen, buffer_size);
 
 	// Check that the ring buffer contains a non-zero number of frames
 	// (and thus also a non-zero number of blocks, and frames per block).
@@ -74,7 +63,23 @@ ring_buffer_v3::ring_buffer_v3(packet_record_builder& builder, size_t snaplen,
 			"bs=" << _tpreq.tp_block_size << ", " <<
 			"fs=" << _tpreq.tp_frame_size << ", " <<
 			"nb=" << _tpreq.tp_block_nr << ", " <<
-			"nf=" << _tpreq.tp_frame_nr << ")";
+			"nf=" << _tpreq.tp_frame_nr << ", " <<
+			"tov=" << _tpreq.tp_retire_blk_tov << ")";
+	}
+}
+
+ring_buffer_v3::~ring_buffer_v3() {
+	munmap(const_cast<char*>(_rx_ring),
+		_tpreq.tp_block_nr * _tpreq.tp_block_size);
+	_tuner->observe(_usage);
+
+	if (log->enabled(logger::log_info)) {
+		log_message msg(*log, logger::log_info);
+		msg << "ring buffer v3 usage (" <<
+			"frames=" << _usage.frame_count() << ", " <<
+			"blocks=" << _usage.block_count() << ", " <<
+			"timeouts=" << _usage.timeout_count() << ", " <<
+			"p99=" << _usage.frame_length(0.99) << ")";
 	}
 }
 
@@ -95,6 +100,10 @@ const record& ring_buffer_v3::read() {
 			wait(POLLIN);
 		}
 
+		// Record whether the block was retired due to timeout.
+		_usage.add_block(_block->hdr.bh1.block_status &
+			TP_STATUS_BLK_TMO);
+
 		// Confirm that the block is non-empty (which it presumably ought to be).
 		if (_block->hdr.bh1.num_pkts == 0) {
 			throw std::runtime_error("encountered empty ring buffer block");
@@ -126,9 +135,7 @@ const record& ring_buffer_v3::read() {
 	struct timespec ts;
 	ts.tv_sec = _frame->tp_sec;
 	ts.tv_nsec = _frame->tp_nsec;
-	if (detect_leap_seconds) {
-		lsc.correct(ts);
-	}
+	correct(ts, _frame->tp_status & TP_STATUS_TS_RAW_HARDWARE);
 
 	// Extract remaining data from frame buffer.
 	// Note that whilst the ring buffer as a whole is volatile, the
@@ -137,6 +144,7 @@ const record& ring_buffer_v3::read() {
 	const char* content = ((const char*)_frame) + _frame->tp_mac;
 	size_t pkt_origlen = _frame->tp_len;
 	size_t pkt_snaplen = _frame->tp_snaplen;
+	_usage.add_frame(TPACKET_ALIGN(_frame->tp_mac + pkt_snaplen), ts);
 
 	// Advance to next frame.
 	_frame_idx += 1;
@@ -9,6 +9,7 @@
 #include <linux/if_packet.h>
 
 #include "basic_packet_socket.h"
+#include "ring_tuner.h"
 
 namespace horace {
 
@@ -42,14 +43,26 @@ private:
 
 	/** A builder for making packet records. */
 	packet_record_builder* _builder;
+
+	/** A tuner for choosing the ring buffer geometry. */
+	ring_tuner* _tuner;
+
+	/** The usage of this ring buffer. */
+	ring_usage _usage;
 public:
 	/** Create an AF_PACKET socket with a ring buffer.
 	 * @param builder a builder for making packet records
 	 * @param snaplen the required link layer snaplen, in octets
 	 * @param buffer_size the required ring buffer size, in octets
+	 * @param tuner a tuner for choosing the ring buffer geometry
 	 */
 	ring_buffer_v3(packet_record_builder& builder, size_t snaplen,
-		size_t buffer_size);
+		size_t buffer_size, ring_tuner& tuner);
+
+	/** Destroy ring buffer.
+	 * The usage of the ring buffer is reported to the tuner.
+	 */
+	virtual ~ring_buffer_v3();
 
 	virtual const record& read();
 	virtual const std::string& method() const;
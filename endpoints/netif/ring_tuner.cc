@@ -0,0 +1,187 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+
+#include <unistd.h>
+#include <net/ethernet.h>
+
+#include "horace/endpoint_error.h"
+
+#include "ring_tuner.h"
+
+namespace horace {
+
+namespace {
+
+/** The target latency when tuning automatically, in milliseconds.
+ * This is used both as the retirement timeout, and as the time in which
+ * a block should be filled at the observed data rate.
+ */
+const unsigned int target_latency = 10;
+
+/** The minimum number of blocks when tuning automatically. */
+const size_t min_blocks = 8;
+
+/** The minimum number of frames per block. */
+const size_t min_frames = 3;
+
+/** Test whether one timespec is earlier than another.
+ * @param lhs the left hand side
+ * @param rhs the right hand side
+ * @return true if lhs is earlier than rhs, otherwise false
+ */
+bool earlier(const struct timespec& lhs, const struct timespec& rhs) {
+	return (lhs.tv_sec < rhs.tv_sec) ||
+		((lhs.tv_sec == rhs.tv_sec) && (lhs.tv_nsec < rhs.tv_nsec));
+}
+
+} /* anonymous namespace */
+
+ring_usage::ring_usage():
+	_frames{0},
+	_frame_count(0),
+	_octet_count(0),
+	_block_count(0),
+	_timeout_count(0),
+	_first_ts{0},
+	_last_ts{0} {}
+
+ring_usage& ring_usage::operator+=(const ring_usage& that) {
+	if (that._frame_count) {
+		if (!_frame_count || earlier(that._first_ts, _first_ts)) {
+			_first_ts = that._first_ts;
+		}
+		if (!_frame_count || earlier(_last_ts, that._last_ts)) {
+			_last_ts = that._last_ts;
+		}
+	}
+	for (int i = 0; i != bucket_count; ++i) {
+		_frames[i] += that._frames[i];
+	}
+	_frame_count += that._frame_count;
+	_octet_count += that._octet_count;
+	_block_count += that._block_count;
+	_timeout_count += that._timeout_count;
+	return *this;
+}
+
+size_t ring_usage::frame_length(double fraction) const {
+	uint64_t required = fraction * _frame_count;
+	uint64_t count = 0;
+	for (int i = 0; i != bucket_count; ++i) {
+		count += _frames[i];
+		if (count && (count >= required)) {
+			return size_t(1) << i;
+		}
+	}
+	return 0;
+}
+
+double ring_usage::octet_rate() const {
+	double elapsed = (_last_ts.tv_sec - _first_ts.tv_sec) +
+		(_last_ts.tv_nsec - _first_ts.tv_nsec) * 1e-9;
+	if (elapsed <= 0) {
+		return 0;
+	}
+	return _octet_count / elapsed;
+}
+
+ring_tuner::ring_tuner(size_t block_size, size_t block_nr,
+	unsigned int retire_tov, bool autotune):
+	_block_size(block_size),
+	_block_nr(block_nr),
+	_retire_tov(retire_tov),
+	_autotune(autotune) {
+
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	if (_block_size % page_size) {
+		throw endpoint_error(
+			"block size must be a multiple of the page size");
+	}
+}
+
+struct tpacket_req3 ring_tuner::geometry(size_t snaplen,
+	size_t buffer_size) {
+
+	ring_usage usage;
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		usage = _usage;
+	}
+
+	// Frame size is arbitrary for TPACKET_V3, but set based on snaplen
+	// as per previous protocol versions to provide basis for setting
+	// block size.
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t frame_size = TPACKET_ALIGN(TPACKET3_HDRLEN + ETH_HLEN) +
+		TPACKET_ALIGN(snaplen - ETH_HLEN);
+
+	size_t block_size = _block_size;
+	if (block_size) {
+		// Use block size as specified.
+	} else if (!_autotune) {
+		// Use the same rule as previous protocol versions: a
+		// power-of-two multiple of the page size, large enough to
+		// hold at least 3 frames.
+		block_size = page_size;
+		while (block_size < frame_size * min_frames) {
+			block_size <<= 1;
+		}
+	} else if (!usage.frame_count()) {
+		// With no usage to go on, choose the smallest block which
+		// can hold a full-length frame, in order to minimise
+		// latency at low data rates.
+		block_size = page_size;
+		while (block_size < frame_size) {
+			block_size <<= 1;
+		}
+	} else {
+		// Otherwise, choose a block which can hold at least 3 of
+		// the longest frames observed, and which would be filled
+		// within the target latency at the observed data rate,
+		// provided this leaves enough blocks.
+		size_t max_frame = std::min(usage.frame_length(1.0),
+			frame_size);
+		size_t fill_size = usage.octet_rate() * target_latency / 1000;
+		block_size = page_size;
+		while (((block_size < max_frame * min_frames) ||
+			(block_size < fill_size)) &&
+			(block_size * 2 * min_blocks <= buffer_size)) {
+
+			block_size <<= 1;
+		}
+		while (block_size < max_frame) {
+			block_size <<= 1;
+		}
+	}
+
+	// Packets which do not fit within a block are truncated by the
+	// kernel, so there is no purpose in the frame size exceeding the
+	// block size.
+	if (frame_size > block_size) {
+		frame_size = block_size;
+	}
+
+	struct tpacket_req3 req = {0};
+	req.tp_block_size = block_size;
+	req.tp_frame_size = frame_size;
+	req.tp_block_nr = (_block_nr) ? _block_nr : buffer_size / block_size;
+	req.tp_frame_nr = req.tp_block_nr * (block_size / frame_size);
+	if (_retire_tov) {
+		req.tp_retire_blk_tov = _retire_tov;
+	} else {
+		req.tp_retire_blk_tov = (_autotune) ? target_latency : 60;
+	}
+	req.tp_feature_req_word = 0;
+	return req;
+}
+
+void ring_tuner::observe(const ring_usage& usage) {
+	std::lock_guard<std::mutex> lk(_mutex);
+	_usage += usage;
+}
+
+} /* namespace horace */
@@ -0,0 +1,176 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_RING_TUNER
+#define LIBHOLMES_HORACE_RING_TUNER
+
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+
+#include <linux/if_packet.h>
+
+namespace horace {
+
+/** A class for recording how a TPACKET_V3 ring buffer has been used.
+ * Frame lengths are recorded as a histogram with one bucket for each
+ * power of two, which is sufficient for choosing a block size and cheap
+ * enough to maintain for every packet.
+ */
+class ring_usage {
+public:
+	/** The number of histogram buckets. */
+	static const int bucket_count = 32;
+private:
+	/** The number of frames observed, indexed by the base-2 logarithm
+	 * of the frame length rounded up. */
+	uint64_t _frames[bucket_count];
+
+	/** The total number of frames observed. */
+	uint64_t _frame_count;
+
+	/** The total length of the frames observed, in octets. */
+	uint64_t _octet_count;
+
+	/** The number of blocks observed. */
+	uint64_t _block_count;
+
+	/** The number of blocks which were retired due to timeout. */
+	uint64_t _timeout_count;
+
+	/** The timestamp of the first frame observed. */
+	struct timespec _first_ts;
+
+	/** The timestamp of the last frame observed. */
+	struct timespec _last_ts;
+public:
+	/** Construct empty ring usage record. */
+	ring_usage();
+
+	/** Record a frame.
+	 * @param length the length of the frame within its block, in octets
+	 * @param ts the timestamp of the frame
+	 */
+	void add_frame(size_t length, const struct timespec& ts) {
+		int bucket = (length > 1) ?
+			(64 - __builtin_clzll(length - 1)) : 0;
+		if (bucket >= bucket_count) {
+			bucket = bucket_count - 1;
+		}
+		_frames[bucket] += 1;
+		_octet_count += length;
+		if (!_frame_count++) {
+			_first_ts = ts;
+		}
+		_last_ts = ts;
+	}
+
+	/** Record a block.
+	 * @param timeout true if the block was retired due to timeout,
+	 *  otherwise false
+	 */
+	void add_block(bool timeout) {
+		_block_count += 1;
+		_timeout_count += timeout;
+	}
+
+	/** Merge another usage record into this one.
+	 * @param that the usage record to be merged
+	 * @return a reference to this
+	 */
+	ring_usage& operator+=(const ring_usage& that);
+
+	/** Get the number of frames observed.
+	 * @return the number of frames
+	 */
+	uint64_t frame_count() const {
+		return _frame_count;
+	}
+
+	/** Get the number of blocks observed.
+	 * @return the number of blocks
+	 */
+	uint64_t block_count() const {
+		return _block_count;
+	}
+
+	/** Get the number of blocks retired due to timeout.
+	 * @return the number of blocks
+	 */
+	uint64_t timeout_count() const {
+		return _timeout_count;
+	}
+
+	/** Get an upper bound for the length of a given fraction of frames.
+	 * @param fraction the required fraction, between 0 and 1
+	 * @return the power of two which bounds the frame length
+	 */
+	size_t frame_length(double fraction) const;
+
+	/** Get the observed data rate.
+	 * @return the data rate, in octets per second, or 0 if unknown
+	 */
+	double octet_rate() const;
+};
+
+/** A class for choosing the geometry of a TPACKET_V3 ring buffer.
+ * Block size, block count and retirement timeout can be specified
+ * explicitly. Any which are not can either be chosen using the same
+ * rules as for earlier ring buffer versions, or if automatic tuning
+ * is enabled, from the usage of previous ring buffers created for the
+ * same endpoint.
+ *
+ * The geometry of a ring buffer cannot be changed while it is in use
+ * without discarding any packets which it contains, so tuning takes
+ * effect when the next ring buffer is created (normally at the start
+ * of the next session).
+ */
+class ring_tuner {
+private:
+	/** A mutex to protect _usage. */
+	std::mutex _mutex;
+
+	/** The required block size, in octets, or 0 if unspecified. */
+	size_t _block_size;
+
+	/** The required number of blocks, or 0 if unspecified. */
+	size_t _block_nr;
+
+	/** The required block retirement timeout, in milliseconds,
+	 * or 0 if unspecified. */
+	unsigned int _retire_tov;
+
+	/** True if automatic tuning is enabled, otherwise false. */
+	bool _autotune;
+
+	/** The combined usage of previous ring buffers. */
+	ring_usage _usage;
+public:
+	/** Construct ring tuner.
+	 * @param block_size the required block size, or 0 if unspecified
+	 * @param block_nr the required number of blocks, or 0 if unspecified
+	 * @param retire_tov the required block retirement timeout in
+	 *  milliseconds, or 0 if unspecified
+	 * @param autotune true to enable automatic tuning, otherwise false
+	 */
+	ring_tuner(size_t block_size, size_t block_nr,
+		unsigned int retire_tov, bool autotune);
+
+	/** Choose a ring buffer geometry.
+	 * @param snaplen the required link layer snaplen, in octets
+	 * @param buffer_size the required ring buffer size, in octets
+	 * @return the geometry, suitable for passing to PACKET_RX_RING
+	 */
+	struct tpacket_req3 geometry(size_t snaplen, size_t buffer_size);
+
+	/** Record the usage of a ring buffer.
+	 * @param usage the usage to be recorded
+	 */
+	void observe(const ring_usage& usage);
+};
+
+} /* namespace horace */
+
+#endif
@@ -4,7 +4,9 @@
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
 #include "horace/endpoint_error.h"
+#include "horace/record.h"
 
+#include "null_session_writer.h"
 #include "null_endpoint.h"
 
 namespace horace {
@@ -19,6 +21,12 @@ null_endpoint::null_endpoint(const std::string& name):
 	}
 }
 
+std::unique_ptr<session_writer> null_endpoint::make_session_writer(
+	const std::string& srcid) {
+
+	return std::make_unique<null_session_writer>(srcid);
+}
+
 } /* namespace horace */
 
 extern "C"
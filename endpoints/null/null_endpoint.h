@@ -7,17 +7,25 @@
 #define LIBHOLMES_HORACE_NULL_ENDPOINT
 
 #include "horace/endpoint.h"
+#include "horace/session_writer_endpoint.h"
 
 namespace horace {
 
-/** An endpoint class to represent a null endpoint. */
+/** An endpoint class to represent a null endpoint.
+ * Sessions written to a null endpoint are accepted and then discarded.
+ * This is useful for measuring the throughput of whatever is upstream.
+ */
 class null_endpoint:
-	public endpoint {
+	public endpoint,
+	public session_writer_endpoint {
 public:
 	/** Construct null endpoint.
 	 * @param name the name of this endpoint
 	 */
 	explicit null_endpoint(const std::string& name);
+
+	virtual std::unique_ptr<session_writer> make_session_writer(
+		const std::string& srcid);
 };
 
 } /* namespace horace */
@@ -0,0 +1,23 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/record.h"
+
+#include "null_session_writer.h"
+
+namespace horace {
+
+null_session_writer::null_session_writer(const std::string& srcid):
+	simple_session_writer(srcid) {}
+
+void null_session_writer::handle_session_start(const record& srec) {}
+
+void null_session_writer::handle_session_end(const record& erec) {}
+
+void null_session_writer::handle_sync(const record& crec) {}
+
+void null_session_writer::handle_event(const record& rec) {}
+
+} /* namespace horace */
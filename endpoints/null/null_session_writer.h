@@ -0,0 +1,34 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_NULL_SESSION_WRITER
+#define LIBHOLMES_HORACE_NULL_SESSION_WRITER
+
+#include "horace/simple_session_writer.h"
+
+namespace horace {
+
+/** A class for writing sessions to a null endpoint.
+ * Records are checked for consistency in the same way as for any other
+ * simple session writer, and sync requests are acknowledged, but the
+ * records are otherwise discarded.
+ */
+class null_session_writer:
+	public simple_session_writer {
+protected:
+	virtual void handle_session_start(const record& srec);
+	virtual void handle_session_end(const record& erec);
+	virtual void handle_sync(const record& crec);
+	virtual void handle_event(const record& rec);
+public:
+	/** Construct null session writer.
+	 * @param srcid the required source ID
+	 */
+	explicit null_session_writer(const std::string& srcid);
+};
+
+} /* namespace horace */
+
+#endif
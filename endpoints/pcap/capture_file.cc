@@ -0,0 +1,35 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/endpoint_error.h"
+
+#include "mapped_file.h"
+#include "capture_file.h"
+#include "pcap_file.h"
+#include "pcapng_file.h"
+
+namespace horace {
+
+capture_file::capture_file(const mapped_file& mf):
+	_swap(false),
+	_data(mf.data()),
+	_size(mf.size()),
+	_offset(0) {}
+
+std::unique_ptr<capture_file> capture_file::make(const mapped_file& mf) {
+	if (mf.size() < 4) {
+		throw endpoint_error("capture file too short");
+	}
+	uint32_t magic;
+	memcpy(&magic, mf.data(), sizeof(magic));
+	if (pcapng_file::recognise(magic)) {
+		return std::make_unique<pcapng_file>(mf);
+	} else if (pcap_file::recognise(magic)) {
+		return std::make_unique<pcap_file>(mf);
+	}
+	throw endpoint_error("unrecognised capture file format");
+}
+
+} /* namespace horace */
@@ -0,0 +1,143 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_CAPTURE_FILE
+#define LIBHOLMES_HORACE_CAPTURE_FILE
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace horace {
+
+class mapped_file;
+
+/** An abstract base class for parsing a memory-mapped capture file.
+ * Packet content is not copied, but instead referred to within the
+ * mapping, which must therefore remain valid for as long as the packet
+ * content is in use.
+ */
+class capture_file {
+public:
+	/** A structure to describe a network interface. */
+	struct interface {
+		/** The link-layer header type. */
+		unsigned int linktype;
+
+		/** The interface name, or the empty string if unknown. */
+		std::string name;
+	};
+
+	/** A structure to describe a packet. */
+	struct packet {
+		/** The index of the interface on which the packet was
+		 * captured. */
+		unsigned int ifindex;
+
+		/** True if the packet has a timestamp, otherwise false. */
+		bool has_ts;
+
+		/** The timestamp, if there is one. */
+		struct timespec ts;
+
+		/** The packet content. */
+		const void* content;
+
+		/** The captured length of the packet, in octets. */
+		size_t snaplen;
+
+		/** The original length of the packet, in octets. */
+		size_t origlen;
+	};
+private:
+	/** True if multi-octet fields must be byte-swapped. */
+	bool _swap;
+protected:
+	/** A pointer to the start of the file content. */
+	const unsigned char* _data;
+
+	/** The size of the file content, in octets. */
+	size_t _size;
+
+	/** The offset of the next unparsed octet. */
+	size_t _offset;
+
+	/** The interfaces described by the file. */
+	std::vector<interface> _interfaces;
+
+	/** Specify whether multi-octet fields must be byte-swapped.
+	 * @param swap true if byte-swapping is needed, otherwise false
+	 */
+	void swap(bool swap) {
+		_swap = swap;
+	}
+
+	/** Get a 16-bit unsigned integer from the file.
+	 * @param offset the offset of the integer
+	 * @return the integer
+	 */
+	uint16_t get16(size_t offset) const {
+		uint16_t value;
+		memcpy(&value, _data + offset, sizeof(value));
+		return (_swap) ? __builtin_bswap16(value) : value;
+	}
+
+	/** Get a 32-bit unsigned integer from the file.
+	 * @param offset the offset of the integer
+	 * @return the integer
+	 */
+	uint32_t get32(size_t offset) const {
+		uint32_t value;
+		memcpy(&value, _data + offset, sizeof(value));
+		return (_swap) ? __builtin_bswap32(value) : value;
+	}
+
+	/** Get a 64-bit unsigned integer from the file.
+	 * @param offset the offset of the integer
+	 * @return the integer
+	 */
+	uint64_t get64(size_t offset) const {
+		uint64_t value;
+		memcpy(&value, _data + offset, sizeof(value));
+		return (_swap) ? __builtin_bswap64(value) : value;
+	}
+
+	/** Construct capture file.
+	 * @param mf the mapped file to be parsed
+	 */
+	explicit capture_file(const mapped_file& mf);
+public:
+	virtual ~capture_file() = default;
+
+	/** Get the interfaces described by this file.
+	 * @return the interfaces
+	 */
+	const std::vector<interface>& interfaces() const {
+		return _interfaces;
+	}
+
+	/** Parse the next packet.
+	 * @param pkt a structure to receive the packet
+	 * @return true if a packet was parsed, false if at end of file
+	 */
+	virtual bool next(packet& pkt) = 0;
+
+	/** Return to the first packet. */
+	virtual void rewind() = 0;
+
+	/** Make a capture file parser, choosing the format from the
+	 * content of the file.
+	 * @param mf the mapped file to be parsed
+	 * @return the resulting parser
+	 */
+	static std::unique_ptr<capture_file> make(const mapped_file& mf);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,49 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "horace/libc_error.h"
+#include "horace/file_descriptor.h"
+
+#include "mapped_file.h"
+
+namespace horace {
+
+mapped_file::mapped_file(const std::string& pathname):
+	_data(0),
+	_size(0) {
+
+	file_descriptor fd(pathname, O_RDONLY);
+	struct stat statbuf;
+	if (fstat(fd, &statbuf) == -1) {
+		throw libc_error();
+	}
+	_size = statbuf.st_size;
+
+	// A zero-length mapping is not permitted, so an empty file is
+	// represented by a null pointer.
+	if (_size) {
+		void* data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			throw libc_error();
+		}
+		_data = static_cast<const unsigned char*>(data);
+
+		// The file is normally read from start to finish, so
+		// encourage the kernel to read ahead aggressively.
+		madvise(data, _size, MADV_SEQUENTIAL);
+	}
+}
+
+mapped_file::~mapped_file() {
+	if (_data) {
+		munmap(const_cast<unsigned char*>(_data), _size);
+	}
+}
+
+} /* namespace horace */
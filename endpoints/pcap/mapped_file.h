@@ -0,0 +1,51 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_MAPPED_FILE
+#define LIBHOLMES_HORACE_MAPPED_FILE
+
+#include <string>
+
+namespace horace {
+
+/** A class to represent a read-only memory-mapped file. */
+class mapped_file {
+private:
+	/** A pointer to the start of the mapping, or null if the file
+	 * is empty. */
+	const unsigned char* _data;
+
+	/** The size of the mapping, in octets. */
+	size_t _size;
+public:
+	/** Map a file into memory.
+	 * @param pathname the pathname of the file
+	 */
+	explicit mapped_file(const std::string& pathname);
+
+	/** Unmap the file. */
+	~mapped_file();
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	/** Get a pointer to the file content.
+	 * @return a pointer to the start of the content
+	 */
+	const unsigned char* data() const {
+		return _data;
+	}
+
+	/** Get the size of the file.
+	 * @return the size, in octets
+	 */
+	size_t size() const {
+		return _size;
+	}
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,52 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/endpoint_error.h"
+#include "horace/query_string.h"
+
+#include "pcap_endpoint.h"
+#include "pcap_event_reader.h"
+
+namespace horace {
+
+pcap_endpoint::pcap_endpoint(const std::string& name):
+	endpoint(name),
+	_speed(1.0),
+	_loop(1),
+	_original_ts(false) {
+
+	std::optional<std::string> query = this->name().query();
+	if (query) {
+		query_string params(*query);
+		_speed = params.find<double>("speed").value_or(_speed);
+		_loop = params.find<long>("loop").value_or(_loop);
+		std::string tstamp = params.find<std::string>("tstamp").
+			value_or("replay");
+		if (tstamp == "original") {
+			_original_ts = true;
+		} else if (tstamp != "replay") {
+			throw endpoint_error("invalid tstamp parameter");
+		}
+	}
+	if (_speed < 0) {
+		throw endpoint_error("speed must not be negative");
+	}
+	if (_loop < 0) {
+		throw endpoint_error("loop must not be negative");
+	}
+}
+
+std::unique_ptr<event_reader> pcap_endpoint::make_event_reader(
+	session_builder& session) {
+
+	return std::make_unique<pcap_event_reader>(*this, session);
+};
+
+} /* namespace horace */
+
+extern "C"
+std::unique_ptr<horace::endpoint> make_endpoint(const std::string& name) {
+	return std::make_unique<horace::pcap_endpoint>(name);
+}
@@ -0,0 +1,75 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAP_ENDPOINT
+#define LIBHOLMES_HORACE_PCAP_ENDPOINT
+
+#include "horace/endpoint.h"
+#include "horace/event_reader_endpoint.h"
+
+namespace horace {
+
+/** An endpoint class to represent a pcap or pcapng file for replay.
+ * Packets can be replayed with their original timing, with timing
+ * scaled by a given factor, or as fast as possible.
+ */
+class pcap_endpoint:
+	public endpoint,
+	public event_reader_endpoint {
+private:
+	/** The replay speed, relative to the original timing,
+	 * or 0 to replay as fast as possible. */
+	double _speed;
+
+	/** The number of times to replay the file, or 0 to repeat
+	 * indefinitely. */
+	long _loop;
+
+	/** True to retain the original timestamps, false to timestamp
+	 * packets when they are replayed. */
+	bool _original_ts;
+public:
+	/** Construct pcap endpoint.
+	 * @param name the name of this endpoint
+	 */
+	explicit pcap_endpoint(const std::string& name);
+
+	/** Get the pathname.
+	 * @return the pathname
+	 */
+	std::string pathname() const {
+		return name().path();
+	}
+
+	/** Get the replay speed.
+	 * @return the speed relative to the original timing, or 0 if
+	 *  as fast as possible
+	 */
+	double speed() const {
+		return _speed;
+	}
+
+	/** Get the number of times to replay the file.
+	 * @return the number of times, or 0 if indefinitely
+	 */
+	long loop() const {
+		return _loop;
+	}
+
+	/** Determine whether original timestamps are to be retained.
+	 * @return true if original timestamps retained, false if packets
+	 *  are timestamped when replayed
+	 */
+	bool original_ts() const {
+		return _original_ts;
+	}
+
+	virtual std::unique_ptr<event_reader> make_event_reader(
+		session_builder& session);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,182 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <csignal>
+
+#include <unistd.h>
+
+#include "horace/libc_error.h"
+#include "horace/log_message.h"
+#include "horace/logger.h"
+#include "horace/terminate_flag.h"
+#include "horace/attribute_list.h"
+#include "horace/string_attribute.h"
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/session_builder.h"
+
+#include "pcap_event_reader.h"
+#include "pcap_endpoint.h"
+
+namespace horace {
+
+namespace {
+
+/** The remaining time below which clock_nanosleep is used in preference
+ * to an interruptible sleep, in nanoseconds. */
+const int64_t fine_wait = 10000000;
+
+/** Find the difference between two timespecs.
+ * @param lhs the left hand side
+ * @param rhs the right hand side
+ * @return lhs - rhs, in nanoseconds
+ */
+int64_t difference(const struct timespec& lhs, const struct timespec& rhs) {
+	return (lhs.tv_sec - rhs.tv_sec) * 1000000000LL +
+		(lhs.tv_nsec - rhs.tv_nsec);
+}
+
+} /* anonymous namespace */
+
+pcap_event_reader::pcap_event_reader(const pcap_endpoint& ep,
+	session_builder& session):
+	_ep(&ep),
+	_mf(ep.pathname()),
+	_cf(capture_file::make(_mf)),
+	_builder(0),
+	_passes(0),
+	_count(0),
+	_timing(false) {
+
+	const auto& interfaces = _cf->interfaces();
+	for (unsigned int i = 0; i != interfaces.size(); ++i) {
+		const auto& iface = interfaces[i];
+		attribute_list attrs;
+		attrs.insert(std::make_unique<string_attribute>(
+			session.define_attribute("pathname", type_string),
+			_ep->pathname()));
+		attrs.insert(std::make_unique<unsigned_integer_attribute>(
+			session.define_attribute("if_index",
+			type_unsigned_integer), i));
+		if (!iface.name.empty()) {
+			attrs.insert(std::make_unique<string_attribute>(
+				session.define_attribute("if_name", type_string),
+				iface.name));
+		}
+		attrs.insert(std::make_unique<unsigned_integer_attribute>(
+			session.define_attribute("if_linktype",
+			type_unsigned_integer), iface.linktype));
+		int channel = session.define_channel("pcap", std::move(attrs));
+		_builders.push_back(
+			std::make_unique<packet_record_builder>(session, channel));
+	}
+
+	if (log->enabled(logger::log_notice)) {
+		log_message msg(*log, logger::log_notice);
+		msg << "replaying " << _ep->pathname();
+	}
+}
+
+void pcap_event_reader::_wait(const struct timespec& ts) {
+	struct timespec now;
+	if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+		throw libc_error();
+	}
+	if (!_timing) {
+		_base_time = now;
+		_base_ts = ts;
+		_timing = true;
+		return;
+	}
+
+	// Packets which are out of order are replayed immediately.
+	int64_t offset = difference(ts, _base_ts) / _ep->speed();
+	if (offset <= 0) {
+		return;
+	}
+	struct timespec due = _base_time;
+	due.tv_sec += offset / 1000000000;
+	due.tv_nsec += offset % 1000000000;
+	if (due.tv_nsec >= 1000000000) {
+		due.tv_sec += 1;
+		due.tv_nsec -= 1000000000;
+	}
+
+	// Long waits must be interruptible in case of termination, but
+	// the final part of the wait is made using an absolute deadline
+	// so that timing errors do not accumulate.
+	int64_t remaining = difference(due, now);
+	while (remaining >= fine_wait) {
+		terminating.millisleep((remaining - fine_wait) / 1000000 + 1);
+		if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+			throw libc_error();
+		}
+		remaining = difference(due, now);
+	}
+	if (remaining > 0) {
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, 0);
+	}
+}
+
+void pcap_event_reader::_finish() {
+	if (log->enabled(logger::log_notice)) {
+		log_message msg(*log, logger::log_notice);
+		msg << "finished replaying " << _ep->pathname();
+	}
+	kill(getpid(), SIGTERM);
+	while (true) {
+		terminating.millisleep(-1);
+	}
+}
+
+const record& pcap_event_reader::read() {
+	if (_builder) {
+		if (const record* rec = _builder->next()) {
+			return *rec;
+		}
+	}
+
+	capture_file::packet pkt;
+	while (!_cf->next(pkt)) {
+		// A file which contains no packets would otherwise be
+		// replayed without end.
+		if (!_count) {
+			_finish();
+		}
+		_passes += 1;
+		if (_ep->loop() && (_passes >= _ep->loop())) {
+			_finish();
+		}
+		_cf->rewind();
+		_count = 0;
+		_timing = false;
+	}
+	_count += 1;
+
+	if (pkt.has_ts && _ep->speed()) {
+		_wait(pkt.ts);
+	}
+
+	const struct timespec* ts = 0;
+	struct timespec now;
+	if (_ep->original_ts()) {
+		if (pkt.has_ts) {
+			ts = &pkt.ts;
+		}
+	} else {
+		if (clock_gettime(CLOCK_REALTIME, &now) == -1) {
+			throw libc_error();
+		}
+		if (detect_leap_seconds) {
+			_lsc.correct(now);
+		}
+		ts = &now;
+	}
+
+	_builder = _builders[pkt.ifindex].get();
+	_builder->build_packet(ts, pkt.content, pkt.snaplen, pkt.origlen, 0);
+	return *_builder->next();
+}
+
+} /* namespace horace */
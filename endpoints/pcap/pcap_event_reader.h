@@ -0,0 +1,90 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAP_EVENT_READER
+#define LIBHOLMES_HORACE_PCAP_EVENT_READER
+
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include "horace/event_reader.h"
+#include "horace/leap_second_corrector.h"
+#include "horace/packet_record_builder.h"
+
+#include "mapped_file.h"
+#include "capture_file.h"
+
+namespace horace {
+
+class session_builder;
+class pcap_endpoint;
+
+/** A class for replaying events from a pcap or pcapng file.
+ * The file is memory-mapped, and packet records refer to the packet
+ * content in place rather than copying it. One channel is defined for
+ * each interface described by the file.
+ *
+ * Once the file has been replayed the requested number of times, the
+ * process is sent a SIGTERM so that capture ends cleanly.
+ */
+class pcap_event_reader:
+	public event_reader {
+private:
+	/** The endpoint from which to replay. */
+	const pcap_endpoint* _ep;
+
+	/** The memory-mapped capture file. */
+	mapped_file _mf;
+
+	/** A parser for the capture file. */
+	std::unique_ptr<capture_file> _cf;
+
+	/** A builder for making packet records, for each interface. */
+	std::vector<std::unique_ptr<packet_record_builder>> _builders;
+
+	/** The builder used for the most recent packet, or null if none. */
+	packet_record_builder* _builder;
+
+	/** The number of times the file has been replayed in full. */
+	long _passes;
+
+	/** The number of packets replayed during the current pass. */
+	uint64_t _count;
+
+	/** The monotonic time at which the first packet with a timestamp
+	 * was replayed during the current pass. */
+	struct timespec _base_time;
+
+	/** The original timestamp of the first packet with a timestamp
+	 * during the current pass. */
+	struct timespec _base_ts;
+
+	/** True if _base_time and _base_ts are valid, otherwise false. */
+	bool _timing;
+
+	/** A leap second corrector for replay timestamps. */
+	leap_second_corrector _lsc;
+
+	/** Wait until a packet is due to be replayed.
+	 * @param ts the original timestamp of the packet
+	 */
+	void _wait(const struct timespec& ts);
+
+	/** Finish replay. This function does not return. */
+	[[noreturn]] void _finish();
+public:
+	/** Construct pcap event reader.
+	 * @param ep the endpoint to read from
+	 * @param session the applicable session builder
+	 */
+	pcap_event_reader(const pcap_endpoint& ep, session_builder& session);
+
+	virtual const record& read();
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,92 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/log_message.h"
+#include "horace/logger.h"
+#include "horace/endpoint_error.h"
+
+#include "pcap_file.h"
+
+namespace horace {
+
+namespace {
+
+/** The magic number for microsecond resolution files. */
+const uint32_t magic_usec = 0xa1b2c3d4;
+
+/** The magic number for nanosecond resolution files. */
+const uint32_t magic_nsec = 0xa1b23c4d;
+
+/** The length of the file header, in octets. */
+const size_t file_header_length = 24;
+
+/** The length of a record header, in octets. */
+const size_t record_header_length = 16;
+
+} /* anonymous namespace */
+
+pcap_file::pcap_file(const mapped_file& mf):
+	capture_file(mf) {
+
+	if (_size < file_header_length) {
+		throw endpoint_error("pcap file header truncated");
+	}
+
+	uint32_t magic;
+	memcpy(&magic, _data, sizeof(magic));
+	swap((magic != magic_usec) && (magic != magic_nsec));
+	_tsscale = (get32(0) == magic_nsec) ? 1 : 1000;
+
+	interface iface;
+	iface.linktype = get32(20) & 0xffff;
+	_interfaces.push_back(iface);
+	rewind();
+}
+
+bool pcap_file::next(packet& pkt) {
+	if (_offset == _size) {
+		return false;
+	}
+	if (_size - _offset < record_header_length) {
+		if (log->enabled(logger::log_warning)) {
+			log_message msg(*log, logger::log_warning);
+			msg << "pcap record header truncated";
+		}
+		_offset = _size;
+		return false;
+	}
+
+	size_t snaplen = get32(_offset + 8);
+	if (_size - _offset - record_header_length < snaplen) {
+		if (log->enabled(logger::log_warning)) {
+			log_message msg(*log, logger::log_warning);
+			msg << "pcap record truncated";
+		}
+		_offset = _size;
+		return false;
+	}
+
+	pkt.ifindex = 0;
+	pkt.has_ts = true;
+	pkt.ts.tv_sec = get32(_offset);
+	pkt.ts.tv_nsec = get32(_offset + 4) * _tsscale;
+	pkt.snaplen = snaplen;
+	pkt.origlen = get32(_offset + 12);
+	pkt.content = _data + _offset + record_header_length;
+	_offset += record_header_length + snaplen;
+	return true;
+}
+
+void pcap_file::rewind() {
+	_offset = file_header_length;
+}
+
+bool pcap_file::recognise(uint32_t magic) {
+	return (magic == magic_usec) || (magic == magic_nsec) ||
+		(magic == __builtin_bswap32(magic_usec)) ||
+		(magic == __builtin_bswap32(magic_nsec));
+}
+
+} /* namespace horace */
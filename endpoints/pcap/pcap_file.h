@@ -0,0 +1,40 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAP_FILE
+#define LIBHOLMES_HORACE_PCAP_FILE
+
+#include "capture_file.h"
+
+namespace horace {
+
+/** A class for parsing a classic (libpcap format) capture file.
+ * Both microsecond and nanosecond resolution timestamps are supported,
+ * in either byte order.
+ */
+class pcap_file:
+	public capture_file {
+private:
+	/** The number of nanoseconds per timestamp unit. */
+	long _tsscale;
+public:
+	/** Construct pcap file parser.
+	 * @param mf the mapped file to be parsed
+	 */
+	explicit pcap_file(const mapped_file& mf);
+
+	virtual bool next(packet& pkt);
+	virtual void rewind();
+
+	/** Determine whether a magic number is recognised by this parser.
+	 * @param magic the first four octets of the file, in host byte order
+	 * @return true if recognised, otherwise false
+	 */
+	static bool recognise(uint32_t magic);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,250 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+
+#include "horace/log_message.h"
+#include "horace/logger.h"
+#include "horace/endpoint_error.h"
+
+#include "pcapng_file.h"
+
+namespace horace {
+
+namespace {
+
+/** The block type of a section header block.
+ * This is palindromic, so does not depend on byte order. */
+const uint32_t type_shb = 0x0a0d0d0a;
+
+/** The block type of an interface description block. */
+const uint32_t type_idb = 1;
+
+/** The block type of an obsolete packet block. */
+const uint32_t type_pb = 2;
+
+/** The block type of a simple packet block. */
+const uint32_t type_spb = 3;
+
+/** The block type of an enhanced packet block. */
+const uint32_t type_epb = 6;
+
+/** The byte order magic number. */
+const uint32_t byte_order_magic = 0x1a2b3c4d;
+
+/** The option code for the end of options. */
+const uint16_t opt_endofopt = 0;
+
+/** The option code for the interface name. */
+const uint16_t opt_if_name = 2;
+
+/** The option code for the timestamp resolution. */
+const uint16_t opt_if_tsresol = 9;
+
+/** The option code for the timestamp offset. */
+const uint16_t opt_if_tsoffset = 14;
+
+/** Round a length up to a multiple of four octets.
+ * @param length the length to be rounded
+ * @return the rounded length
+ */
+size_t pad4(size_t length) {
+	return (length + 3) & ~size_t(3);
+}
+
+} /* anonymous namespace */
+
+pcapng_file::pcapng_file(const mapped_file& mf):
+	capture_file(mf) {
+
+	if (_size < 28) {
+		throw endpoint_error("pcapng section header truncated");
+	}
+	uint32_t magic;
+	memcpy(&magic, _data + 8, sizeof(magic));
+	if (magic == byte_order_magic) {
+		swap(false);
+	} else if (magic == __builtin_bswap32(byte_order_magic)) {
+		swap(true);
+	} else {
+		throw endpoint_error("invalid pcapng byte order magic");
+	}
+	_first_block = get32(4);
+	if ((_first_block < 28) || (_first_block > _size)) {
+		throw endpoint_error("invalid pcapng section header length");
+	}
+
+	// Interfaces are needed to define channels before any packets are
+	// read, so scan ahead for interface description blocks as far as
+	// the first packet.
+	_offset = _first_block;
+	_scan_end = _first_block;
+	while (_size - _offset >= 12) {
+		uint32_t type = get32(_offset);
+		size_t length = get32(_offset + 4);
+		if ((length < 12) || (length > _size - _offset)) {
+			break;
+		}
+		if (type == type_idb) {
+			_parse_idb(_offset + 8, length - 12);
+			_scan_end = _offset + length;
+		} else if ((type == type_epb) || (type == type_spb) ||
+			(type == type_pb) || (type == type_shb)) {
+			break;
+		}
+		_offset += length;
+	}
+	rewind();
+}
+
+void pcapng_file::_parse_idb(size_t offset, size_t length) {
+	if (length < 8) {
+		throw endpoint_error("pcapng interface description truncated");
+	}
+
+	interface iface;
+	iface.linktype = get16(offset);
+	tsformat tsf = {10, 6, 0};
+
+	size_t end = offset + length;
+	offset += 8;
+	while (end - offset >= 4) {
+		uint16_t code = get16(offset);
+		size_t optlen = get16(offset + 2);
+		offset += 4;
+		if ((code == opt_endofopt) || (optlen > end - offset)) {
+			break;
+		}
+		switch (code) {
+		case opt_if_name:
+			iface.name.assign(
+				reinterpret_cast<const char*>(_data + offset),
+				optlen);
+			break;
+		case opt_if_tsresol:
+			if (optlen >= 1) {
+				uint8_t tsresol = _data[offset];
+				tsf.base = (tsresol & 0x80) ? 2 : 10;
+				tsf.exponent = tsresol & 0x7f;
+			}
+			break;
+		case opt_if_tsoffset:
+			if (optlen >= 8) {
+				tsf.offset = get64(offset);
+			}
+			break;
+		}
+		offset += pad4(optlen);
+	}
+
+	// A resolution finer than 2^-63 or 10^-19 would overflow the
+	// conversion arithmetic, and is not meaningful in any case.
+	if ((tsf.base == 2) ? (tsf.exponent > 63) : (tsf.exponent > 19)) {
+		throw endpoint_error("unsupported pcapng timestamp resolution");
+	}
+
+	_interfaces.push_back(iface);
+	_tsformats.push_back(tsf);
+}
+
+struct timespec pcapng_file::_convert_ts(unsigned int ifindex,
+	uint64_t raw) const {
+
+	const tsformat& tsf = _tsformats[ifindex];
+	unsigned __int128 units = 1;
+	for (unsigned int i = 0; i != tsf.exponent; ++i) {
+		units *= tsf.base;
+	}
+
+	struct timespec ts;
+	ts.tv_sec = raw / units + tsf.offset;
+	ts.tv_nsec = (raw % units) * 1000000000 / units;
+	return ts;
+}
+
+bool pcapng_file::next(packet& pkt) {
+	while (_offset != _size) {
+		if (_size - _offset < 12) {
+			break;
+		}
+		uint32_t type = get32(_offset);
+		size_t length = get32(_offset + 4);
+		if ((length < 12) || (length > _size - _offset)) {
+			break;
+		}
+		size_t body = _offset + 8;
+		size_t body_length = length - 12;
+		_offset += length;
+
+		switch (type) {
+		case type_epb:
+		case type_pb:
+			{
+				if (body_length < 20) {
+					break;
+				}
+				unsigned int ifindex = (type == type_epb) ?
+					get32(body) : get16(body);
+				size_t snaplen = get32(body + 12);
+				if ((ifindex >= _interfaces.size()) ||
+					(snaplen > body_length - 20)) {
+					break;
+				}
+				uint64_t raw = (uint64_t(get32(body + 4)) << 32) |
+					get32(body + 8);
+				pkt.ifindex = ifindex;
+				pkt.has_ts = true;
+				pkt.ts = _convert_ts(ifindex, raw);
+				pkt.snaplen = snaplen;
+				pkt.origlen = get32(body + 16);
+				pkt.content = _data + body + 20;
+				return true;
+			}
+		case type_spb:
+			{
+				if ((body_length < 4) || _interfaces.empty()) {
+					break;
+				}
+				size_t origlen = get32(body);
+				pkt.ifindex = 0;
+				pkt.has_ts = false;
+				pkt.ts = {0};
+				pkt.snaplen = std::min(origlen, body_length - 4);
+				pkt.origlen = origlen;
+				pkt.content = _data + body + 4;
+				return true;
+			}
+		case type_idb:
+		case type_shb:
+			// Interfaces described before the first packet
+			// have already been parsed.
+			if (body > _scan_end) {
+				throw endpoint_error("pcapng files with interfaces "
+					"or sections after the first packet "
+					"are not supported");
+			}
+			break;
+		}
+	}
+
+	if (_offset != _size) {
+		if (log->enabled(logger::log_warning)) {
+			log_message msg(*log, logger::log_warning);
+			msg << "pcapng block truncated";
+		}
+		_offset = _size;
+	}
+	return false;
+}
+
+void pcapng_file::rewind() {
+	_offset = _first_block;
+}
+
+bool pcapng_file::recognise(uint32_t magic) {
+	return magic == type_shb;
+}
+
+} /* namespace horace */
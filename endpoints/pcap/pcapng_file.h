@@ -0,0 +1,77 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAPNG_FILE
+#define LIBHOLMES_HORACE_PCAPNG_FILE
+
+#include "capture_file.h"
+
+namespace horace {
+
+/** A class for parsing a pcapng format capture file.
+ * Enhanced, simple and obsolete packet blocks are supported, with
+ * per-interface timestamp resolution and offset. Blocks of other types
+ * are skipped.
+ *
+ * The interfaces must all be described before the first packet block,
+ * and the file must consist of a single section. This is sufficient
+ * for files written by libpcap, tcpdump and dumpcap.
+ */
+class pcapng_file:
+	public capture_file {
+private:
+	/** A structure to describe the timestamp format of an interface. */
+	struct tsformat {
+		/** The base of the timestamp resolution (2 or 10). */
+		unsigned int base;
+
+		/** The negated exponent of the timestamp resolution. */
+		unsigned int exponent;
+
+		/** The offset to be added to timestamps, in seconds. */
+		int64_t offset;
+	};
+
+	/** The timestamp format of each interface. */
+	std::vector<tsformat> _tsformats;
+
+	/** The offset of the first block after the section header. */
+	size_t _first_block;
+
+	/** The offset of the end of the last interface description block
+	 * which precedes the first packet. */
+	size_t _scan_end;
+
+	/** Parse an interface description block.
+	 * @param offset the offset of the block body
+	 * @param length the length of the block body
+	 */
+	void _parse_idb(size_t offset, size_t length);
+
+	/** Convert a raw timestamp to a timespec.
+	 * @param ifindex the interface index
+	 * @param raw the raw timestamp
+	 * @return the timestamp as a timespec
+	 */
+	struct timespec _convert_ts(unsigned int ifindex, uint64_t raw) const;
+public:
+	/** Construct pcapng file parser.
+	 * @param mf the mapped file to be parsed
+	 */
+	explicit pcapng_file(const mapped_file& mf);
+
+	virtual bool next(packet& pkt);
+	virtual void rewind();
+
+	/** Determine whether a magic number is recognised by this parser.
+	 * @param magic the first four octets of the file, in host byte order
+	 * @return true if recognised, otherwise false
+	 */
+	static bool recognise(uint32_t magic);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,56 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <optional>
+
+#include "horace/endpoint_error.h"
+#include "horace/query_string.h"
+#include "horace/record.h"
+
+#include "pcapng_endpoint.h"
+#include "pcapng_session_writer.h"
+
+namespace horace {
+
+/** The default size of the buffers used for writing files, in octets. */
+static size_t default_bufsize = 0x100000;
+
+pcapng_endpoint::pcapng_endpoint(const std::string& name):
+	endpoint(name),
+	_pathname(this->name().path()),
+	_filesize(0),
+	_interval(0) {
+
+	long long bufsize = default_bufsize;
+	if (std::optional<std::string> query = this->name().query()) {
+		query_string params(*query);
+		_filesize = params.find<long long>("filesize").value_or(_filesize);
+		_interval = params.find<long>("interval").value_or(_interval);
+		bufsize = params.find<long long>("bufsize").value_or(bufsize);
+	}
+	if (_filesize < 0) {
+		throw endpoint_error("filesize must not be negative");
+	}
+	if (_interval < 0) {
+		throw endpoint_error("interval must not be negative");
+	}
+	if (bufsize <= 0) {
+		throw endpoint_error("bufsize must be greater than zero");
+	}
+	_pool = std::make_unique<buffer_pool>(bufsize);
+}
+
+std::unique_ptr<session_writer> pcapng_endpoint::make_session_writer(
+	const std::string& srcid) {
+
+	return std::make_unique<pcapng_session_writer>(*this, srcid);
+}
+
+} /* namespace horace */
+
+extern "C"
+std::unique_ptr<horace::endpoint> make_endpoint(const std::string& name) {
+	return std::make_unique<horace::pcapng_endpoint>(name);
+}
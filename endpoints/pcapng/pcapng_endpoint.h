@@ -0,0 +1,77 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAPNG_ENDPOINT
+#define LIBHOLMES_HORACE_PCAPNG_ENDPOINT
+
+#include "horace/buffer_pool.h"
+#include "horace/endpoint.h"
+#include "horace/session_writer_endpoint.h"
+
+namespace horace {
+
+/** An endpoint class to represent a directory of pcapng files.
+ * Packets are written to a subdirectory for each source ID, with a new
+ * file started for each session, and optionally when the current file
+ * reaches a given size or spans a given length of time.
+ */
+class pcapng_endpoint:
+	public endpoint,
+	public session_writer_endpoint {
+private:
+	/** The pathname of the base directory. */
+	std::string _pathname;
+
+	/** The size at which to start a new file, in octets,
+	 * or 0 for no limit. */
+	long long _filesize;
+
+	/** The time span at which to start a new file, in seconds,
+	 * or 0 for no limit. */
+	long _interval;
+
+	/** A pool of buffers for writing files. */
+	std::unique_ptr<buffer_pool> _pool;
+public:
+	/** Construct pcapng endpoint.
+	 * @param name the name of this endpoint
+	 */
+	explicit pcapng_endpoint(const std::string& name);
+
+	/** Get the pathname of the base directory.
+	 * @return the pathname
+	 */
+	const std::string& pathname() const {
+		return _pathname;
+	}
+
+	/** Get the size at which to start a new file.
+	 * @return the size, in octets, or 0 for no limit
+	 */
+	long long filesize() const {
+		return _filesize;
+	}
+
+	/** Get the time span at which to start a new file.
+	 * @return the time span, in seconds, or 0 for no limit
+	 */
+	long interval() const {
+		return _interval;
+	}
+
+	/** Get the buffer pool for writing files.
+	 * @return the buffer pool
+	 */
+	buffer_pool& pool() const {
+		return *_pool;
+	}
+
+	virtual std::unique_ptr<session_writer> make_session_writer(
+		const std::string& srcid);
+};
+
+} /* namespace horace */
+
+#endif
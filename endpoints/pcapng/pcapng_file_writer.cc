@@ -0,0 +1,194 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "horace/libc_error.h"
+#include "horace/log_message.h"
+#include "horace/logger.h"
+
+#include "pcapng_file_writer.h"
+
+namespace horace {
+
+namespace {
+
+/** The block type of a section header block. */
+const uint32_t type_shb = 0x0a0d0d0a;
+
+/** The block type of an interface description block. */
+const uint32_t type_idb = 1;
+
+/** The block type of an enhanced packet block. */
+const uint32_t type_epb = 6;
+
+/** The byte order magic number. */
+const uint32_t byte_order_magic = 0x1a2b3c4d;
+
+/** The option code for the end of options. */
+const uint16_t opt_endofopt = 0;
+
+/** The option code for the user application of a section. */
+const uint16_t opt_shb_userappl = 4;
+
+/** The option code for the interface name. */
+const uint16_t opt_if_name = 2;
+
+/** The option code for the timestamp resolution. */
+const uint16_t opt_if_tsresol = 9;
+
+/** The option code for the number of packets dropped. */
+const uint16_t opt_epb_dropcount = 4;
+
+/** Append an integer to a block body in host byte order.
+ * @param body the block body
+ * @param value the integer to be appended
+ */
+template<typename T>
+void append(std::string& body, T value) {
+	body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/** Append an option to a block body.
+ * @param body the block body
+ * @param code the option code
+ * @param value the option value
+ */
+void append_option(std::string& body, uint16_t code,
+	const std::string& value) {
+
+	append<uint16_t>(body, code);
+	append<uint16_t>(body, value.length());
+	body.append(value);
+	body.append((-value.length()) & 3, '\0');
+}
+
+} /* anonymous namespace */
+
+pcapng_file_writer::pcapng_file_writer(const std::string& pathname,
+	buffer_pool& pool):
+	_pathname(pathname),
+	_part_pathname(pathname + ".part"),
+	_fd(_part_pathname, O_WRONLY | O_CREAT | O_EXCL),
+	_fow(_fd, pool),
+	_size(0),
+	_closed(false) {
+
+	std::string body;
+	append<uint32_t>(body, byte_order_magic);
+	append<uint16_t>(body, 1);
+	append<uint16_t>(body, 0);
+	append<int64_t>(body, -1);
+	append_option(body, opt_shb_userappl, "horace");
+	append_option(body, opt_endofopt, "");
+	_write_block(type_shb, body);
+
+	if (log->enabled(logger::log_info)) {
+		log_message msg(*log, logger::log_info);
+		msg << "opened pcapng file " << _part_pathname;
+	}
+}
+
+pcapng_file_writer::~pcapng_file_writer() {
+	try {
+		close();
+	} catch (std::exception& ex) {
+		if (log->enabled(logger::log_err)) {
+			log_message msg(*log, logger::log_err);
+			msg << ex.what();
+		}
+	}
+}
+
+void pcapng_file_writer::_write_block(uint32_t type,
+	const std::string& body) {
+
+	uint32_t length = body.length() + 12;
+	_fow.write(&type, sizeof(type));
+	_fow.write(&length, sizeof(length));
+	_fow.write(body.data(), body.length());
+	_fow.write(&length, sizeof(length));
+	_size += length;
+}
+
+void pcapng_file_writer::write_idb(unsigned int linktype,
+	const std::string& name) {
+
+	std::string body;
+	append<uint16_t>(body, linktype);
+	append<uint16_t>(body, 0);
+	append<uint32_t>(body, 0);
+	if (!name.empty()) {
+		append_option(body, opt_if_name, name);
+	}
+	append_option(body, opt_if_tsresol, std::string(1, 9));
+	append_option(body, opt_endofopt, "");
+	_write_block(type_idb, body);
+}
+
+void pcapng_file_writer::write_epb(unsigned int ifindex,
+	const struct timespec* ts, const void* content, size_t snaplen,
+	size_t origlen, uint64_t dropped) {
+
+	// The header and trailer are assembled separately, so that the
+	// packet content can be written without copying it into a
+	// temporary buffer.
+	uint64_t nsec = (ts) ?
+		uint64_t(ts->tv_sec) * 1000000000 + ts->tv_nsec : 0;
+	size_t padding = (-snaplen) & 3;
+	size_t optlen = (dropped) ? 16 : 0;
+	uint32_t length = 32 + snaplen + padding + optlen;
+
+	uint32_t header[7] = {
+		type_epb, length, ifindex,
+		uint32_t(nsec >> 32), uint32_t(nsec),
+		uint32_t(snaplen), uint32_t(origlen)};
+	_fow.write(header, sizeof(header));
+	_fow.write(content, snaplen);
+
+	unsigned char trailer[3 + 16 + 4] = {0};
+	unsigned char* p = trailer + padding;
+	if (dropped) {
+		uint16_t opthdr[2] = {opt_epb_dropcount, 8};
+		memcpy(p, opthdr, sizeof(opthdr));
+		memcpy(p + 4, &dropped, sizeof(dropped));
+		p += 16;
+	}
+	memcpy(p, &length, sizeof(length));
+	p += sizeof(length);
+	_fow.write(trailer, p - trailer);
+	_size += length;
+}
+
+void pcapng_file_writer::flush() {
+	_fow.flush();
+}
+
+void pcapng_file_writer::sync() {
+	_fow.flush();
+	_fd.fsync();
+}
+
+void pcapng_file_writer::close() {
+	if (_closed) {
+		return;
+	}
+	_closed = true;
+	sync();
+	if (rename(_part_pathname.c_str(), _pathname.c_str()) == -1) {
+		throw libc_error();
+	}
+
+	if (log->enabled(logger::log_info)) {
+		log_message msg(*log, logger::log_info);
+		msg << "closed pcapng file " << _pathname;
+	}
+}
+
+} /* namespace horace */
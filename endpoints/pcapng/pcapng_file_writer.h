@@ -0,0 +1,101 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAPNG_FILE_WRITER
+#define LIBHOLMES_HORACE_PCAPNG_FILE_WRITER
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+#include "horace/file_descriptor.h"
+#include "horace/file_octet_writer.h"
+
+namespace horace {
+
+class buffer_pool;
+
+/** A class for writing a pcapng file.
+ * The file is written under a temporary name, then renamed once it
+ * is complete, so that partially written files are not mistaken for
+ * complete ones. Blocks are written in host byte order.
+ */
+class pcapng_file_writer {
+private:
+	/** The pathname of the completed file. */
+	std::string _pathname;
+
+	/** The pathname of the file while it is being written. */
+	std::string _part_pathname;
+
+	/** The file descriptor. */
+	file_descriptor _fd;
+
+	/** An octet writer for the file. */
+	file_octet_writer _fow;
+
+	/** The number of octets written. */
+	uint64_t _size;
+
+	/** True if the file has been closed, otherwise false. */
+	bool _closed;
+
+	/** Write a block which has no content other than its body.
+	 * @param type the block type
+	 * @param body the block body, including any options
+	 */
+	void _write_block(uint32_t type, const std::string& body);
+public:
+	/** Create pcapng file and write section header.
+	 * @param pathname the pathname of the completed file
+	 * @param pool the pool from which to acquire a buffer
+	 */
+	pcapng_file_writer(const std::string& pathname, buffer_pool& pool);
+
+	/** Close the file if that has not already been done.
+	 * Errors are logged but not reported.
+	 */
+	~pcapng_file_writer();
+
+	/** Get the number of octets written.
+	 * @return the number of octets
+	 */
+	uint64_t size() const {
+		return _size;
+	}
+
+	/** Write an interface description block.
+	 * Timestamps are written with nanosecond resolution.
+	 * @param linktype the link-layer header type
+	 * @param name the interface name, or the empty string if none
+	 */
+	void write_idb(unsigned int linktype, const std::string& name);
+
+	/** Write an enhanced packet block.
+	 * @param ifindex the interface index
+	 * @param ts the timestamp, or 0 if none
+	 * @param content the packet content
+	 * @param snaplen the captured length of the packet, in octets
+	 * @param origlen the original length of the packet, in octets
+	 * @param dropped the number of packets dropped since the previous
+	 *  packet on this interface
+	 */
+	void write_epb(unsigned int ifindex, const struct timespec* ts,
+		const void* content, size_t snaplen, size_t origlen,
+		uint64_t dropped);
+
+	/** Flush any buffered blocks to the file. */
+	void flush();
+
+	/** Flush any buffered blocks, then sync the file to disc. */
+	void sync();
+
+	/** Sync the file, then rename it to its completed pathname. */
+	void close();
+};
+
+} /* namespace horace */
+
+#endif
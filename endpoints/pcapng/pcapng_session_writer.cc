@@ -0,0 +1,225 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cerrno>
+#include <cstdio>
+#include <set>
+
+#include <sys/stat.h>
+
+#include "horace/libc_error.h"
+#include "horace/record.h"
+#include "horace/compound_attribute.h"
+#include "horace/signed_integer_attribute.h"
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/string_attribute.h"
+#include "horace/timestamp_attribute.h"
+#include "horace/binary_ref_attribute.h"
+
+#include "pcapng_endpoint.h"
+#include "pcapng_session_writer.h"
+
+namespace horace {
+
+pcapng_session_writer::pcapng_session_writer(pcapng_endpoint& dst_ep,
+	const std::string& srcid):
+	simple_session_writer(srcid),
+	_dst_ep(&dst_ep),
+	_pathname(dst_ep.pathname() + "/" + srcid),
+	_session_ts({0}),
+	_file_ts({0}),
+	_stats("pcapng." + srcid),
+	_files(_stats.counter("files")),
+	_packets(_stats.counter("packets")) {
+
+	if (mkdir(_pathname.c_str(), 0777) == -1) {
+		if (errno != EEXIST) {
+			throw libc_error();
+		}
+	}
+}
+
+void pcapng_session_writer::_begin_file(uint64_t seqnum,
+	const struct timespec* ts) {
+
+	if (_pfw) {
+		_pfw->close();
+	}
+
+	char tsbuf[32];
+	struct tm tm;
+	gmtime_r(&_session_ts.tv_sec, &tm);
+	strftime(tsbuf, sizeof(tsbuf), "%Y%m%dT%H%M%S", &tm);
+	char filename[80];
+	snprintf(filename, sizeof(filename), "%s.%09ldZ-%012llu.pcapng",
+		tsbuf, long(_session_ts.tv_nsec),
+		static_cast<unsigned long long>(seqnum));
+
+	_pfw = std::make_unique<pcapng_file_writer>(
+		_pathname + "/" + filename, _dst_ep->pool());
+	for (const auto& iface : _interfaces) {
+		_pfw->write_idb(iface.linktype, iface.name);
+	}
+	_file_ts = (ts) ? *ts : timespec{0};
+	_files.add();
+}
+
+bool pcapng_session_writer::_rotate_needed(const struct timespec* ts) const {
+	if (!_pfw) {
+		return true;
+	}
+	if (_dst_ep->filesize() && (_pfw->size() >= _dst_ep->filesize())) {
+		return true;
+	}
+	if (_dst_ep->interval() && ts && _file_ts.tv_sec &&
+		(ts->tv_sec - _file_ts.tv_sec >= _dst_ep->interval())) {
+
+		return true;
+	}
+	return false;
+}
+
+void pcapng_session_writer::handle_session_start(const record& srec) {
+	if (_pfw) {
+		_pfw->close();
+		_pfw.reset();
+	}
+	_session_ts = srec.find_ts().content();
+	_interfaces.clear();
+	_ifindex.clear();
+	_roles.clear();
+
+	// Attribute definitions precede their use, so the attribute IDs
+	// needed to interpret channel definitions are available by the
+	// time they are encountered.
+	std::set<int> linktype_attrids;
+	std::set<int> ifname_attrids;
+	for (const auto& attr : srec.attributes()) {
+		if (attr->attrid() == attrid_attr_def) {
+			const attribute_list& def =
+				dynamic_cast<const compound_attribute&>(*attr).
+				content();
+			int attrid = def.find_one<signed_integer_attribute>(
+				attrid_attr_id).content();
+			const std::string& label = def.find_one<string_attribute>(
+				attrid_attr_label).content();
+			if (label == "packet") {
+				_roles[attrid] = role_packet;
+			} else if (label == "packet_len") {
+				_roles[attrid] = role_origlen;
+			} else if (label == "repeat") {
+				_roles[attrid] = role_repeat;
+			} else if (label == "if_linktype") {
+				linktype_attrids.insert(attrid);
+			} else if (label == "if_name") {
+				ifname_attrids.insert(attrid);
+			}
+		} else if (attr->attrid() == attrid_chan_def) {
+			const attribute_list& def =
+				dynamic_cast<const compound_attribute&>(*attr).
+				content();
+			interface iface = {0, "", 0};
+			bool has_linktype = false;
+			for (const auto& subattr : def.attributes()) {
+				if (linktype_attrids.count(subattr->attrid())) {
+					iface.linktype = dynamic_cast<const
+						unsigned_integer_attribute&>(
+						*subattr).content();
+					has_linktype = true;
+				} else if (ifname_attrids.count(subattr->attrid())) {
+					iface.name = dynamic_cast<const
+						string_attribute&>(*subattr).content();
+				}
+			}
+			if (!has_linktype) {
+				continue;
+			}
+			int channel = def.find_one<signed_integer_attribute>(
+				attrid_chan_id).content();
+			_ifindex[channel] = _interfaces.size();
+			_interfaces.push_back(iface);
+		}
+	}
+}
+
+void pcapng_session_writer::handle_session_end(const record& erec) {
+	if (_pfw) {
+		_pfw->close();
+		_pfw.reset();
+	}
+}
+
+void pcapng_session_writer::handle_sync(const record& crec) {
+	if (_pfw) {
+		_pfw->sync();
+	}
+}
+
+void pcapng_session_writer::handle_event(const record& rec) {
+	auto f = _ifindex.find(rec.channel_id());
+	if (f == _ifindex.end()) {
+		return;
+	}
+	interface& iface = _interfaces[f->second];
+
+	const struct timespec* ts = 0;
+	const binary_ref_attribute* pkt_attr = 0;
+	const unsigned_integer_attribute* origlen_attr = 0;
+	const unsigned_integer_attribute* rpt_attr = 0;
+	for (const auto& attr : rec.attributes()) {
+		if (attr->attrid() == attrid_ts) {
+			ts = &dynamic_cast<const timestamp_attribute&>(
+				*attr).content();
+			continue;
+		}
+		auto role = _roles.find(attr->attrid());
+		if (role == _roles.end()) {
+			continue;
+		}
+		switch (role->second) {
+		case role_packet:
+			pkt_attr = dynamic_cast<const binary_ref_attribute*>(attr);
+			break;
+		case role_origlen:
+			origlen_attr = dynamic_cast<
+				const unsigned_integer_attribute*>(attr);
+			break;
+		case role_repeat:
+			rpt_attr = dynamic_cast<
+				const unsigned_integer_attribute*>(attr);
+			break;
+		}
+	}
+
+	// Records without packet content report dropped packets, which
+	// are attached to the next packet written for the interface.
+	if (!pkt_attr) {
+		if (rpt_attr) {
+			iface.dropped += rpt_attr->content();
+		}
+		return;
+	}
+
+	if (_rotate_needed(ts)) {
+		_begin_file(rec.find_seqnum().content(), ts);
+	} else if (ts && !_file_ts.tv_sec) {
+		_file_ts = *ts;
+	}
+
+	size_t snaplen = pkt_attr->length();
+	size_t origlen = (origlen_attr) ? origlen_attr->content() : snaplen;
+	_pfw->write_epb(f->second, ts, pkt_attr->content(), snaplen, origlen,
+		iface.dropped);
+	iface.dropped = 0;
+	_packets.add();
+}
+
+void pcapng_session_writer::flush() {
+	if (_pfw) {
+		_pfw->flush();
+	}
+}
+
+} /* namespace horace */
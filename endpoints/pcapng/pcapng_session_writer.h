@@ -0,0 +1,121 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_PCAPNG_SESSION_WRITER
+#define LIBHOLMES_HORACE_PCAPNG_SESSION_WRITER
+
+#include <map>
+#include <vector>
+
+#include "horace/stats_group.h"
+#include "horace/simple_session_writer.h"
+
+#include "pcapng_file_writer.h"
+
+namespace horace {
+
+class pcapng_endpoint;
+
+/** A class for writing sessions to pcapng files.
+ * Each channel which has a link-layer header type (as defined by the
+ * if_linktype attribute) is written as an interface. Events from other
+ * channels are discarded.
+ *
+ * Files are named after the session timestamp and the sequence number
+ * of the first packet which they contain. This allows sessions to be
+ * converted concurrently in parts, for example one spoolfile at a time.
+ */
+class pcapng_session_writer:
+	public simple_session_writer {
+private:
+	/** A structure to describe an interface. */
+	struct interface {
+		/** The link-layer header type. */
+		unsigned int linktype;
+
+		/** The interface name, or the empty string if unknown. */
+		std::string name;
+
+		/** The number of packets dropped since the last one
+		 * written. */
+		uint64_t dropped;
+	};
+
+	/** The destination endpoint. */
+	pcapng_endpoint* _dst_ep;
+
+	/** The pathname of the directory for this source ID. */
+	std::string _pathname;
+
+	/** The timestamp of the current session. */
+	struct timespec _session_ts;
+
+	/** The interfaces for the current session. */
+	std::vector<interface> _interfaces;
+
+	/** The interface index for each channel, indexed by channel ID. */
+	std::map<int, unsigned int> _ifindex;
+
+	/** An enumeration to identify the role of an attribute. */
+	enum attr_role {
+		/** The packet content. */
+		role_packet,
+		/** The original packet length. */
+		role_origlen,
+		/** The repeat count. */
+		role_repeat
+	};
+
+	/** The role of each attribute which has one, indexed by
+	 * attribute ID. The same label may be defined more than once
+	 * within a session (for example, once per channel), so there
+	 * may be more than one attribute ID with a given role. */
+	std::map<int, attr_role> _roles;
+
+	/** The current file, or null if none. */
+	std::unique_ptr<pcapng_file_writer> _pfw;
+
+	/** The timestamp of the first packet in the current file. */
+	struct timespec _file_ts;
+
+	/** Statistics for this session writer. */
+	stats_group _stats;
+
+	/** The number of files written. */
+	stats_counter& _files;
+
+	/** The number of packets written. */
+	stats_counter& _packets;
+
+	/** Start a new file.
+	 * @param seqnum the sequence number of the first packet
+	 * @param ts the timestamp of the first packet, or 0 if none
+	 */
+	void _begin_file(uint64_t seqnum, const struct timespec* ts);
+
+	/** Determine whether a new file is needed.
+	 * @param ts the timestamp of the next packet, or 0 if none
+	 * @return true if a new file is needed, otherwise false
+	 */
+	bool _rotate_needed(const struct timespec* ts) const;
+protected:
+	virtual void handle_session_start(const record& srec);
+	virtual void handle_session_end(const record& erec);
+	virtual void handle_sync(const record& crec);
+	virtual void handle_event(const record& rec);
+public:
+	/** Construct pcapng session writer.
+	 * @param dst_ep the destination endpoint
+	 * @param srcid the required source ID
+	 */
+	pcapng_session_writer(pcapng_endpoint& dst_ep,
+		const std::string& srcid);
+
+	virtual void flush();
+};
+
+} /* namespace horace */
+
+#endif
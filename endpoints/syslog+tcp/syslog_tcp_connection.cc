@@ -0,0 +1,150 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/socket.h>
+
+#include "horace/libc_error.h"
+#include "horace/syslog_error.h"
+
+#include "syslog_tcp_connection.h"
+
+namespace horace {
+
+namespace {
+
+/** The initial buffer capacity, in octets. */
+const size_t initial_capacity = 0x4000;
+
+/** An allowance for the octet count which precedes a message when
+ * octet-counting framing is used, in octets. */
+const size_t header_allowance = 32;
+
+/** Test whether a character is a decimal digit.
+ * @param ch the character to be tested
+ * @return true if a digit, otherwise false
+ */
+inline bool is_digit(char ch) {
+	return (ch >= '0') && (ch <= '9');
+}
+
+} /* anonymous namespace */
+
+syslog_tcp_connection::syslog_tcp_connection(socket_descriptor&& sock,
+	const std::string& peername, size_t maxmsg):
+	_sock(std::move(sock)),
+	_peername(peername),
+	_maxmsg(maxmsg),
+	_limit(maxmsg + header_allowance),
+	_capacity(std::min(initial_capacity, _limit)),
+	_rdpos(0),
+	_wrpos(0),
+	_eof(false) {
+
+	_buffer = std::make_unique<char[]>(_capacity);
+}
+
+void syslog_tcp_connection::receive() {
+	// Move any partial frame to the start of the buffer. This is
+	// normally short, because the buffer is only refilled once all
+	// complete frames have been extracted.
+	if (_rdpos != 0) {
+		std::memmove(_buffer.get(), _buffer.get() + _rdpos,
+			_wrpos - _rdpos);
+		_wrpos -= _rdpos;
+		_rdpos = 0;
+	}
+
+	// Grow the buffer if it is full.
+	if (_wrpos == _capacity) {
+		if (_capacity == _limit) {
+			throw syslog_error("message too long");
+		}
+		size_t capacity = std::min(_capacity * 2, _limit);
+		std::unique_ptr<char[]> buffer =
+			std::make_unique<char[]>(capacity);
+		std::memcpy(buffer.get(), _buffer.get(), _wrpos);
+		_buffer = std::move(buffer);
+		_capacity = capacity;
+	}
+
+	ssize_t count = ::recv(_sock, _buffer.get() + _wrpos,
+		_capacity - _wrpos, 0);
+	if (count == -1) {
+		if ((errno == EWOULDBLOCK) || (errno == EAGAIN) ||
+			(errno == EINTR)) {
+			return;
+		}
+		throw libc_error();
+	}
+	if (count == 0) {
+		_eof = true;
+	}
+	_wrpos += count;
+}
+
+bool syslog_tcp_connection::next_frame(const char*& data, size_t& length) {
+	while (_rdpos != _wrpos) {
+		const char* content = _buffer.get() + _rdpos;
+		size_t avail = _wrpos - _rdpos;
+
+		if (is_digit(*content)) {
+			// Octet-counting framing.
+			size_t index = 0;
+			length = 0;
+			while ((index != avail) && is_digit(content[index])) {
+				length = length * 10 + (content[index++] - '0');
+				if (length > _maxmsg) {
+					throw syslog_error("message too long");
+				}
+			}
+			if ((index != avail) && (content[index] != ' ')) {
+				throw syslog_error("' ' expected");
+			}
+			if ((index == avail) || (avail - index - 1 < length)) {
+				if (_eof) {
+					throw syslog_error("truncated frame");
+				}
+				return false;
+			}
+			index += 1;
+			_rdpos += index + length;
+			data = content + index;
+		} else {
+			// Non-transparent framing, terminated by a line feed.
+			const char* lf = static_cast<const char*>(
+				std::memchr(content, '\n', avail));
+			if (lf) {
+				length = lf - content;
+				_rdpos += length + 1;
+			} else if (_eof) {
+				length = avail;
+				_rdpos += length;
+			} else {
+				if (avail > _maxmsg) {
+					throw syslog_error("message too long");
+				}
+				return false;
+			}
+			if (length > _maxmsg) {
+				throw syslog_error("message too long");
+			}
+			if (length && (content[length - 1] == '\r')) {
+				length -= 1;
+			}
+			data = content;
+		}
+
+		// Empty frames are skipped.
+		if (length != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} /* namespace horace */
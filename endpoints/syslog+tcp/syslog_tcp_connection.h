@@ -0,0 +1,108 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYSLOG_TCP_CONNECTION
+#define LIBHOLMES_HORACE_SYSLOG_TCP_CONNECTION
+
+#include <memory>
+#include <string>
+
+#include "horace/socket_descriptor.h"
+
+namespace horace {
+
+/** A class to represent an inbound Syslog TCP connection.
+ * Data is received into a per-connection buffer, from which it is split
+ * into messages in accordance with RFC 6587. Both octet-counting and
+ * non-transparent (newline-delimited) framing are supported, and they
+ * are distinguished on a per-message basis: a frame which begins with
+ * a digit uses octet-counting, whereas a frame which begins with any
+ * other character is terminated by a line feed.
+ *
+ * The buffer is sized initially for several typical messages, and grows
+ * on demand as far as is needed to hold a message of the maximum
+ * permitted length. Frames returned by next_frame() refer to the buffer,
+ * and remain valid until the next call to receive().
+ */
+class syslog_tcp_connection {
+private:
+	/** The socket for this connection. */
+	socket_descriptor _sock;
+
+	/** The address of the remote peer, for use in log messages. */
+	std::string _peername;
+
+	/** The maximum message length, in octets. */
+	size_t _maxmsg;
+
+	/** The maximum buffer capacity, in octets. */
+	size_t _limit;
+
+	/** The buffer for received data. */
+	std::unique_ptr<char[]> _buffer;
+
+	/** The current buffer capacity, in octets. */
+	size_t _capacity;
+
+	/** The offset of the first octet in the buffer which has not yet
+	 * been returned as part of a frame. */
+	size_t _rdpos;
+
+	/** The offset at which to write the next octet received. */
+	size_t _wrpos;
+
+	/** True if the remote peer has closed the connection,
+	 * otherwise false. */
+	bool _eof;
+public:
+	/** Construct Syslog TCP connection.
+	 * @param sock the socket for the connection, which should be
+	 *  non-blocking
+	 * @param peername the address of the remote peer
+	 * @param maxmsg the maximum message length, in octets
+	 */
+	syslog_tcp_connection(socket_descriptor&& sock,
+		const std::string& peername, size_t maxmsg);
+
+	/** Get the socket for this connection.
+	 * @return the socket
+	 */
+	const socket_descriptor& socket() const {
+		return _sock;
+	}
+
+	/** Get the address of the remote peer.
+	 * @return the address
+	 */
+	const std::string& peername() const {
+		return _peername;
+	}
+
+	/** Test whether the remote peer has closed the connection.
+	 * @return true if closed, otherwise false
+	 */
+	bool eof() const {
+		return _eof;
+	}
+
+	/** Receive whatever data is available from the socket.
+	 * This function does not block. Any frames previously returned by
+	 * next_frame() are invalidated.
+	 */
+	void receive();
+
+	/** Extract the next complete frame from the buffer.
+	 * If the remote peer has closed the connection then any remaining
+	 * newline-delimited content is treated as a final frame.
+	 * @param data a reference to the returned frame content
+	 * @param length a reference to the returned frame length
+	 * @return true if a frame was returned, otherwise false
+	 */
+	bool next_frame(const char*& data, size_t& length);
+};
+
+} /* namespace horace */
+
+#endif
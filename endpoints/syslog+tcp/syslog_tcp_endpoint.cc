@@ -0,0 +1,55 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/endpoint_error.h"
+#include "horace/query_string.h"
+
+#include "syslog_tcp_endpoint.h"
+#include "syslog_tcp_event_reader.h"
+
+namespace horace {
+
+syslog_tcp_endpoint::syslog_tcp_endpoint(const std::string& name):
+	endpoint(name),
+	_maxmsg(65536),
+	_maxconn(1024) {
+
+	std::string hostportname = this->name().authority().value_or("");
+	size_t index = hostportname.rfind(':');
+	if (index == std::string::npos) {
+		_hostname = hostportname;
+		_portname = "601";
+	} else {
+		_hostname = hostportname.substr(0, index);
+		_portname = hostportname.substr(
+			index + 1, std::string::npos);
+	}
+
+	std::optional<std::string> query = this->name().query();
+	if (query) {
+		query_string params(*query);
+		_maxmsg = params.find<long>("maxmsg").value_or(_maxmsg);
+		_maxconn = params.find<long>("maxconn").value_or(_maxconn);
+	}
+	if (_maxmsg < 1) {
+		throw endpoint_error("maxmsg must be at least 1");
+	}
+	if (_maxconn < 1) {
+		throw endpoint_error("maxconn must be at least 1");
+	}
+}
+
+std::unique_ptr<event_reader> syslog_tcp_endpoint::make_event_reader(
+	session_builder& session) {
+
+	return std::make_unique<syslog_tcp_event_reader>(*this, session);
+};
+
+} /* namespace horace */
+
+extern "C"
+std::unique_ptr<horace::endpoint> make_endpoint(const std::string& name) {
+	return std::make_unique<horace::syslog_tcp_endpoint>(name);
+}
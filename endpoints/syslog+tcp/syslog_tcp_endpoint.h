@@ -0,0 +1,75 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYSLOG_TCP_ENDPOINT
+#define LIBHOLMES_HORACE_SYSLOG_TCP_ENDPOINT
+
+#include <string>
+
+#include "horace/endpoint.h"
+#include "horace/event_reader_endpoint.h"
+
+namespace horace {
+
+/** An endpoint class to represent a Syslog TCP listening socket. */
+class syslog_tcp_endpoint:
+	public endpoint,
+	public event_reader_endpoint {
+private:
+	/** The hostname. */
+	std::string _hostname;
+
+	/** The portname. */
+	std::string _portname;
+
+	/** The maximum message length, in octets. */
+	long _maxmsg;
+
+	/** The maximum number of concurrent connections. */
+	long _maxconn;
+public:
+	/** Construct Syslog over TCP endpoint.
+	 * @param name the name of this endpoint
+	 */
+	explicit syslog_tcp_endpoint(const std::string& name);
+
+	virtual std::unique_ptr<event_reader> make_event_reader(
+		session_builder& session);
+
+	/** Get the hostname.
+	 * @return the hostname
+	 */
+	const std::string& hostname() const {
+		return _hostname;
+	}
+
+	/** Get the portname.
+	 * @return the portname
+	 */
+	const std::string& portname() const {
+		return _portname;
+	}
+
+	/** Get the maximum message length.
+	 * A connection which attempts to send a longer message is closed.
+	 * @return the maximum message length, in octets
+	 */
+	long maxmsg() const {
+		return _maxmsg;
+	}
+
+	/** Get the maximum number of concurrent connections.
+	 * Connections in excess of this limit are closed immediately
+	 * after they have been accepted.
+	 * @return the maximum number of connections
+	 */
+	long maxconn() const {
+		return _maxconn;
+	}
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,215 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <poll.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+
+#include "horace/libc_error.h"
+#include "horace/log_message.h"
+#include "horace/logger.h"
+#include "horace/address_info.h"
+#include "horace/attribute_list.h"
+#include "horace/session_builder.h"
+#include "horace/syslog_error.h"
+#include "horace/syslog_parser.h"
+
+#include "syslog_tcp_event_reader.h"
+#include "syslog_tcp_endpoint.h"
+
+namespace horace {
+
+namespace {
+
+/** The maximum number of events to collect per call to epoll_wait. */
+const int max_events = 64;
+
+/** Format a socket address for use in log messages.
+ * @param addr the socket address
+ * @param addrlen the length of the socket address
+ * @return the formatted address
+ */
+std::string format_peername(const struct sockaddr* addr, socklen_t addrlen) {
+	char host[NI_MAXHOST];
+	char serv[NI_MAXSERV];
+	if (getnameinfo(addr, addrlen, host, sizeof(host), serv, sizeof(serv),
+		NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+		return "unknown";
+	}
+	if (addr->sa_family == AF_INET6) {
+		return std::string("[") + host + "]:" + serv;
+	}
+	return std::string(host) + ":" + serv;
+}
+
+} /* anonymous namespace */
+
+class record;
+
+syslog_tcp_event_reader::syslog_tcp_event_reader(
+	const syslog_tcp_endpoint& ep, session_builder& session):
+	_ep(&ep),
+	_epfd(::epoll_create1(EPOLL_CLOEXEC)) {
+
+	if (!_epfd) {
+		throw libc_error();
+	}
+
+	attribute_list attrs;
+	_channel = session.define_channel("log", std::move(attrs));
+	_builder = std::make_unique<log_record_builder>(session, _channel);
+
+	address_info ai(ep.hostname(), ep.portname(), SOCK_STREAM, true);
+	_lsock = ai.make_socket();
+	_lsock.interruptible(true);
+	_lsock.setsockopt<int>(SOL_SOCKET, SO_REUSEADDR, 1);
+	ai.bind(_lsock);
+	_lsock.listen();
+
+	// The listening socket is distinguished from connections by
+	// having a null data pointer.
+	struct epoll_event event = {0};
+	event.events = EPOLLIN;
+	event.data.ptr = 0;
+	if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _lsock, &event) == -1) {
+		throw libc_error();
+	}
+
+	if (log->enabled(logger::log_notice)) {
+		log_message msg(*log, logger::log_notice);
+		msg << "listening for syslog on " << _ep->hostname()
+			<< ":" << _ep->portname() << " (tcp)";
+	}
+}
+
+void syslog_tcp_event_reader::_accept() {
+	while (true) {
+		struct sockaddr_storage addr;
+		socklen_t addrlen = sizeof(addr);
+		int fd = ::accept4(_lsock,
+			reinterpret_cast<struct sockaddr*>(&addr), &addrlen,
+			SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd == -1) {
+			if ((errno == EWOULDBLOCK) || (errno == EAGAIN) ||
+				(errno == EINTR) || (errno == ECONNABORTED)) {
+				return;
+			}
+			throw libc_error();
+		}
+		socket_descriptor sock(fd);
+		std::string peername = format_peername(
+			reinterpret_cast<struct sockaddr*>(&addr), addrlen);
+
+		if (_conns.size() >= static_cast<size_t>(_ep->maxconn())) {
+			if (log->enabled(logger::log_warning)) {
+				log_message msg(*log, logger::log_warning);
+				msg << "rejected syslog connection from "
+					<< peername << ": too many connections";
+			}
+			continue;
+		}
+
+		auto conn = std::make_unique<syslog_tcp_connection>(
+			std::move(sock), peername, _ep->maxmsg());
+		struct epoll_event event = {0};
+		event.events = EPOLLIN;
+		event.data.ptr = conn.get();
+		if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &event) == -1) {
+			throw libc_error();
+		}
+		_conns[fd] = std::move(conn);
+
+		if (log->enabled(logger::log_info)) {
+			log_message msg(*log, logger::log_info);
+			msg << "accepted syslog connection from " << peername;
+		}
+	}
+}
+
+void syslog_tcp_event_reader::_close(syslog_tcp_connection& conn) {
+	if (log->enabled(logger::log_info)) {
+		log_message msg(*log, logger::log_info);
+		msg << "closed syslog connection from " << conn.peername();
+	}
+
+	// Closing the socket removes it from the epoll instance.
+	_conns.erase(conn.socket());
+}
+
+void syslog_tcp_event_reader::_poll() {
+	// The epoll instance is itself pollable, which allows the wait
+	// to be interrupted if the process is terminating.
+	_epfd.wait(POLLIN);
+
+	struct epoll_event events[max_events];
+	int count = ::epoll_wait(_epfd, events, max_events, 0);
+	if (count == -1) {
+		if (errno == EINTR) {
+			return;
+		}
+		throw libc_error();
+	}
+
+	for (int i = 0; i != count; ++i) {
+		syslog_tcp_connection* conn =
+			static_cast<syslog_tcp_connection*>(events[i].data.ptr);
+		if (!conn) {
+			_accept();
+			continue;
+		}
+
+		try {
+			conn->receive();
+		} catch (std::exception& ex) {
+			if (log->enabled(logger::log_warning)) {
+				log_message msg(*log, logger::log_warning);
+				msg << "error on syslog connection from "
+					<< conn->peername() << ": " << ex.what();
+			}
+			_close(*conn);
+			continue;
+		}
+		_pending.push_back(conn);
+	}
+}
+
+const record& syslog_tcp_event_reader::read() {
+	while (true) {
+		while (!_pending.empty()) {
+			syslog_tcp_connection* conn = _pending.front();
+			const char* data = 0;
+			size_t length = 0;
+			bool found = false;
+			try {
+				found = conn->next_frame(data, length);
+			} catch (syslog_error& ex) {
+				if (log->enabled(logger::log_warning)) {
+					log_message msg(*log, logger::log_warning);
+					msg << "invalid framing on syslog connection from "
+						<< conn->peername() << ": " << ex.what();
+				}
+				_pending.pop_front();
+				_close(*conn);
+				continue;
+			}
+
+			if (found) {
+				syslog_parser parser(data, length);
+				parser.read_message(*_builder);
+				return _builder->build();
+			}
+
+			// No further complete frames are buffered for this
+			// connection, so move on to the next.
+			_pending.pop_front();
+			if (conn->eof()) {
+				_close(*conn);
+			}
+		}
+		_poll();
+	}
+}
+
+} /* namespace horace */
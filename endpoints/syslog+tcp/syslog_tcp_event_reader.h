@@ -0,0 +1,89 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYSLOG_TCP_EVENT_READER
+#define LIBHOLMES_HORACE_SYSLOG_TCP_EVENT_READER
+
+#include <memory>
+#include <deque>
+#include <unordered_map>
+
+#include "horace/file_descriptor.h"
+#include "horace/socket_descriptor.h"
+#include "horace/record.h"
+#include "horace/log_record_builder.h"
+#include "horace/event_reader.h"
+
+#include "syslog_tcp_connection.h"
+
+namespace horace {
+
+class session_builder;
+class syslog_tcp_endpoint;
+
+/** A class for reading events from Syslog TCP connections.
+ * Any number of connections can be accepted concurrently. They are
+ * multiplexed using a single epoll instance, and serviced by the thread
+ * which calls read(), so there is no thread per connection.
+ *
+ * Each time the epoll instance reports activity, one receive is performed
+ * for each ready connection, after which all complete messages buffered
+ * by those connections are parsed before the next receive. This bounds
+ * the amount of data buffered per connection, and prevents any one
+ * connection from starving the others. When the parser falls behind,
+ * unread data accumulates in the socket receive queues, so that TCP flow
+ * control pushes back on the senders rather than messages being lost.
+ */
+class syslog_tcp_event_reader:
+	public event_reader {
+private:
+	/** The endpoint from which to capture. */
+	const syslog_tcp_endpoint* _ep;
+
+	/** The channel number to use for captured events. */
+	int _channel;
+
+	/** The listening socket. */
+	socket_descriptor _lsock;
+
+	/** The epoll instance. */
+	file_descriptor _epfd;
+
+	/** The open connections, indexed by file descriptor. */
+	std::unordered_map<int, std::unique_ptr<syslog_tcp_connection>> _conns;
+
+	/** Connections which may have complete frames buffered. */
+	std::deque<syslog_tcp_connection*> _pending;
+
+	/** A builder for log records. */
+	std::unique_ptr<log_record_builder> _builder;
+
+	/** Accept any pending inbound connections. */
+	void _accept();
+
+	/** Close a connection.
+	 * The connection must not be on the pending list.
+	 * @param conn the connection to be closed
+	 */
+	void _close(syslog_tcp_connection& conn);
+
+	/** Wait for activity, then receive from each ready connection.
+	 * Connections which receive data or are closed by the remote peer
+	 * are added to the pending list.
+	 */
+	void _poll();
+public:
+	/** Construct syslog event reader.
+	 * @param ep the endpoint to read from
+	 */
+	explicit syslog_tcp_event_reader(const syslog_tcp_endpoint& ep,
+		session_builder& builder);
+
+	virtual const record& read();
+};
+
+} /* namespace horace */
+
+#endif
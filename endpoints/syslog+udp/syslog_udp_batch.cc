@@ -0,0 +1,67 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/socket_descriptor.h"
+
+#include "syslog_udp_batch.h"
+
+namespace horace {
+
+syslog_udp_batch::syslog_udp_batch(unsigned int capacity):
+	_capacity(capacity),
+	_buffer(std::make_unique<char[]>(capacity * slot_size)),
+	_control_size(CMSG_SPACE(sizeof(uint32_t))),
+	_iov(std::make_unique<struct iovec[]>(capacity)),
+	_messages(std::make_unique<struct mmsghdr[]>(capacity)),
+	_count(0),
+	_dropped(0) {
+
+	_control = std::make_unique<char[]>(capacity * _control_size);
+	for (unsigned int i = 0; i != capacity; ++i) {
+		_iov[i].iov_base = _buffer.get() + i * slot_size;
+		_iov[i].iov_len = slot_size;
+
+		struct msghdr& message = _messages[i].msg_hdr;
+		message.msg_name = 0;
+		message.msg_namelen = 0;
+		message.msg_iov = &_iov[i];
+		message.msg_iovlen = 1;
+		message.msg_control = _control.get() + i * _control_size;
+		message.msg_flags = 0;
+	}
+}
+
+void syslog_udp_batch::receive(socket_descriptor& sock,
+	uint32_t& drop_count) {
+
+	// The control buffer lengths are overwritten by each call to
+	// recvmmsg, so must be reset beforehand.
+	for (unsigned int i = 0; i != _capacity; ++i) {
+		_messages[i].msg_hdr.msg_controllen = _control_size;
+	}
+	_count = sock.recvmmsg(_messages.get(), _capacity, 0);
+
+	// The drop counter is cumulative, and reported with each datagram
+	// received after the first drop, so only the last report in the
+	// batch need be considered.
+	_dropped = 0;
+	for (unsigned int i = _count; i != 0; --i) {
+		struct msghdr& message = _messages[i - 1].msg_hdr;
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+		for (; cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+			if ((cmsg->cmsg_level == SOL_SOCKET) &&
+				(cmsg->cmsg_type == SO_RXQ_OVFL)) {
+
+				uint32_t new_drop_count =
+					*reinterpret_cast<uint32_t*>(CMSG_DATA(cmsg));
+				_dropped = new_drop_count - drop_count;
+				drop_count = new_drop_count;
+				return;
+			}
+		}
+	}
+}
+
+} /* namespace horace */
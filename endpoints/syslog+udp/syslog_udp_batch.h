@@ -0,0 +1,105 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SYSLOG_UDP_BATCH
+#define LIBHOLMES_HORACE_SYSLOG_UDP_BATCH
+
+#include <cstdint>
+#include <memory>
+
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+namespace horace {
+
+class socket_descriptor;
+
+/** A class for receiving a batch of Syslog datagrams using recvmmsg.
+ * Each datagram is received into its own slot, which is large enough to
+ * hold the maximum UDP payload length of 65535 octets. The content of
+ * the slots remains valid until the next batch is received.
+ */
+class syslog_udp_batch {
+public:
+	/** The size of each slot, in octets. */
+	static const size_t slot_size = 65535;
+private:
+	/** The number of slots. */
+	unsigned int _capacity;
+
+	/** A buffer for receiving datagram content. */
+	std::unique_ptr<char[]> _buffer;
+
+	/** A buffer for receiving control messages. */
+	std::unique_ptr<char[]> _control;
+
+	/** The size of the control buffer for each slot, in octets. */
+	size_t _control_size;
+
+	/** An iovec structure for each slot. */
+	std::unique_ptr<struct iovec[]> _iov;
+
+	/** An mmsghdr structure for each slot. */
+	std::unique_ptr<struct mmsghdr[]> _messages;
+
+	/** The number of slots filled by the last batch received. */
+	unsigned int _count;
+
+	/** The number of datagrams dropped by the socket since the
+	 * previous batch was received. */
+	uint32_t _dropped;
+public:
+	/** Construct empty batch.
+	 * @param capacity the required number of slots
+	 */
+	explicit syslog_udp_batch(unsigned int capacity);
+
+	/** Receive a batch of datagrams.
+	 * This will block until at least one datagram is available. The
+	 * socket should have been configured to report its drop counter
+	 * using SO_RXQ_OVFL.
+	 * @param sock the socket from which to receive
+	 * @param drop_count the drop counter most recently reported by the
+	 *  socket, to be updated
+	 */
+	void receive(socket_descriptor& sock, uint32_t& drop_count);
+
+	/** Get the number of datagrams received.
+	 * @return the number of datagrams
+	 */
+	unsigned int count() const {
+		return _count;
+	}
+
+	/** Get the content of a datagram.
+	 * @param index the index of the datagram
+	 * @return a pointer to the content
+	 */
+	const char* data(unsigned int index) const {
+		return _buffer.get() + index * slot_size;
+	}
+
+	/** Get the length of a datagram.
+	 * @param index the index of the datagram
+	 * @return the length, in octets
+	 */
+	size_t length(unsigned int index) const {
+		return _messages[index].msg_len;
+	}
+
+	/** Get the number of datagrams dropped.
+	 * This is the number dropped by the socket since the previous batch
+	 * was received from it, up to the arrival of the last datagram in
+	 * this batch.
+	 * @return the number of datagrams
+	 */
+	uint32_t dropped() const {
+		return _dropped;
+	}
+};
+
+} /* namespace horace */
+
+#endif
@@ -3,13 +3,18 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include "horace/endpoint_error.h"
+#include "horace/query_string.h"
+
 #include "syslog_udp_endpoint.h"
 #include "syslog_udp_event_reader.h"
 
 namespace horace {
 
 syslog_udp_endpoint::syslog_udp_endpoint(const std::string& name):
-	endpoint(name) {
+	endpoint(name),
+	_workers(1),
+	_batch(32) {
 
 	std::string hostportname = this->name().authority().value_or("");
 	size_t index = hostportname.rfind(':');
@@ -21,6 +26,19 @@ syslog_udp_endpoint::syslog_udp_endpoint(const std::string& name):
 		_portname = hostportname.substr(
 			index + 1, std::string::npos);
 	}
+
+	std::optional<std::string> query = this->name().query();
+	if (query) {
+		query_string params(*query);
+		_workers = params.find<long>("workers").value_or(_workers);
+		_batch = params.find<long>("batch").value_or(_batch);
+	}
+	if (_workers < 1) {
+		throw endpoint_error("workers must be at least 1");
+	}
+	if (_batch < 1) {
+		throw endpoint_error("batch must be at least 1");
+	}
 }
 
 std::unique_ptr<event_reader> syslog_udp_endpoint::make_event_reader(
@@ -23,6 +23,12 @@ private:
 
 	/** The portname. */
 	std::string _portname;
+
+	/** The number of worker threads, each with its own socket. */
+	long _workers;
+
+	/** The number of datagrams to receive per system call. */
+	long _batch;
 public:
 	/** Construct Syslog over UDP endpoint.
 	 * @param name the name of this endpoint
@@ -45,6 +51,23 @@ public:
 	const std::string& portname() const {
 		return _portname;
 	}
+
+	/** Get the number of worker threads.
+	 * If this is greater than one then each worker has its own socket,
+	 * bound to the same address using SO_REUSEPORT. Otherwise, the
+	 * event reader receives datagrams itself.
+	 * @return the number of worker threads
+	 */
+	long workers() const {
+		return _workers;
+	}
+
+	/** Get the number of datagrams to receive per system call.
+	 * @return the maximum number of datagrams
+	 */
+	long batch() const {
+		return _batch;
+	}
 };
 
 } /* namespace horace */
@@ -3,63 +3,185 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <poll.h>
+
 #include "horace/log_message.h"
 #include "horace/logger.h"
+#include "horace/terminate_exception.h"
+#include "horace/terminate_flag.h"
 #include "horace/address_info.h"
 #include "horace/attribute_list.h"
-#include "horace/string_attribute.h"
 #include "horace/session_builder.h"
+#include "horace/syslog_error.h"
+#include "horace/syslog_parser.h"
 
 #include "syslog_udp_event_reader.h"
 #include "syslog_udp_endpoint.h"
-#include "syslog_error.h"
-#include "syslog_parser.h"
 
 namespace horace {
 
+namespace {
+
+/** The interval at which waiting threads check whether they should stop,
+ * in milliseconds. */
+const int poll_interval = 100;
+
+/** The number of batches to allocate for each worker thread. */
+const int batches_per_worker = 2;
+
+} /* anonymous namespace */
+
 class record;
 
 syslog_udp_event_reader::syslog_udp_event_reader(
 	const syslog_udp_endpoint& ep, session_builder& session):
-	_ep(&ep) {
+	_ep(&ep),
+	_batch(0),
+	_index(0),
+	_report_dropped(false),
+	_drop_count(0),
+	_stopping(false) {
 
 	attribute_list attrs;
 	_channel = session.define_channel("log", std::move(attrs));
 	_builder = std::make_unique<log_record_builder>(session, _channel);
 
+	// Open one socket for each worker. If there is more than one then
+	// they must all be bound to the same address using SO_REUSEPORT.
 	address_info ai(ep.hostname(), ep.portname(), SOCK_DGRAM, true);
-	_sock = ai.make_socket();
-	_sock.interruptible(true);
-	ai.bind(_sock);
-
-	// Initialse buffers for recvmsg.
-	// Messages of any size are supported up to the maximum UDP payload
-	// length of 65535 octets.
-	const size_t buffer_size = 65535;
-	_buffer = std::make_unique<char[]>(buffer_size);
-	_iov[0].iov_base = _buffer.get();
-	_iov[0].iov_len = buffer_size;
-
-	// Initialise message structure for recvmsg.
-	_message.msg_name = 0;
-	_message.msg_namelen = 0;
-	_message.msg_iov = _iov;
-	_message.msg_iovlen = 1;
-	_message.msg_control = 0;
-	_message.msg_controllen = 0;
+	long workers = ep.workers();
+	for (long i = 0; i != workers; ++i) {
+		socket_descriptor sock = ai.make_socket();
+		sock.interruptible(true);
+		sock.setsockopt<int>(SOL_SOCKET, SO_RXQ_OVFL, 1);
+		if (workers > 1) {
+			sock.setsockopt<int>(SOL_SOCKET, SO_REUSEPORT, 1);
+		}
+		ai.bind(sock);
+		_socks.push_back(std::move(sock));
+	}
+
+	// Initialise batches for recvmmsg. With no worker threads, a
+	// single batch is reused for every call.
+	long batch_count = (workers > 1) ? workers * batches_per_worker : 1;
+	for (long i = 0; i != batch_count; ++i) {
+		_batches.push_back(std::make_unique<syslog_udp_batch>(
+			ep.batch()));
+		_emptied.push_back(_batches.back().get());
+	}
+
+	if (workers > 1) {
+		for (auto& sock : _socks) {
+			_workers.emplace_back(&syslog_udp_event_reader::_work,
+				this, std::ref(sock));
+		}
+	}
 
 	if (log->enabled(logger::log_notice)) {
 		log_message msg(*log, logger::log_notice);
 		msg << "listening for syslog on " << _ep->hostname()
 			<< ":" << _ep->portname();
+		if (workers > 1) {
+			msg << " (" << workers << " workers)";
+		}
+	}
+}
+
+syslog_udp_event_reader::~syslog_udp_event_reader() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_stopping = true;
+	}
+	_emptied_cv.notify_all();
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+}
+
+void syslog_udp_event_reader::_work(socket_descriptor& sock) {
+	uint32_t drop_count = 0;
+	try {
+		while (true) {
+			// Wait for a datagram to arrive, checking at intervals
+			// whether the worker should stop.
+			while (!(sock.wait(POLLIN, poll_interval) & POLLIN)) {
+				std::lock_guard<std::mutex> lk(_mutex);
+				if (_stopping) {
+					return;
+				}
+			}
+
+			// Obtain an empty batch. If none are available then
+			// parsing is not keeping up, in which case datagrams
+			// accumulate in the socket receive queue meanwhile.
+			syslog_udp_batch* batch = 0;
+			{
+				std::unique_lock<std::mutex> lk(_mutex);
+				_emptied_cv.wait(lk, [this]() {
+					return _stopping || !_emptied.empty();
+				});
+				if (_stopping) {
+					return;
+				}
+				batch = _emptied.front();
+				_emptied.pop_front();
+			}
+
+			batch->receive(sock, drop_count);
+
+			{
+				std::lock_guard<std::mutex> lk(_mutex);
+				_filled.push_back(batch);
+			}
+			_filled_cv.notify_one();
+		}
+	} catch (terminate_exception&) {
+		// No action.
+	} catch (std::exception& ex) {
+		if (log->enabled(logger::log_err)) {
+			log_message msg(*log, logger::log_err);
+			msg << "syslog worker stopped: " << ex.what();
+		}
 	}
 }
 
+void syslog_udp_event_reader::_next_batch() {
+	if (_workers.empty()) {
+		_batch = _batches[0].get();
+		_batch->receive(_socks[0], _drop_count);
+	} else {
+		std::unique_lock<std::mutex> lk(_mutex);
+		if (_batch) {
+			_emptied.push_back(_batch);
+			_batch = 0;
+			_emptied_cv.notify_one();
+		}
+		while (_filled.empty()) {
+			_filled_cv.wait_for(lk,
+				std::chrono::milliseconds(poll_interval));
+			terminating.poll();
+		}
+		_batch = _filled.front();
+		_filled.pop_front();
+	}
+	_index = 0;
+	_report_dropped = (_batch->dropped() != 0);
+}
+
 const record& syslog_udp_event_reader::read() {
-	struct msghdr message = _message;
-	size_t count = _sock.recvmsg(&message, 0);
+	while (!_report_dropped && (!_batch || (_index == _batch->count()))) {
+		_next_batch();
+	}
+
+	// Datagrams dropped by the socket are reported before the batch
+	// in which the drop was detected.
+	if (_report_dropped) {
+		_report_dropped = false;
+		return _builder->build_dropped(_batch->dropped());
+	}
 
-	syslog_parser parser(_buffer.get(), count);
+	unsigned int index = _index++;
+	syslog_parser parser(_batch->data(index), _batch->length(index));
 	parser.read_message(*_builder);
 	return _builder->build();
 };
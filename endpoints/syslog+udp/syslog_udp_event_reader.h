@@ -7,18 +7,32 @@
 #define LIBHOLMES_HORACE_SYSLOG_UDP_EVENT_READER
 
 #include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "horace/socket_descriptor.h"
 #include "horace/record.h"
 #include "horace/log_record_builder.h"
 #include "horace/event_reader.h"
 
+#include "syslog_udp_batch.h"
+
 namespace horace {
 
 class session_builder;
 class syslog_udp_endpoint;
 
-/** A class for reading events from a Syslog UDP socket. */
+/** A class for reading events from a Syslog UDP socket.
+ * Datagrams are received in batches using recvmmsg. By default they are
+ * received by the thread which calls read(), however the endpoint can
+ * optionally specify a number of worker threads, each of which receives
+ * from its own socket bound using SO_REUSEPORT. This allows the kernel
+ * to spread incoming datagrams across several receive queues. Either
+ * way, parsing is performed by the thread which calls read().
+ */
 class syslog_udp_event_reader:
 	public event_reader {
 private:
@@ -28,20 +42,61 @@ private:
 	/** The channel number to use for captured events. */
 	int _channel;
 
-	/** The socket for capturing messages. */
-	socket_descriptor _sock;
+	/** The sockets for capturing messages, one per worker. */
+	std::vector<socket_descriptor> _socks;
+
+	/** The batches available for receiving datagrams. */
+	std::vector<std::unique_ptr<syslog_udp_batch>> _batches;
+
+	/** The batch currently being parsed, or 0 if none. */
+	syslog_udp_batch* _batch;
+
+	/** The index of the next datagram to be parsed within _batch. */
+	unsigned int _index;
+
+	/** True if the drop count for _batch remains to be reported,
+	 * otherwise false. */
+	bool _report_dropped;
+
+	/** The drop counter most recently reported by the socket,
+	 * when there are no worker threads. */
+	uint32_t _drop_count;
+
+	/** A mutex to protect the batch queues and _stopping. */
+	std::mutex _mutex;
+
+	/** A condition variable for signalling that a batch has been
+	 * filled. */
+	std::condition_variable _filled_cv;
 
-	/** A buffer for receiving datagram content. */
-	std::unique_ptr<char[]> _buffer;
+	/** A condition variable for signalling that a batch has been
+	 * emptied. */
+	std::condition_variable _emptied_cv;
 
-	/** An iovec structure for receiving datagrams. */
-	struct iovec _iov[1];
+	/** Batches which have been filled by worker threads. */
+	std::deque<syslog_udp_batch*> _filled;
 
-	/** A msghdr structure for receiving datagrams. */
-	struct msghdr _message;
+	/** Batches which are available to worker threads. */
+	std::deque<syslog_udp_batch*> _emptied;
+
+	/** True if the worker threads should stop, otherwise false. */
+	bool _stopping;
+
+	/** The worker threads. */
+	std::vector<std::thread> _workers;
 
 	/** A builder for log records. */
 	std::unique_ptr<log_record_builder> _builder;
+
+	/** Receive datagrams from one socket until asked to stop.
+	 * @param sock the socket from which to receive
+	 */
+	void _work(socket_descriptor& sock);
+
+	/** Obtain the next batch of datagrams to be parsed.
+	 * This will block until one is available.
+	 */
+	void _next_batch();
 public:
 	/** Construct syslog event reader.
 	 * @param ep the endpoint to read from
@@ -49,6 +104,11 @@ public:
 	explicit syslog_udp_event_reader(const syslog_udp_endpoint& ep,
 		session_builder& builder);
 
+	/** Destroy syslog event reader.
+	 * Any worker threads are stopped before the destructor returns.
+	 */
+	virtual ~syslog_udp_event_reader();
+
 	virtual const record& read();
 };
 
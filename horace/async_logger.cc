@@ -0,0 +1,163 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdint>
+#include <chrono>
+
+#include "horace/async_logger.h"
+
+namespace horace {
+
+namespace {
+
+/** The time for which the background thread sleeps when the queue
+ * is empty. */
+const auto idle_interval = std::chrono::milliseconds(10);
+
+/** The maximum time for which repeated messages are coalesced before
+ * reporting them. */
+const auto repeat_interval = std::chrono::seconds(1);
+
+} /* anonymous namespace */
+
+async_logger::async_logger(std::unique_ptr<logger> backend,
+	size_t capacity):
+	_backend(std::move(backend)),
+	_head(0),
+	_tail(0),
+	_dropped(0),
+	_stopping(false) {
+
+	size_t size = 1;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	_slots = std::make_unique<slot[]>(size);
+	_mask = size - 1;
+	for (size_t i = 0; i != size; ++i) {
+		_slots[i].seqnum.store(i, std::memory_order_relaxed);
+	}
+
+	_thread = std::thread(&async_logger::_flush, this);
+}
+
+async_logger::~async_logger() {
+	_stopping.store(true);
+	_thread.join();
+}
+
+void async_logger::write(const std::string& msg) {
+	(*_backend) << msg;
+}
+
+void async_logger::submit(const std::string& msg) {
+	// Claim a slot by advancing the head of the queue. A slot is
+	// available if its sequence number matches the position.
+	size_t pos = _head.load(std::memory_order_relaxed);
+	while (true) {
+		slot& s = _slots[pos & _mask];
+		size_t seqnum = s.seqnum.load(std::memory_order_acquire);
+		intptr_t diff = intptr_t(seqnum) - intptr_t(pos);
+		if (diff == 0) {
+			if (_head.compare_exchange_weak(pos, pos + 1,
+				std::memory_order_relaxed)) {
+
+				// Assignment normally reuses the capacity
+				// of the string previously held in the slot.
+				try {
+					s.msg = msg;
+				} catch (std::exception&) {
+					s.msg.clear();
+				}
+				s.seqnum.store(pos + 1, std::memory_order_release);
+				return;
+			}
+		} else if (diff < 0) {
+			// The queue is full.
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool async_logger::_pop(std::string& msg) {
+	slot& s = _slots[_tail & _mask];
+	size_t seqnum = s.seqnum.load(std::memory_order_acquire);
+	if (seqnum != _tail + 1) {
+		return false;
+	}
+
+	// Swap rather than copy, so that the capacity of the string is
+	// retained for reuse.
+	msg.swap(s.msg);
+	s.seqnum.store(_tail + _mask + 1, std::memory_order_release);
+	_tail += 1;
+	return true;
+}
+
+void async_logger::_flush() {
+	std::string msg;
+	std::string last_msg;
+	uint64_t repeats = 0;
+	auto repeat_deadline = std::chrono::steady_clock::now();
+
+	// Report the number of times the last message was repeated,
+	// if it was repeated at all.
+	auto report_repeats = [&]() {
+		if (repeats) {
+			write("last message repeated " +
+				std::to_string(repeats) + " times");
+			repeats = 0;
+		}
+	};
+
+	while (true) {
+		bool stopping = _stopping.load();
+		if (_pop(msg)) {
+			if (!last_msg.empty() && (msg == last_msg)) {
+				// The count is reported when the interval
+				// expires, even if the queue never becomes
+				// empty, then a new interval is started.
+				auto now = std::chrono::steady_clock::now();
+				if (repeats && (now >= repeat_deadline)) {
+					report_repeats();
+				}
+				if (!repeats++) {
+					repeat_deadline = now + repeat_interval;
+				}
+			} else {
+				report_repeats();
+				write(msg);
+				last_msg.swap(msg);
+			}
+			continue;
+		}
+
+		// The queue is empty, so report any messages that were
+		// discarded (which breaks any sequence of repeats).
+		if (uint64_t dropped = _dropped.exchange(0)) {
+			report_repeats();
+			write(std::to_string(dropped) +
+				" log messages discarded (queue full)");
+			last_msg.clear();
+		}
+
+		// Repeats should not be held back indefinitely.
+		if (stopping ||
+			(std::chrono::steady_clock::now() >= repeat_deadline)) {
+
+			report_repeats();
+		}
+
+		if (stopping) {
+			break;
+		}
+		std::this_thread::sleep_for(idle_interval);
+	}
+}
+
+} /* namespace horace */
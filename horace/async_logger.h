@@ -0,0 +1,98 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_ASYNC_LOGGER
+#define LIBHOLMES_HORACE_ASYNC_LOGGER
+
+#include <atomic>
+#include <thread>
+
+#include "horace/logger.h"
+
+namespace horace {
+
+/** A logger class which writes to another logger asynchronously.
+ * Messages are placed in a bounded lock-free queue, from which they are
+ * removed by a background thread and written to the underlying logger.
+ * This allows messages to be logged from time-critical threads without
+ * contending for a mutex or waiting for the message to be written.
+ *
+ * If the queue is full then messages are discarded, and the number
+ * discarded is reported once there is space. Consecutive identical
+ * messages are coalesced, in the same manner as syslog.
+ */
+class async_logger:
+	public logger {
+private:
+	/** A structure to represent a slot in the queue. */
+	struct slot {
+		/** The sequence number for this slot.
+		 * This is equal to the queue position if the slot is ready
+		 * to be written, or one more than the queue position if it
+		 * is ready to be read.
+		 */
+		std::atomic<size_t> seqnum;
+
+		/** The message held in this slot. */
+		std::string msg;
+	};
+
+	/** The underlying logger. */
+	std::unique_ptr<logger> _backend;
+
+	/** The queue slots. */
+	std::unique_ptr<slot[]> _slots;
+
+	/** A mask for converting queue positions to slot indices. */
+	size_t _mask;
+
+	/** The queue position at which the next message will be
+	 * written. */
+	alignas(64) std::atomic<size_t> _head;
+
+	/** The queue position from which the next message will be read.
+	 * This is accessed only by the background thread. */
+	alignas(64) size_t _tail;
+
+	/** The number of messages discarded because the queue was full. */
+	std::atomic<uint64_t> _dropped;
+
+	/** True if the background thread should stop once the queue
+	 * is empty, otherwise false. */
+	std::atomic<bool> _stopping;
+
+	/** The background thread. */
+	std::thread _thread;
+
+	/** Remove a message from the queue.
+	 * @param msg a string to receive the message
+	 * @return true if a message was removed, otherwise false
+	 */
+	bool _pop(std::string& msg);
+
+	/** Write messages from the queue until asked to stop. */
+	void _flush();
+protected:
+	virtual void write(const std::string& msg);
+	virtual void submit(const std::string& msg);
+public:
+	/** Construct asynchronous logger.
+	 * @param backend the underlying logger
+	 * @param capacity the capacity of the queue, rounded up to a
+	 *  power of two
+	 */
+	explicit async_logger(std::unique_ptr<logger> backend,
+		size_t capacity = 0x4000);
+
+	/** Destroy asynchronous logger.
+	 * Any messages remaining in the queue are written before the
+	 * destructor returns.
+	 */
+	virtual ~async_logger();
+};
+
+} /* namespace horace */
+
+#endif
@@ -19,29 +19,54 @@
 
 namespace horace {
 
-std::unique_ptr<attribute> attribute::parse(session_context& session,
+namespace {
+
+/** Parse an attribute of a given class.
+ * @param session the applicable session context
+ * @param attrid the attribute ID
+ * @param length the length of the content, in octets
+ * @param in the octet reader
+ * @return the resulting attribute
+ */
+template<class T>
+std::unique_ptr<attribute> parse_as(session_context& session,
 	int attrid, size_t length, octet_reader& in) {
 
-	int type = session.get_attr_type(attrid);
-	switch (type) {
-	case type_compound:
-		return std::make_unique<compound_attribute>(session, attrid, length, in);
-	case type_unsigned_integer:
-		return std::make_unique<unsigned_integer_attribute>(attrid, length, in);
-	case type_signed_integer:
-		return std::make_unique<signed_integer_attribute>(attrid, length, in);
-	case type_binary:
-		return std::make_unique<binary_attribute>(attrid, length, in);
-	case type_string:
-		return std::make_unique<string_attribute>(attrid, length, in);
-	case type_timestamp:
-		return std::make_unique<timestamp_attribute>(attrid, length, in);
-	case type_boolean:
-		return std::make_unique<boolean_attribute>(attrid, length, in);
-	default:
-		return std::make_unique<unrecognised_attribute>(
-			attrid, length, in);
+	return std::make_unique<T>(attrid, length, in);
+}
+
+template<>
+std::unique_ptr<attribute> parse_as<compound_attribute>(
+	session_context& session, int attrid, size_t length,
+	octet_reader& in) {
+
+	return std::make_unique<compound_attribute>(session, attrid,
+		length, in);
+}
+
+/** The parse functions for each content type, indexed by type. */
+attribute::parse_function* const parsers[] = {
+	parse_as<compound_attribute>,
+	parse_as<unsigned_integer_attribute>,
+	parse_as<signed_integer_attribute>,
+	parse_as<binary_attribute>,
+	parse_as<string_attribute>,
+	parse_as<timestamp_attribute>,
+	parse_as<boolean_attribute>};
+
+} /* anonymous namespace */
+
+attribute::parse_function* attribute::parser(int type) {
+	if (type >= 0 && type < int(sizeof(parsers) / sizeof(parsers[0]))) {
+		return parsers[type];
 	}
+	return parse_as<unrecognised_attribute>;
+}
+
+std::unique_ptr<attribute> attribute::parse(session_context& session,
+	int attrid, size_t length, octet_reader& in) {
+
+	return session.get_attr_parser(attrid)(session, attrid, length, in);
 }
 
 std::unique_ptr<attribute> attribute::parse(session_context& session,
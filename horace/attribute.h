@@ -43,6 +43,12 @@ static const int attrid_hash_alg = -15;
 static const int attrid_sig = -16;
 static const int attrid_sig_alg = -17;
 static const int attrid_sig_pubkey = -18;
+static const int attrid_hash_count = -19;
+static const int attrid_ts_delta = -20;
+static const int attrid_delta_encoding = -21;
+static const int attrid_record_template = -22;
+static const int attrid_dict_def = -23;
+static const int attrid_dict_ref = -24;
 
 /** An abstract base class to represent a HORACE attribute. */
 class attribute {
@@ -76,6 +82,13 @@ public:
 		return !(*this == that);
 	}
 
+	/** A type to represent a function for parsing an attribute.
+	 * The arguments and result are as for attribute::parse.
+	 */
+	typedef std::unique_ptr<attribute> parse_function(
+		session_context& session, int attrid, size_t length,
+		octet_reader& in);
+
 	/** Get the attribute ID
 	 * @return the attribute ID
 	 */
@@ -106,6 +119,19 @@ public:
 	 */
 	virtual void write(octet_writer& out) const = 0;
 
+	/** Write the content of this attribute to an octet writer.
+	 * The attribute ID and length are not written.
+	 * @param out the octet writer
+	 */
+	virtual void write_content(octet_writer& out) const = 0;
+
+	/** Get the parse function for a given content type.
+	 * Unrecognised content types are parsed as unrecognised_attribute.
+	 * @param type the content type
+	 * @return the corresponding parse function
+	 */
+	static parse_function* parser(int type);
+
 	/** Parse attribute from an octet reader.
 	 * The ID and length fields must already have been read. This
 	 * function must read exactly the specified number of octets.
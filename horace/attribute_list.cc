@@ -13,6 +13,10 @@
 #include "horace/unsigned_base128_integer.h"
 #include "horace/signed_base128_integer.h"
 #include "horace/attribute.h"
+#include "horace/string_attribute.h"
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/timestamp_attribute.h"
+#include "horace/binary_ref_attribute.h"
 #include "horace/attribute_list.h"
 
 namespace horace {
@@ -31,13 +35,63 @@ public:
 };
 
 bool attrid_less::operator()(const attribute* lhs, const attribute* rhs) const {
-	uint64_t id_lhs = lhs->attrid();
-	uint64_t id_rhs = rhs->attrid();
+	return attribute_list::precedes(lhs->attrid(), rhs->attrid());
+}
+
+bool attribute_list::precedes(int lhs, int rhs) {
+	uint64_t id_lhs = lhs;
+	uint64_t id_rhs = rhs;
 	uint64_t order_lhs = -(id_lhs ^ (((id_lhs >> 63) - 1) >> 1));
 	uint64_t order_rhs = -(id_rhs ^ (((id_rhs >> 63) - 1) >> 1));
 	return order_lhs < order_rhs;
 }
 
+template<class T>
+void attribute_list::_index(const T*& ref, const attribute& attr) {
+	// If there is more than one attribute with the same ID then the
+	// direct reference is cleared, so that the error is reported by
+	// find_one.
+	uint32_t bit = uint32_t(1) << -attr.attrid();
+	ref = (_seen & bit) ? 0 : dynamic_cast<const T*>(&attr);
+	_seen |= bit;
+}
+
+void attribute_list::_index(const attribute& attr) {
+	switch (attr.attrid()) {
+	case attrid_source:
+		_index(_source, attr);
+		break;
+	case attrid_seqnum:
+		_index(_seqnum, attr);
+		break;
+	case attrid_ts:
+		_index(_ts, attr);
+		break;
+	case attrid_hash:
+		_index(_hash, attr);
+		break;
+	default:
+		// no action
+		break;
+	}
+}
+
+void attribute_list::_clear_index() {
+	_source = 0;
+	_seqnum = 0;
+	_ts = 0;
+	_hash = 0;
+	_seen = 0;
+}
+
+void attribute_list::_swap_index(attribute_list& that) {
+	std::swap(_source, that._source);
+	std::swap(_seqnum, that._seqnum);
+	std::swap(_ts, that._ts);
+	std::swap(_hash, that._hash);
+	std::swap(_seen, that._seen);
+}
+
 attribute_list::~attribute_list() {
 	for (const auto& attr : _owned_attributes) {
 		delete attr;
@@ -48,6 +102,7 @@ attribute_list::attribute_list(const attribute_list& that) {
 	for (const auto& attr : that._attributes) {
 		auto attr_copy = attr->clone();
 		_attributes.push_back(attr_copy.get());
+		_index(*attr_copy);
 		_owned_attributes.push_back(attr_copy.release());
 	}
 }
@@ -55,6 +110,8 @@ attribute_list::attribute_list(const attribute_list& that) {
 attribute_list::attribute_list(attribute_list&& that) {
 	_attributes.swap(that._attributes);
 	_owned_attributes.swap(that._owned_attributes);
+	_shared_attributes.swap(that._shared_attributes);
+	_swap_index(that);
 }
 
 attribute_list& attribute_list::operator=(const attribute_list& that) {
@@ -64,10 +121,13 @@ attribute_list& attribute_list::operator=(const attribute_list& that) {
 			delete attr;
 		}
 		_owned_attributes.clear();
+		_shared_attributes.clear();
+		_clear_index();
 
 		for (const auto& attr : that._attributes) {
 			auto attr_copy = attr->clone();
 			_attributes.push_back(attr_copy.get());
+			_index(*attr_copy);
 			_owned_attributes.push_back(attr_copy.release());
 		}
 	}
@@ -81,9 +141,13 @@ attribute_list& attribute_list::operator=(attribute_list&& that) {
 			delete attr;
 		}
 		_owned_attributes.clear();
+		_shared_attributes.clear();
+		_clear_index();
 
 		_attributes.swap(that._attributes);
 		_owned_attributes.swap(that._owned_attributes);
+		_shared_attributes.swap(that._shared_attributes);
+		_swap_index(that);
 	}
 	return *this;
 }
@@ -151,12 +215,33 @@ const attribute& attribute_list::_find_one(int attrid) const {
 	return *found;
 }
 
+const string_attribute& attribute_list::find_source() const {
+	return (_source) ? *_source :
+		find_one<string_attribute>(attrid_source);
+}
+
+const unsigned_integer_attribute& attribute_list::find_seqnum() const {
+	return (_seqnum) ? *_seqnum :
+		find_one<unsigned_integer_attribute>(attrid_seqnum);
+}
+
+const timestamp_attribute& attribute_list::find_ts() const {
+	return (_ts) ? *_ts :
+		find_one<timestamp_attribute>(attrid_ts);
+}
+
+const binary_ref_attribute& attribute_list::find_hash() const {
+	return (_hash) ? *_hash :
+		find_one<binary_ref_attribute>(attrid_hash);
+}
+
 attribute_list& attribute_list::insert(
 	std::unique_ptr<attribute>& attr) {
 
 	auto f = std::upper_bound(_attributes.begin(), _attributes.end(),
 		attr.get(), attrid_less());
 	_attributes.insert(f, attr.get());
+	_index(*attr);
 	_owned_attributes.push_back(attr.release());
 	return *this;
 }
@@ -167,16 +252,29 @@ attribute_list& attribute_list::insert(
 	auto f = std::upper_bound(_attributes.begin(), _attributes.end(),
 		attr.get(), attrid_less());
 	_attributes.insert(f, attr.get());
+	_index(*attr);
 	_owned_attributes.push_back(attr.release());
 	return *this;
 }
 
+attribute_list& attribute_list::insert_shared(
+	const std::shared_ptr<const attribute>& attr) {
+
+	auto f = std::upper_bound(_attributes.begin(), _attributes.end(),
+		attr.get(), attrid_less());
+	_attributes.insert(f, attr.get());
+	_index(*attr);
+	_shared_attributes.push_back(attr);
+	return *this;
+}
+
 attribute_list& attribute_list::insert(
 	const attribute& attr) {
 
 	auto f = std::upper_bound(_attributes.begin(), _attributes.end(),
 		&attr, attrid_less());
 	_attributes.insert(f, &attr);
+	_index(attr);
 	return *this;
 }
 
@@ -6,6 +6,7 @@
 #ifndef LIBHOLMES_HORACE_ATTRIBUTE_LIST
 #define LIBHOLMES_HORACE_ATTRIBUTE_LIST
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <iosfwd>
@@ -16,6 +17,10 @@ class octet_reader;
 class octet_writer;
 class attribute;
 class session_context;
+class string_attribute;
+class unsigned_integer_attribute;
+class timestamp_attribute;
+class binary_ref_attribute;
 
 /** A class to represent an ordered list of attributes.
  * When an attribute is added to a list of this type, ownership may
@@ -23,7 +28,9 @@ class session_context;
  * This may be helpful when processing attributes with a mixture of
  * dynamic and non-dynamic storage duration. For attributes parsed
  * from an octet stream, or copied from another attribute list,
- * ownership necessarily passes to the list.
+ * ownership necessarily passes to the list. Ownership may also be
+ * shared with other lists, for attributes such as dictionary entries
+ * which are referred to by many records.
  */
 class attribute_list {
 private:
@@ -32,6 +39,49 @@ private:
 
 	/** The attributes owned by this list. */
 	std::vector<const attribute*> _owned_attributes;
+
+	/** The attributes of which this list shares ownership. */
+	std::vector<std::shared_ptr<const attribute>> _shared_attributes;
+
+	/** The source ID attribute, if unique and of the expected type,
+	 * otherwise null. */
+	const string_attribute* _source = 0;
+
+	/** The sequence number attribute, if unique and of the expected
+	 * type, otherwise null. */
+	const unsigned_integer_attribute* _seqnum = 0;
+
+	/** The timestamp attribute, if unique and of the expected type,
+	 * otherwise null. */
+	const timestamp_attribute* _ts = 0;
+
+	/** The hash attribute, if unique and of the expected type,
+	 * otherwise null. */
+	const binary_ref_attribute* _hash = 0;
+
+	/** The reserved attribute IDs with direct references which have
+	 * been inserted into this list, as a bitmask indexed by -attrid. */
+	uint32_t _seen = 0;
+
+	/** Update the direct reference for an attribute, if it has one.
+	 * @param attr the attribute which has been inserted
+	 */
+	void _index(const attribute& attr);
+
+	/** Update a given direct reference.
+	 * @param ref the direct reference
+	 * @param attr the attribute which has been inserted
+	 */
+	template<class T>
+	void _index(const T*& ref, const attribute& attr);
+
+	/** Clear the direct references. */
+	void _clear_index();
+
+	/** Swap the direct references with those of another list.
+	 * @param that the other list
+	 */
+	void _swap_index(attribute_list& that);
 public:
 	attribute_list() = default;
 	virtual ~attribute_list();
@@ -40,7 +90,14 @@ public:
 	attribute_list(attribute_list&& that);
 
 	attribute_list& operator=(const attribute_list&);
-	attribute_list& operator=(attribute_list&&);
+
+	/** Move-assign attribute list.
+	 * The storage previously used by this list is cleared and passed
+	 * to the source list, so that it can be reused.
+	 * @param that the attribute list to be moved
+	 * @return a reference to this
+	 */
+	attribute_list& operator=(attribute_list&& that);
 
 	/** Build attribute list from octet reader.
 	 * The length field must already have been read. This constructor
@@ -59,6 +116,16 @@ public:
 		return _attributes.empty();
 	}
 
+	/** Determine whether one attribute ID precedes another in
+	 * canonical order.
+	 * Reserved IDs precede user-defined IDs, and otherwise IDs are
+	 * ordered by absolute value.
+	 * @param lhs the first attribute ID
+	 * @param rhs the second attribute ID
+	 * @return true if lhs precedes rhs, otherwise false
+	 */
+	static bool precedes(int lhs, int rhs);
+
 	/** Get the encoded length of the content of this list.
 	 * The result includes an ID and length field for each attribute,
 	 * but not for the list as a whole.
@@ -111,6 +178,35 @@ public:
 		return dynamic_cast<const T&>(_find_one(attrid));
 	}
 
+	/** Find the source ID attribute.
+	 * This is equivalent to find_one<string_attribute>(attrid_source),
+	 * but is performed in constant time when the attribute is present.
+	 * @return the source ID attribute
+	 */
+	const string_attribute& find_source() const;
+
+	/** Find the sequence number attribute.
+	 * This is equivalent to
+	 * find_one<unsigned_integer_attribute>(attrid_seqnum),
+	 * but is performed in constant time when the attribute is present.
+	 * @return the sequence number attribute
+	 */
+	const unsigned_integer_attribute& find_seqnum() const;
+
+	/** Find the timestamp attribute.
+	 * This is equivalent to find_one<timestamp_attribute>(attrid_ts),
+	 * but is performed in constant time when the attribute is present.
+	 * @return the timestamp attribute
+	 */
+	const timestamp_attribute& find_ts() const;
+
+	/** Find the hash attribute.
+	 * This is equivalent to find_one<binary_ref_attribute>(attrid_hash),
+	 * but is performed in constant time when the attribute is present.
+	 * @return the hash attribute
+	 */
+	const binary_ref_attribute& find_hash() const;
+
 	/** Insert an attribute to this list, with transfer of ownership.
 	 * @param attr the attribute to be inserted
 	 * @return a reference to this
@@ -123,6 +219,13 @@ public:
 	 */
 	attribute_list& insert(std::unique_ptr<attribute>&& attr);
 
+	/** Insert an attribute to this list, with shared ownership.
+	 * @param attr the attribute to be inserted
+	 * @return a reference to this
+	 */
+	attribute_list& insert_shared(
+		const std::shared_ptr<const attribute>& attr);
+
 	/** Insert an attribute to this record, without transfer of ownership.
 	 * It is the caller's responsibility to ensure that the attribute
 	 * remains in existence until there is no further possibility of it
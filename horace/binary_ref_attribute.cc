@@ -59,4 +59,8 @@ void binary_ref_attribute::write(octet_writer& out) const {
 	out.write(_content, _length);
 }
 
+void binary_ref_attribute::write_content(octet_writer& out) const {
+	out.write(_content, _length);
+}
+
 } /* namespace horace */
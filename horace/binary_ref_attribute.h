@@ -46,6 +46,7 @@ public:
 	virtual std::unique_ptr<attribute> clone() const;
 	virtual void write(std::ostream& out) const;
 	virtual void write(octet_writer& out) const;
+	virtual void write_content(octet_writer& out) const;
 };
 
 } /* namespace horace */
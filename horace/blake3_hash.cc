@@ -0,0 +1,491 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "horace/blake3_hash.h"
+
+namespace horace {
+
+namespace {
+
+/** The number of octets in a chunk. */
+const size_t chunk_len = 1024;
+
+/** The number of octets in a block. */
+const size_t block_len = 64;
+
+/** Domain separation flags. */
+enum {
+	chunk_start = 1 << 0,
+	chunk_end = 1 << 1,
+	parent = 1 << 2,
+	root = 1 << 3
+};
+
+/** The initial chaining value. */
+const uint32_t blake3_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+/** The order in which message words are used by each round. */
+const uint8_t blake3_schedule[7][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+	{3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+	{10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+	{12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+	{9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+	{11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}};
+
+/** Load a block of message words.
+ * @param block the block, as octets
+ * @param m the block, as little-endian words
+ */
+void load_block(const unsigned char* block, uint32_t* m) {
+	for (int i = 0; i != 16; ++i) {
+		m[i] = uint32_t(block[i * 4 + 0]) |
+			(uint32_t(block[i * 4 + 1]) << 8) |
+			(uint32_t(block[i * 4 + 2]) << 16) |
+			(uint32_t(block[i * 4 + 3]) << 24);
+	}
+}
+
+#if defined(__SSE2__)
+
+inline __m128i rotr16(__m128i x) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+}
+
+template<int N>
+inline __m128i rotr(__m128i x) {
+	return _mm_or_si128(_mm_srli_epi32(x, N), _mm_slli_epi32(x, 32 - N));
+}
+
+/** Apply the G function to each column of the state.
+ * @param row the state, as four rows of four words
+ * @param mx the first message word for each column
+ * @param my the second message word for each column
+ */
+inline void g4(__m128i* row, __m128i mx, __m128i my) {
+	row[0] = _mm_add_epi32(_mm_add_epi32(row[0], row[1]), mx);
+	row[3] = rotr16(_mm_xor_si128(row[3], row[0]));
+	row[2] = _mm_add_epi32(row[2], row[3]);
+	row[1] = rotr<12>(_mm_xor_si128(row[1], row[2]));
+	row[0] = _mm_add_epi32(_mm_add_epi32(row[0], row[1]), my);
+	row[3] = rotr<8>(_mm_xor_si128(row[3], row[0]));
+	row[2] = _mm_add_epi32(row[2], row[3]);
+	row[1] = rotr<7>(_mm_xor_si128(row[1], row[2]));
+}
+
+/** Compress one block.
+ * The columns of the state are held in SSE2 registers, and the diagonal
+ * steps are performed by rotating the rows.
+ * @param cv the input chaining value
+ * @param m the message block
+ * @param len the number of octets in the block
+ * @param counter the chunk counter
+ * @param flags the domain separation flags
+ * @param out the output chaining value
+ */
+void compress(const uint32_t* cv, const uint32_t* m, uint32_t len,
+	uint64_t counter, uint32_t flags, uint32_t* out) {
+
+	__m128i row[4];
+	row[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cv));
+	row[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cv + 4));
+	row[2] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blake3_iv));
+	row[3] = _mm_set_epi32(flags, len, counter >> 32, counter);
+
+	for (const auto& s : blake3_schedule) {
+		g4(row,
+			_mm_set_epi32(m[s[6]], m[s[4]], m[s[2]], m[s[0]]),
+			_mm_set_epi32(m[s[7]], m[s[5]], m[s[3]], m[s[1]]));
+		row[1] = _mm_shuffle_epi32(row[1], 0x39);
+		row[2] = _mm_shuffle_epi32(row[2], 0x4e);
+		row[3] = _mm_shuffle_epi32(row[3], 0x93);
+		g4(row,
+			_mm_set_epi32(m[s[14]], m[s[12]], m[s[10]], m[s[8]]),
+			_mm_set_epi32(m[s[15]], m[s[13]], m[s[11]], m[s[9]]));
+		row[1] = _mm_shuffle_epi32(row[1], 0x93);
+		row[2] = _mm_shuffle_epi32(row[2], 0x4e);
+		row[3] = _mm_shuffle_epi32(row[3], 0x39);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+		_mm_xor_si128(row[0], row[2]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4),
+		_mm_xor_si128(row[1], row[3]));
+}
+
+#else
+
+inline uint32_t rotr(uint32_t x, int n) {
+	return (x >> n) | (x << (32 - n));
+}
+
+inline void g(uint32_t* v, int a, int b, int c, int d,
+	uint32_t mx, uint32_t my) {
+
+	v[a] = v[a] + v[b] + mx;
+	v[d] = rotr(v[d] ^ v[a], 16);
+	v[c] = v[c] + v[d];
+	v[b] = rotr(v[b] ^ v[c], 12);
+	v[a] = v[a] + v[b] + my;
+	v[d] = rotr(v[d] ^ v[a], 8);
+	v[c] = v[c] + v[d];
+	v[b] = rotr(v[b] ^ v[c], 7);
+}
+
+void compress(const uint32_t* cv, const uint32_t* m, uint32_t len,
+	uint64_t counter, uint32_t flags, uint32_t* out) {
+
+	uint32_t v[16] = {
+		cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+		blake3_iv[0], blake3_iv[1], blake3_iv[2], blake3_iv[3],
+		uint32_t(counter), uint32_t(counter >> 32), len, flags};
+
+	for (const auto& s : blake3_schedule) {
+		g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+		g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+		g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+		g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+		g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+		g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+		g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+		g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+	}
+
+	for (int i = 0; i != 8; ++i) {
+		out[i] = v[i] ^ v[i + 8];
+	}
+}
+
+#endif
+
+/** Calculate the chaining value of a parent node.
+ * @param left the chaining value of the left child
+ * @param right the chaining value of the right child
+ * @param out the chaining value of the parent
+ */
+void parent_cv(const uint32_t* left, const uint32_t* right, uint32_t* out) {
+	uint32_t m[16];
+	std::copy(left, left + 8, m);
+	std::copy(right, right + 8, m + 8);
+	compress(blake3_iv, m, block_len, 0, parent, out);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/** The number of chunks which can be compressed in parallel. */
+const size_t avx2_lanes = 8;
+
+__attribute__((target("avx2")))
+inline __m256i rotr16_8(__m256i x) {
+	return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+		13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+
+__attribute__((target("avx2")))
+inline __m256i rotr8_8(__m256i x) {
+	return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+		12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1));
+}
+
+template<int N>
+__attribute__((target("avx2")))
+inline __m256i rotr_8(__m256i x) {
+	return _mm256_or_si256(_mm256_srli_epi32(x, N),
+		_mm256_slli_epi32(x, 32 - N));
+}
+
+/** Apply the G function to one column or diagonal of eight states.
+ * @param v the states, with one word of each state per register
+ */
+__attribute__((target("avx2")))
+inline void g8(__m256i* v, int a, int b, int c, int d,
+	__m256i mx, __m256i my) {
+
+	v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), mx);
+	v[d] = rotr16_8(_mm256_xor_si256(v[d], v[a]));
+	v[c] = _mm256_add_epi32(v[c], v[d]);
+	v[b] = rotr_8<12>(_mm256_xor_si256(v[b], v[c]));
+	v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), my);
+	v[d] = rotr8_8(_mm256_xor_si256(v[d], v[a]));
+	v[c] = _mm256_add_epi32(v[c], v[d]);
+	v[b] = rotr_8<7>(_mm256_xor_si256(v[b], v[c]));
+}
+
+/** Transpose an eight by eight matrix of words.
+ * @param v the rows of the matrix, to be replaced by the columns
+ */
+__attribute__((target("avx2")))
+inline void transpose8(__m256i* v) {
+	__m256i t[8];
+	for (int i = 0; i != 8; i += 2) {
+		t[i] = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+		t[i + 1] = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+	}
+	__m256i u[8];
+	for (int i = 0; i != 8; i += 4) {
+		u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+		u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+		u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+		u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+	}
+	for (int i = 0; i != 4; ++i) {
+		v[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+		v[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+	}
+}
+
+/** Compress up to eight consecutive complete chunks in parallel.
+ * Each AVX2 lane processes a different chunk, so the message words are
+ * transposed as they are loaded and the state is held transposed.
+ * Any unused lanes repeat the last chunk, and their results are
+ * discarded.
+ * @param data the chunks
+ * @param count the number of chunks
+ * @param counter the index of the first chunk
+ * @param cvs the resulting chaining values
+ */
+__attribute__((target("avx2")))
+void compress_chunks8(const unsigned char* data, size_t count,
+	uint64_t counter, uint32_t (*cvs)[8]) {
+
+	const unsigned char* chunks[avx2_lanes];
+	for (size_t i = 0; i != avx2_lanes; ++i) {
+		chunks[i] = data + std::min(i, count - 1) * chunk_len;
+	}
+
+	alignas(32) uint32_t lanes[2][avx2_lanes];
+	for (size_t i = 0; i != avx2_lanes; ++i) {
+		lanes[0][i] = counter + i;
+		lanes[1][i] = (counter + i) >> 32;
+	}
+	const __m256i counter_lo = _mm256_load_si256(
+		reinterpret_cast<const __m256i*>(lanes[0]));
+	const __m256i counter_hi = _mm256_load_si256(
+		reinterpret_cast<const __m256i*>(lanes[1]));
+
+	__m256i h[8];
+	for (int i = 0; i != 8; ++i) {
+		h[i] = _mm256_set1_epi32(blake3_iv[i]);
+	}
+
+	for (size_t b = 0; b != chunk_len / block_len; ++b) {
+		__m256i m[16];
+		for (size_t i = 0; i != avx2_lanes; ++i) {
+			const unsigned char* block = chunks[i] + b * block_len;
+			m[i] = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(block));
+			m[i + 8] = _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(block + 32));
+		}
+		transpose8(m);
+		transpose8(m + 8);
+
+		uint32_t flags = 0;
+		if (b == 0) {
+			flags |= chunk_start;
+		}
+		if (b == chunk_len / block_len - 1) {
+			flags |= chunk_end;
+		}
+		__m256i v[16] = {
+			h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+			_mm256_set1_epi32(blake3_iv[0]),
+			_mm256_set1_epi32(blake3_iv[1]),
+			_mm256_set1_epi32(blake3_iv[2]),
+			_mm256_set1_epi32(blake3_iv[3]),
+			counter_lo, counter_hi,
+			_mm256_set1_epi32(block_len),
+			_mm256_set1_epi32(flags)};
+
+		for (const auto& s : blake3_schedule) {
+			g8(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+			g8(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+			g8(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+			g8(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+			g8(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+			g8(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+			g8(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+			g8(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+		}
+
+		for (int i = 0; i != 8; ++i) {
+			h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+		}
+	}
+
+	alignas(32) uint32_t words[8][avx2_lanes];
+	for (int i = 0; i != 8; ++i) {
+		_mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), h[i]);
+	}
+	for (size_t j = 0; j != count; ++j) {
+		for (int i = 0; i != 8; ++i) {
+			cvs[j][i] = words[i][j];
+		}
+	}
+}
+
+/** Test whether AVX2 is supported.
+ * @return true if supported, otherwise false
+ */
+bool avx2_supported() {
+	static const bool result = __builtin_cpu_supports("avx2");
+	return result;
+}
+
+#endif
+
+} /* anonymous namespace */
+
+blake3_hash::blake3_hash() {
+	_reset();
+}
+
+void blake3_hash::_reset() {
+	_cv_stack_len = 0;
+	_begin_chunk(0);
+}
+
+void blake3_hash::_begin_chunk(uint64_t counter) {
+	std::copy(blake3_iv, blake3_iv + 8, _cv);
+	_chunk_counter = counter;
+	_block_len = 0;
+	_blocks_compressed = 0;
+}
+
+void blake3_hash::_update_chunk(const unsigned char* data, size_t nbyte) {
+	while (nbyte) {
+		// A full block is compressed only once it is known that
+		// more input follows, since the last block of a chunk is
+		// flagged differently.
+		if (_block_len == block_len) {
+			uint32_t m[16];
+			load_block(_block, m);
+			uint32_t flags = (_blocks_compressed) ? 0 : chunk_start;
+			compress(_cv, m, block_len, _chunk_counter, flags, _cv);
+			_blocks_compressed += 1;
+			_block_len = 0;
+		}
+
+		size_t count = std::min(block_len - _block_len, nbyte);
+		std::memcpy(_block + _block_len, data, count);
+		_block_len += count;
+		data += count;
+		nbyte -= count;
+	}
+}
+
+void blake3_hash::_push_cv(const uint32_t* cv, uint64_t total_chunks) {
+	// Each trailing zero bit in the chunk count corresponds to a
+	// subtree which has just been completed, and which must be
+	// merged with its left sibling from the stack.
+	uint32_t merged[8];
+	std::copy(cv, cv + 8, merged);
+	while ((total_chunks & 1) == 0) {
+		_cv_stack_len -= 1;
+		parent_cv(_cv_stack[_cv_stack_len], merged, merged);
+		total_chunks >>= 1;
+	}
+	std::copy(merged, merged + 8, _cv_stack[_cv_stack_len]);
+	_cv_stack_len += 1;
+}
+
+void blake3_hash::_write_direct(const void* buf, size_t nbyte) {
+	const unsigned char* data = static_cast<const unsigned char*>(buf);
+	while (nbyte) {
+		// A full chunk is finalised only once it is known that more
+		// input follows, since the root node is flagged differently.
+		if (_chunk_len() == chunk_len) {
+			uint32_t m[16];
+			load_block(_block, m);
+			uint32_t flags = chunk_end |
+				((_blocks_compressed) ? 0 : chunk_start);
+			uint32_t cv[8];
+			compress(_cv, m, _block_len, _chunk_counter, flags, cv);
+			_push_cv(cv, _chunk_counter + 1);
+			_begin_chunk(_chunk_counter + 1);
+		}
+
+#if defined(__x86_64__) || defined(__i386__)
+		// If starting a new chunk, and the input contains at least
+		// two complete chunks followed by further input, then
+		// process up to eight of those chunks in parallel. (The
+		// last chunk must be excluded, since it might be the root.)
+		size_t batch = std::min((nbyte - 1) / chunk_len, avx2_lanes);
+		if (_chunk_len() == 0 && batch >= 2 && avx2_supported()) {
+			uint32_t cvs[avx2_lanes][8];
+			compress_chunks8(data, batch, _chunk_counter, cvs);
+			for (size_t i = 0; i != batch; ++i) {
+				_push_cv(cvs[i], _chunk_counter + i + 1);
+			}
+			_begin_chunk(_chunk_counter + batch);
+			data += batch * chunk_len;
+			nbyte -= batch * chunk_len;
+			continue;
+		}
+#endif
+
+		size_t count = std::min(chunk_len - _chunk_len(), nbyte);
+		_update_chunk(data, count);
+		data += count;
+		nbyte -= count;
+	}
+}
+
+const void* blake3_hash::final() {
+	flush();
+
+	// Prepare the final node of the current chunk.
+	uint32_t input_cv[8];
+	std::copy(_cv, _cv + 8, input_cv);
+	uint32_t m[16];
+	std::memset(_block + _block_len, 0, block_len - _block_len);
+	load_block(_block, m);
+	uint32_t len = _block_len;
+	uint64_t counter = _chunk_counter;
+	uint32_t flags = chunk_end | ((_blocks_compressed) ? 0 : chunk_start);
+
+	// Merge with the stacked subtrees, from right to left, until
+	// only the root node remains.
+	for (size_t i = _cv_stack_len; i != 0; --i) {
+		uint32_t cv[8];
+		compress(input_cv, m, len, counter, flags, cv);
+		std::copy(_cv_stack[i - 1], _cv_stack[i - 1] + 8, m);
+		std::copy(cv, cv + 8, m + 8);
+		std::copy(blake3_iv, blake3_iv + 8, input_cv);
+		len = block_len;
+		counter = 0;
+		flags = parent;
+	}
+
+	uint32_t out[8];
+	compress(input_cv, m, len, 0, flags | root, out);
+	for (int i = 0; i != 8; ++i) {
+		_hash[i * 4 + 0] = out[i];
+		_hash[i * 4 + 1] = out[i] >> 8;
+		_hash[i * 4 + 2] = out[i] >> 16;
+		_hash[i * 4 + 3] = out[i] >> 24;
+	}
+	_reset();
+	return _hash;
+}
+
+const std::string& blake3_hash::algorithm() const {
+	static const std::string name("blake3");
+	return name;
+}
+
+} /* namespace horace */
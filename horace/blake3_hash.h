@@ -0,0 +1,103 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_BLAKE3_HASH
+#define LIBHOLMES_HORACE_BLAKE3_HASH
+
+#include <cstdint>
+
+#include "horace/hash.h"
+
+namespace horace {
+
+/** An octet writer class for calculating a BLAKE3 hash.
+ * The input is divided into 1024-octet chunks, which form the leaves of
+ * a binary tree. Where enough input is available, and the processor
+ * supports AVX2, up to eight chunks are compressed in parallel.
+ * Otherwise the chunks are compressed one block at a time, using SSE2
+ * where available.
+ *
+ * The output length is fixed at 32 octets, and keyed hashing and key
+ * derivation are not supported.
+ */
+class blake3_hash:
+	public hash {
+private:
+	/** The maximum depth of the chaining value stack. */
+	static const size_t max_depth = 54;
+
+	/** The chaining value for the current chunk. */
+	uint32_t _cv[8];
+
+	/** The index of the current chunk. */
+	uint64_t _chunk_counter;
+
+	/** A buffer for accumulating a partial block. */
+	unsigned char _block[64];
+
+	/** The number of octets in _block. */
+	size_t _block_len;
+
+	/** The number of blocks compressed within the current chunk. */
+	size_t _blocks_compressed;
+
+	/** The chaining values of completed subtrees. */
+	uint32_t _cv_stack[max_depth][8];
+
+	/** The number of entries in _cv_stack. */
+	size_t _cv_stack_len;
+
+	/** The hashed result. */
+	unsigned char _hash[32];
+
+	/** Reset the hash context to its initial state. */
+	void _reset();
+
+	/** Begin a new chunk.
+	 * @param counter the index of the new chunk
+	 */
+	void _begin_chunk(uint64_t counter);
+
+	/** Get the number of octets added to the current chunk.
+	 * @return the number of octets
+	 */
+	size_t _chunk_len() const {
+		return _blocks_compressed * 64 + _block_len;
+	}
+
+	/** Add input to the current chunk.
+	 * The input must not overflow the chunk.
+	 * @param data the input
+	 * @param nbyte the number of octets of input
+	 */
+	void _update_chunk(const unsigned char* data, size_t nbyte);
+
+	/** Add the chaining value of a completed chunk to the tree.
+	 * Any subtrees which have been completed as a result are merged.
+	 * @param cv the chaining value
+	 * @param total_chunks the number of chunks completed so far
+	 */
+	void _push_cv(const uint32_t* cv, uint64_t total_chunks);
+protected:
+	virtual void _write_direct(const void* buf, size_t nbyte);
+public:
+	/** Construct BLAKE3 octet writer. */
+	blake3_hash();
+
+	blake3_hash(const blake3_hash& that) = delete;
+	blake3_hash& operator=(const blake3_hash& that) = delete;
+
+	virtual const void* final();
+
+	virtual size_t length() const {
+		return 32;
+	}
+
+	virtual const std::string& algorithm() const;
+};
+
+} /* namespace horace */
+
+#endif
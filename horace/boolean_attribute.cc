@@ -67,4 +67,8 @@ void boolean_attribute::write(octet_writer& out) const {
 	out.write(_content);
 }
 
+void boolean_attribute::write_content(octet_writer& out) const {
+	out.write(_content);
+}
+
 } /* namespace horace */
@@ -8,6 +8,8 @@
 
 #include <memory>
 
+#include "horace/buffer_pool.h"
+
 namespace horace {
 
 /** A base class for providing a buffer as part of another class.
@@ -21,16 +23,74 @@ private:
 
 	/** The size of the buffer. */
 	size_t _size;
+
+	/** The pool from which the buffer was acquired, or null if none. */
+	buffer_pool* _pool;
+
+	/** Return the buffer to its pool, if it has one. */
+	void _release() {
+		if (_pool && _buffer) {
+			_pool->release(std::move(_buffer));
+		}
+	}
 public:
 	/** Construct null buffer. */
-	buffer() {}
+	buffer():
+		_size(0),
+		_pool(0) {}
 
 	/** Construct buffer.
 	 * @param size the required size of the buffer, in octets
 	 */
 	explicit buffer(size_t size):
 		_buffer(std::make_unique<char[]>(size)),
-		_size(size) {}
+		_size(size),
+		_pool(0) {}
+
+	/** Construct buffer from pool.
+	 * The buffer is returned to the pool when this object is
+	 * destroyed.
+	 * @param pool the pool from which to acquire the buffer
+	 */
+	explicit buffer(buffer_pool& pool):
+		_buffer(pool.acquire()),
+		_size(pool.size()),
+		_pool(&pool) {}
+
+	~buffer() {
+		_release();
+	}
+
+	buffer(const buffer&) = delete;
+	buffer& operator=(const buffer&) = delete;
+
+	/** Move-construct buffer.
+	 * @param that the buffer to be moved
+	 */
+	buffer(buffer&& that):
+		_buffer(std::move(that._buffer)),
+		_size(that._size),
+		_pool(that._pool) {
+
+		that._size = 0;
+		that._pool = 0;
+	}
+
+	/** Move-assign buffer.
+	 * @param that the buffer to be moved
+	 * @return a reference to this
+	 */
+	buffer& operator=(buffer&& that) {
+		if (this != &that) {
+			_release();
+			_buffer = std::move(that._buffer);
+			_size = that._size;
+			_pool = that._pool;
+			that._size = 0;
+			that._pool = 0;
+		}
+		return *this;
+	}
 
 	/** Get a pointer to the buffer.
 	 * @return a pointer to the buffer
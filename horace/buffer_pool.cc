@@ -0,0 +1,36 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/buffer_pool.h"
+
+namespace horace {
+
+buffer_pool::buffer_pool(size_t size, size_t max_free):
+	_size(size),
+	_max_free(max_free) {}
+
+std::unique_ptr<char[]> buffer_pool::acquire() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		if (!_free.empty()) {
+			std::unique_ptr<char[]> buf = std::move(_free.back());
+			_free.pop_back();
+			return buf;
+		}
+	}
+
+	// Allocate without zeroing, since the content of a buffer is
+	// never read before it has been written.
+	return std::unique_ptr<char[]>(new char[_size]);
+}
+
+void buffer_pool::release(std::unique_ptr<char[]> buf) {
+	std::lock_guard<std::mutex> lk(_mutex);
+	if (_free.size() < _max_free) {
+		_free.push_back(std::move(buf));
+	}
+}
+
+} /* namespace horace */
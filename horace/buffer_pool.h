@@ -0,0 +1,66 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_BUFFER_POOL
+#define LIBHOLMES_HORACE_BUFFER_POOL
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace horace {
+
+/** A class for recycling buffers of a given size.
+ * This is intended for use by endpoints which repeatedly create and
+ * destroy octet readers and writers with large buffers (for example,
+ * one per spoolfile or per connection), so that the buffers need not
+ * be allocated and zeroed each time. It is safe for buffers to be
+ * acquired and released concurrently by different threads.
+ */
+class buffer_pool {
+private:
+	/** A mutex to protect _free. */
+	std::mutex _mutex;
+
+	/** The size of each buffer, in octets. */
+	size_t _size;
+
+	/** The maximum number of free buffers to be retained. */
+	size_t _max_free;
+
+	/** The buffers which are available for reuse. */
+	std::vector<std::unique_ptr<char[]>> _free;
+public:
+	/** Construct buffer pool.
+	 * @param size the size of each buffer, in octets
+	 * @param max_free the maximum number of free buffers to retain
+	 */
+	explicit buffer_pool(size_t size, size_t max_free = 16);
+
+	buffer_pool(const buffer_pool&) = delete;
+	buffer_pool& operator=(const buffer_pool&) = delete;
+
+	/** Get the size of the buffers in this pool.
+	 * @return the size of each buffer, in octets
+	 */
+	size_t size() const {
+		return _size;
+	}
+
+	/** Acquire a buffer from this pool.
+	 * A new buffer is allocated if none are free.
+	 * @return the buffer
+	 */
+	std::unique_ptr<char[]> acquire();
+
+	/** Release a buffer back to this pool.
+	 * @param buf the buffer, which must have been acquired from this pool
+	 */
+	void release(std::unique_ptr<char[]> buf);
+};
+
+} /* namespace horace */
+
+#endif
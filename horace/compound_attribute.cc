@@ -53,4 +53,8 @@ void compound_attribute::write(octet_writer& out) const {
 	_attrlist.write(out);
 }
 
+void compound_attribute::write_content(octet_writer& out) const {
+	_attrlist.write(out);
+}
+
 } /* namespace horace */
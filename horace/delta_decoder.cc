@@ -0,0 +1,90 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/horace_error.h"
+#include "horace/boolean_attribute.h"
+#include "horace/signed_integer_attribute.h"
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/timestamp_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/delta_decoder.h"
+
+namespace horace {
+
+delta_decoder::delta_decoder():
+	_enabled(false),
+	_have_ts(false),
+	_prev_ts({0}),
+	_have_seqnum(false),
+	_prev_seqnum(0) {}
+
+void delta_decoder::begin_session() {
+	_enabled = false;
+	_have_ts = false;
+	_have_seqnum = false;
+}
+
+void delta_decoder::handle_delta_encoding(const attribute& attr) {
+	_enabled = dynamic_cast<const boolean_attribute&>(attr).content();
+}
+
+std::unique_ptr<attribute> delta_decoder::decode_ts(
+	const signed_integer_attribute& attr) const {
+
+	if (!_enabled || !_have_ts) {
+		throw horace_error("unexpected ts_delta attribute");
+	}
+
+	// Division rounds towards zero, so the remainder must be
+	// adjusted if it is negative.
+	int64_t nsec = _prev_ts.tv_nsec + attr.content();
+	int64_t sec = _prev_ts.tv_sec + nsec / 1000000000;
+	nsec %= 1000000000;
+	if (nsec < 0) {
+		nsec += 1000000000;
+		sec -= 1;
+	}
+	if (sec < 0) {
+		throw horace_error("invalid ts_delta attribute");
+	}
+	return std::make_unique<timestamp_attribute>(attrid_ts, sec, nsec);
+}
+
+void delta_decoder::end_event(attribute_list& attrs) {
+	// As when encoding, the timestamp and sequence number are recorded
+	// only if there is exactly one of each.
+	const timestamp_attribute* ts_attr = 0;
+	const unsigned_integer_attribute* seqnum_attr = 0;
+	int ts_count = 0;
+	int seqnum_count = 0;
+	for (const attribute* attr : attrs) {
+		switch (attr->attrid()) {
+		case attrid_ts:
+			ts_attr = dynamic_cast<const timestamp_attribute*>(attr);
+			ts_count += 1;
+			break;
+		case attrid_seqnum:
+			seqnum_attr = dynamic_cast<const unsigned_integer_attribute*>(attr);
+			seqnum_count += 1;
+			break;
+		}
+	}
+
+	if (ts_count == 1 && ts_attr) {
+		_prev_ts = ts_attr->content();
+		_have_ts = true;
+	}
+
+	if (seqnum_count == 0 && _have_seqnum) {
+		_prev_seqnum += 1;
+		attrs.insert(std::make_unique<unsigned_integer_attribute>(
+			attrid_seqnum, _prev_seqnum));
+	} else if (seqnum_count == 1 && seqnum_attr) {
+		_prev_seqnum = seqnum_attr->content();
+		_have_seqnum = true;
+	}
+}
+
+} /* namespace horace */
@@ -0,0 +1,79 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_DELTA_DECODER
+#define LIBHOLMES_HORACE_DELTA_DECODER
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+
+namespace horace {
+
+class attribute;
+class signed_integer_attribute;
+class attribute_list;
+
+/** A class for reversing the encoding applied by a delta_encoder.
+ * Decoding is enabled by a delta_encoding attribute within a session
+ * record, and remains in effect until the next session record.
+ */
+class delta_decoder {
+private:
+	/** True if decoding is enabled, otherwise false. */
+	bool _enabled;
+
+	/** True if a timestamp has been recorded, otherwise false. */
+	bool _have_ts;
+
+	/** The timestamp of the previous event record. */
+	struct timespec _prev_ts;
+
+	/** True if a sequence number has been recorded, otherwise false. */
+	bool _have_seqnum;
+
+	/** The sequence number of the previous event record. */
+	uint64_t _prev_seqnum;
+public:
+	/** Construct delta decoder. */
+	delta_decoder();
+
+	/** Determine whether decoding is enabled.
+	 * @return true if enabled, otherwise false
+	 */
+	bool enabled() const {
+		return _enabled;
+	}
+
+	/** Handle the start of a session record.
+	 * This disables decoding until a delta_encoding attribute is seen.
+	 */
+	void begin_session();
+
+	/** Handle a delta_encoding attribute within a session record.
+	 * @param attr the delta_encoding attribute
+	 */
+	void handle_delta_encoding(const attribute& attr);
+
+	/** Decode a ts_delta attribute.
+	 * @param attr the ts_delta attribute
+	 * @return the corresponding timestamp attribute
+	 */
+	std::unique_ptr<attribute> decode_ts(
+		const signed_integer_attribute& attr) const;
+
+	/** Complete the decoding of an event record.
+	 * This inserts the sequence number if it was omitted, then
+	 * records the timestamp and sequence number for use when decoding
+	 * the next event record. It must be called only if decoding is
+	 * enabled.
+	 * @param attrs the attributes of the event record
+	 */
+	void end_event(attribute_list& attrs);
+};
+
+} /* namespace horace */
+
+#endif
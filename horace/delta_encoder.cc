@@ -0,0 +1,120 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/horace_error.h"
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/timestamp_attribute.h"
+#include "horace/delta_encoder.h"
+
+namespace horace {
+
+namespace {
+
+/** The largest difference between timestamps, in seconds, which will
+ * be delta encoded. This ensures that the difference in nanoseconds
+ * cannot overflow. */
+const int64_t max_delta_sec = int64_t(1) << 32;
+
+} /* anonymous namespace */
+
+delta_encoder::delta_encoder():
+	_have_ts(false),
+	_prev_ts({0}),
+	_have_seqnum(false),
+	_prev_seqnum(0),
+	_marker(attrid_delta_encoding, true) {}
+
+const record& delta_encoder::_encode_session(const record& srec) {
+	_have_ts = false;
+	_have_seqnum = false;
+
+	for (const attribute* attr : srec.attributes()) {
+		_attrs.insert(*attr);
+	}
+	_attrs.insert(_marker);
+	_erec.assign(srec.channel_id(), std::move(_attrs));
+	return _erec;
+}
+
+const record& delta_encoder::_encode_event(const record& rec) {
+	// Timestamps and sequence numbers are encoded only if there is
+	// exactly one of each, since otherwise it would be unclear which
+	// to use as the basis for the next record.
+	const timestamp_attribute* ts_attr = 0;
+	const unsigned_integer_attribute* seqnum_attr = 0;
+	int ts_count = 0;
+	int seqnum_count = 0;
+	for (const attribute* attr : rec.attributes()) {
+		switch (attr->attrid()) {
+		case attrid_ts:
+			ts_attr = dynamic_cast<const timestamp_attribute*>(attr);
+			ts_count += 1;
+			break;
+		case attrid_seqnum:
+			seqnum_attr = dynamic_cast<const unsigned_integer_attribute*>(attr);
+			seqnum_count += 1;
+			break;
+		}
+	}
+	if (ts_count != 1) {
+		ts_attr = 0;
+	}
+	if (seqnum_count != 1) {
+		seqnum_attr = 0;
+	}
+
+	// A missing sequence number cannot be distinguished from an
+	// implicit one.
+	if (seqnum_count == 0 && _have_seqnum) {
+		throw horace_error(
+			"sequence number required for delta encoding");
+	}
+
+	// A timestamp is replaced by a delta only if the result can be
+	// decoded to give an identical timestamp, which would not be
+	// the case if the nsec field were not normalised.
+	const attribute* omit_ts = 0;
+	if (ts_attr) {
+		struct timespec ts = ts_attr->content();
+		if (_have_ts && (ts.tv_nsec < 1000000000)) {
+			int64_t delta_sec = int64_t(ts.tv_sec) - _prev_ts.tv_sec;
+			if ((delta_sec < max_delta_sec) &&
+				(delta_sec > -max_delta_sec)) {
+
+				int64_t delta = delta_sec * 1000000000 +
+					(ts.tv_nsec - _prev_ts.tv_nsec);
+				_ts_delta.emplace(attrid_ts_delta, delta);
+				omit_ts = ts_attr;
+			}
+		}
+		_prev_ts = ts;
+		_have_ts = true;
+	}
+
+	const attribute* omit_seqnum = 0;
+	if (seqnum_attr) {
+		uint64_t seqnum = seqnum_attr->content();
+		if (_have_seqnum && (seqnum == _prev_seqnum + 1)) {
+			omit_seqnum = seqnum_attr;
+		}
+		_prev_seqnum = seqnum;
+		_have_seqnum = true;
+	}
+
+	// The encoded record refers to the attributes of the original
+	// record, rather than copying them.
+	for (const attribute* attr : rec.attributes()) {
+		if ((attr != omit_ts) && (attr != omit_seqnum)) {
+			_attrs.insert(*attr);
+		}
+	}
+	if (omit_ts) {
+		_attrs.insert(*_ts_delta);
+	}
+	_erec.assign(rec.channel_id(), std::move(_attrs));
+	return _erec;
+}
+
+} /* namespace horace */
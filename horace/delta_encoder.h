@@ -0,0 +1,102 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_DELTA_ENCODER
+#define LIBHOLMES_HORACE_DELTA_ENCODER
+
+#include <cstdint>
+#include <ctime>
+#include <optional>
+
+#include "horace/boolean_attribute.h"
+#include "horace/signed_integer_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/record.h"
+
+namespace horace {
+
+/** A class for delta encoding a stream of records.
+ * Within each event record, the timestamp is replaced by a ts_delta
+ * attribute giving the number of nanoseconds since the timestamp of
+ * the previous event record, and the sequence number is omitted if it
+ * is one greater than that of the previous event record. Session
+ * records are marked with a delta_encoding attribute, so that the
+ * encoding can be reversed when the stream is read (by means of a
+ * delta_decoder). Other records are left unchanged.
+ *
+ * Each session record resets the encoding state, so a stream can be
+ * decoded starting from any session record. The original records are
+ * reconstructed exactly, therefore hashes and signatures are not
+ * affected.
+ *
+ * If one event record has a sequence number then all subsequent ones
+ * must, as is the case for sessions created by new_session_writer.
+ */
+class delta_encoder {
+private:
+	/** True if a timestamp has been recorded, otherwise false. */
+	bool _have_ts;
+
+	/** The timestamp of the previous event record. */
+	struct timespec _prev_ts;
+
+	/** True if a sequence number has been recorded, otherwise false. */
+	bool _have_seqnum;
+
+	/** The sequence number of the previous event record. */
+	uint64_t _prev_seqnum;
+
+	/** The attribute used to mark session records. */
+	boolean_attribute _marker;
+
+	/** The ts_delta attribute for the current event record. */
+	std::optional<signed_integer_attribute> _ts_delta;
+
+	/** The attribute list for the encoded record.
+	 * This is retained so that its storage can be reused.
+	 */
+	attribute_list _attrs;
+
+	/** The encoded record. */
+	record _erec;
+
+	/** Encode a session record.
+	 * @param srec the session record
+	 * @return the encoded record
+	 */
+	const record& _encode_session(const record& srec);
+
+	/** Encode an event record.
+	 * @param rec the event record
+	 * @return the encoded record
+	 */
+	const record& _encode_event(const record& rec);
+public:
+	/** Construct delta encoder. */
+	delta_encoder();
+
+	delta_encoder(const delta_encoder&) = delete;
+	delta_encoder& operator=(const delta_encoder&) = delete;
+
+	/** Encode a record.
+	 * The result refers to the attributes of the original record,
+	 * and remains valid until the original record is destroyed or
+	 * this function is next called.
+	 * @param rec the record to be encoded
+	 * @return the encoded record
+	 */
+	const record& encode(const record& rec) {
+		if (rec.is_event()) {
+			return _encode_event(rec);
+		} else if (rec.channel_id() == channel_session) {
+			return _encode_session(rec);
+		}
+		return rec;
+	}
+};
+
+} /* namespace horace */
+
+#endif
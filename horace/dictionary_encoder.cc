@@ -0,0 +1,142 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+
+#include "horace/signed_integer_attribute.h"
+#include "horace/string_attribute.h"
+#include "horace/string_ref_attribute.h"
+#include "horace/dictionary_encoder.h"
+
+namespace horace {
+
+namespace {
+
+/** The maximum number of entries in the dictionary.
+ * This matches the limit imposed by session_context when decoding.
+ * Once it has been reached, further values are written in full.
+ */
+const size_t max_entries = 0x10000;
+
+/** The maximum length of a value which will be added to the
+ * dictionary. This is sufficient for any valid hostname. */
+const size_t max_value_length = 0xff;
+
+/** Get the content of a string attribute.
+ * @param attr the attribute
+ * @param content a buffer to receive the content
+ * @return true if the attribute is a string attribute, otherwise false
+ */
+bool get_string(const attribute& attr, std::string_view& content) {
+	if (auto sattr = dynamic_cast<const string_attribute*>(&attr)) {
+		content = sattr->content();
+		return true;
+	} else if (auto sattr = dynamic_cast<const string_ref_attribute*>(&attr)) {
+		content = sattr->content();
+		return true;
+	}
+	return false;
+}
+
+} /* anonymous namespace */
+
+dictionary_encoder::dictionary_encoder(
+	const std::vector<std::string>& labels):
+	_labels(labels) {}
+
+int dictionary_encoder::_find(int attrid) const {
+	auto f = std::find(_attrids.begin(), _attrids.end(), attrid);
+	return (f != _attrids.end()) ? f - _attrids.begin() : -1;
+}
+
+void dictionary_encoder::_begin_session(const record& srec) {
+	_attrids.clear();
+	_indices.clear();
+	_values.clear();
+
+	for (const attribute* attr : srec.attributes()) {
+		if (attr->attrid() != attrid_attr_def) {
+			continue;
+		}
+		const attribute_list& def =
+			dynamic_cast<const compound_attribute&>(*attr).content();
+		const std::string& label = def.find_one<string_attribute>(
+			attrid_attr_label).content();
+		uint64_t type = def.find_one<unsigned_integer_attribute>(
+			attrid_type).content();
+		if ((type == type_string) && (std::find(_labels.begin(),
+			_labels.end(), label) != _labels.end())) {
+
+			_attrids.push_back(def.find_one<signed_integer_attribute>(
+				attrid_attr_id).content());
+		}
+	}
+
+	_indices.resize(_attrids.size());
+	_counts.resize(_attrids.size());
+	_refs.assign(_attrids.size(),
+		unsigned_integer_attribute(attrid_dict_ref, 0));
+	_defs.resize(_attrids.size());
+}
+
+const record& dictionary_encoder::_encode_event(const record& rec) {
+	if (_attrids.empty()) {
+		return rec;
+	}
+
+	// Count the instances of each attribute to which the dictionary
+	// applies. Those with more than one instance are left unchanged,
+	// since otherwise their order could not be preserved.
+	std::fill(_counts.begin(), _counts.end(), 0);
+	bool found = false;
+	for (const attribute* attr : rec.attributes()) {
+		int pos = _find(attr->attrid());
+		if (pos >= 0) {
+			_counts[pos] += 1;
+			found = true;
+		}
+	}
+	if (!found) {
+		return rec;
+	}
+
+	// The encoded record refers to the attributes of the original
+	// record, rather than copying them.
+	for (const attribute* attr : rec.attributes()) {
+		int pos = _find(attr->attrid());
+		std::string_view value;
+		if ((pos < 0) || (_counts[pos] != 1) ||
+			!get_string(*attr, value)) {
+
+			_attrs.insert(*attr);
+			continue;
+		}
+
+		auto& indices = _indices[pos];
+		auto f = indices.find(value);
+		if (f != indices.end()) {
+			_refs[pos] = unsigned_integer_attribute(
+				attrid_dict_ref, f->second);
+			_attrs.insert(_refs[pos]);
+		} else if ((_values.size() < max_entries) &&
+			(value.length() <= max_value_length)) {
+
+			uint64_t index = _values.size();
+			_values.emplace_back(value);
+			indices.emplace(_values.back(), index);
+
+			attribute_list subattrs;
+			subattrs.insert(*attr);
+			_defs[pos].emplace(attrid_dict_def, std::move(subattrs));
+			_attrs.insert(*_defs[pos]);
+		} else {
+			_attrs.insert(*attr);
+		}
+	}
+	_erec.assign(rec.channel_id(), std::move(_attrs));
+	return _erec;
+}
+
+} /* namespace horace */
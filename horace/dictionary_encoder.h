@@ -0,0 +1,127 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_DICTIONARY_ENCODER
+#define LIBHOLMES_HORACE_DICTIONARY_ENCODER
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/compound_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/record.h"
+
+namespace horace {
+
+/** A class for encoding a stream of records using a string dictionary.
+ * This is intended for string attributes, such as hostnames, which
+ * take a small number of distinct values but occur in a large number
+ * of records. Each value is written in full once per session, wrapped
+ * in a dict_def attribute which adds it to the dictionary. Subsequent
+ * occurrences of the same value are replaced by a dict_ref attribute
+ * which gives its index within the dictionary. Indices are allocated
+ * consecutively from zero, in the order in which the values were
+ * defined.
+ *
+ * The attributes to which the dictionary applies are selected by
+ * label, and are identified using the attribute definitions in the
+ * session record. Only event records which contain exactly one
+ * instance of a given attribute are encoded in this way, so that the
+ * order of attributes is preserved. Each session record clears the
+ * dictionary, so that a stream can be decoded starting from any
+ * session record.
+ *
+ * Records are reconstructed exactly when they are read, therefore
+ * hashes and signatures are not affected.
+ */
+class dictionary_encoder {
+private:
+	/** The labels of the attributes to which the dictionary applies. */
+	std::vector<std::string> _labels;
+
+	/** The IDs of the attributes to which the dictionary applies,
+	 * for the current session. */
+	std::vector<int> _attrids;
+
+	/** The dictionary index of each value, for each attribute ID in
+	 * _attrids. The keys refer to the content of _values. */
+	std::vector<std::unordered_map<std::string_view, uint64_t>> _indices;
+
+	/** Storage for the values which have been added to the
+	 * dictionary. */
+	std::deque<std::string> _values;
+
+	/** The number of instances of each attribute ID in _attrids
+	 * within the current record. */
+	std::vector<int> _counts;
+
+	/** The dict_ref attribute for each attribute ID in _attrids,
+	 * for the current record. */
+	std::vector<unsigned_integer_attribute> _refs;
+
+	/** The dict_def attribute for each attribute ID in _attrids,
+	 * for the current record. */
+	std::vector<std::optional<compound_attribute>> _defs;
+
+	/** The attribute list for the encoded record.
+	 * This is retained so that its storage can be reused.
+	 */
+	attribute_list _attrs;
+
+	/** The encoded record. */
+	record _erec;
+
+	/** Find the position of an attribute ID within _attrids.
+	 * @param attrid the attribute ID
+	 * @return the position, or -1 if not found
+	 */
+	int _find(int attrid) const;
+
+	/** Handle a session record.
+	 * @param srec the session record
+	 */
+	void _begin_session(const record& srec);
+
+	/** Encode an event record.
+	 * @param rec the event record
+	 * @return the encoded record
+	 */
+	const record& _encode_event(const record& rec);
+public:
+	/** Construct dictionary encoder.
+	 * @param labels the labels of the attributes to which the
+	 *  dictionary applies
+	 */
+	explicit dictionary_encoder(const std::vector<std::string>& labels);
+
+	dictionary_encoder(const dictionary_encoder&) = delete;
+	dictionary_encoder& operator=(const dictionary_encoder&) = delete;
+
+	/** Encode a record.
+	 * The result refers to the attributes of the original record,
+	 * and remains valid until the original record is destroyed or
+	 * this function is next called.
+	 * @param rec the record to be encoded
+	 * @return the encoded record
+	 */
+	const record& encode(const record& rec) {
+		if (rec.is_event()) {
+			return _encode_event(rec);
+		} else if (rec.channel_id() == channel_session) {
+			_begin_session(rec);
+		}
+		return rec;
+	}
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,22 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/octet_writer.h"
+#include "horace/encoded_record.h"
+
+namespace horace {
+
+void encoded_record::assign(int channel, attribute_list&& attributes) {
+	record::assign(channel, std::move(attributes));
+	_encoding.resize(record::length());
+	octet_writer out(_encoding.data(), _encoding.length());
+	record::write(out);
+}
+
+void encoded_record::write(octet_writer& out) const {
+	out.write(_encoding.data(), _encoding.length());
+}
+
+} /* namespace horace */
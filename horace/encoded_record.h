@@ -0,0 +1,66 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_ENCODED_RECORD
+#define LIBHOLMES_HORACE_ENCODED_RECORD
+
+#include <string>
+
+#include "horace/record.h"
+
+namespace horace {
+
+/** A class to represent a record which retains its own encoding.
+ * The record is encoded once, when its content is assigned, after which
+ * it can be written any number of times (for example, to an endpoint and
+ * to a hash function) by copying the encoded octets. The storage used
+ * for the encoding is reused when new content is assigned.
+ */
+class encoded_record:
+	public record {
+private:
+	/** The encoded record. */
+	std::string _encoding;
+public:
+	/** Construct empty encoded record. */
+	encoded_record() = default;
+
+	/** Replace the content of this record, then encode it.
+	 * As with record::assign, the storage used by the previous
+	 * attribute list is passed back by way of the attributes argument.
+	 * @param channel the channel ID
+	 * @param attributes the list of attributes
+	 */
+	void assign(int channel, attribute_list&& attributes);
+
+	/** Release the attribute list, retaining only the encoding.
+	 * This allows the attribute list to refer to storage which does
+	 * not outlive the record, provided that it is released once the
+	 * attributes are no longer needed. The storage used by the list
+	 * is passed back by way of the attributes argument, which must
+	 * be empty.
+	 * @param attributes an empty list to receive the storage
+	 */
+	void release_attributes(attribute_list&& attributes) {
+		record::assign(channel_id(), std::move(attributes));
+	}
+
+	/** Get the encoded record.
+	 * @return the encoded record
+	 */
+	const std::string& encoding() const {
+		return _encoding;
+	}
+
+	virtual size_t length() const {
+		return _encoding.length();
+	}
+
+	virtual void write(octet_writer& out) const;
+};
+
+} /* namespace horace */
+
+#endif
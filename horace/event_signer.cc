@@ -4,13 +4,19 @@
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
 
 #include "poll.h"
 
 #include "horace/terminate_exception.h"
+#include "horace/horace_error.h"
 #include "horace/libc_error.h"
 #include "horace/terminate_flag.h"
 #include "horace/keypair.h"
+#include "horace/hash.h"
+#include "horace/stats_timer.h"
 #include "horace/binary_attribute.h"
 #include "horace/unsigned_integer_attribute.h"
 #include "horace/attribute_list.h"
@@ -21,7 +27,7 @@
 
 namespace horace {
 
-void event_signer::_run() {
+void event_signer::_sign_chain() {
 	// Create a lock for locking the mutex.
 	// Note that holding this lock will, in short order, prevent events
 	// from being captured by any event source. For this reason it
@@ -30,34 +36,113 @@ void event_signer::_run() {
 	// - It should not be held while the signature is being generated
 	std::unique_lock<std::mutex> lk(_mutex, std::defer_lock);
 
-	try {
-		while (true) {
-			// Wait for an event to be available for signing.
-			lk.lock();
-			while (terminating.poll(), _hash.empty()) {
-				_cv.wait(lk);
+	while (true) {
+		// Wait for an event to be available for signing.
+		lk.lock();
+		while (terminating.poll(), _hash.empty()) {
+			_cv.wait(lk);
+		}
+		lk.unlock();
+
+		// Sleep for the requested delay period before signing.
+		terminating.millisleep(_delay);
+
+		// Get the sequence number and hash for the most recent
+		// event record captured. Note that this may be different
+		// from the event record which triggered the condition
+		// variable.
+		// Following this operation, _hash is left empty to
+		// indicate that no further signatures should be
+		// generated until a new event record is seen.
+		lk.lock();
+		uint64_t sig_seqnum = _seqnum;
+		std::basic_string<unsigned char> sig_hash;
+		sig_hash.swap(_hash);
+		lk.unlock();
+
+		// Sign the hashed record, then record the signature.
+		std::unique_ptr<record> sigrec;
+		{
+			stats_timer timer(_sign_ns);
+			sigrec = make_signature(&sig_seqnum, sig_hash);
+		}
+		_nsw->write_signature(*sigrec);
+	}
+}
+
+void event_signer::_sign_batches() {
+	// The same considerations apply to holding the mutex as for
+	// _sign_chain.
+	std::unique_lock<std::mutex> lk(_mutex, std::defer_lock);
+
+	while (true) {
+		// Wait for a leaf to be available for signing.
+		lk.lock();
+		while (terminating.poll(), _ready == 0) {
+			_cv.wait(lk);
+		}
+
+		// Allow up to the requested delay period for a full batch
+		// to accumulate, but sign immediately if there is one.
+		auto deadline = std::chrono::steady_clock::now() +
+			std::chrono::milliseconds(_delay);
+		while (terminating.poll(), _ready < _batch) {
+			if (_cv.wait_until(lk, deadline) ==
+				std::cv_status::timeout) {
+
+				break;
 			}
-			lk.unlock();
-
-			// Sleep for the requested delay period before signing.
-			terminating.millisleep(_delay);
-
-			// Get the sequence number and hash for the most recent
-			// event record captured. Note that this may be different
-			// from the event record which triggered the condition
-			// variable.
-			// Following this operation, _hash is left empty to
-			// indicate that no further signatures should be
-			// generated until a new event record is seen.
-			lk.lock();
-			uint64_t sig_seqnum = _seqnum;
-			std::basic_string<unsigned char> sig_hash;
-			sig_hash.swap(_hash);
-			lk.unlock();
-
-			// Sign the hashed record, then record the signature.
-			auto sigrec = make_signature(&sig_seqnum, sig_hash);
-			_nsw->write_signature(*sigrec);
+		}
+		uint64_t first = _take_batch();
+		lk.unlock();
+
+		// Calculate the root hash and sign it, then record the
+		// signature.
+		std::unique_ptr<record> sigrec;
+		{
+			stats_timer timer(_sign_ns);
+			sigrec = _make_batch_signature(first);
+		}
+		_nsw->write_signature(*sigrec);
+	}
+}
+
+uint64_t event_signer::_take_batch() {
+	uint64_t first = _base;
+	size_t count = std::min(_ready, _batch);
+	for (size_t i = 0; i != count; ++i) {
+		_tree->add(std::move(_leaves.front()));
+		_leaves.pop_front();
+	}
+	_base += count;
+	_ready -= count;
+	return first;
+}
+
+std::unique_ptr<record> event_signer::_make_batch_signature(uint64_t first) {
+	uint64_t count = _tree->size();
+	std::basic_string<unsigned char> root = _tree->root();
+	std::string sig = _kp->sign(root.data(), root.length());
+
+	attribute_list sigattrs;
+	sigattrs.insert(std::make_unique<unsigned_integer_attribute>(
+		attrid_seqnum, first));
+	sigattrs.insert(std::make_unique<unsigned_integer_attribute>(
+		attrid_hash_count, count));
+	sigattrs.insert(std::make_unique<binary_attribute>(
+		attrid_hash, root.length(), root.data()));
+	sigattrs.insert(std::make_unique<binary_attribute>(
+		attrid_sig, sig.length(), sig.data()));
+	return std::make_unique<record>(channel_signature,
+		std::move(sigattrs));
+}
+
+void event_signer::_run() {
+	try {
+		if (_batch) {
+			_sign_batches();
+		} else {
+			_sign_chain();
 		}
 	} catch (terminate_exception&) {
 		// No action.
@@ -71,11 +156,24 @@ void event_signer::_do_run(event_signer& signer) {
 }
 
 event_signer::event_signer(new_session_writer& nsw, keypair& kp,
-	long delay):
+	long delay, const hash* hashfn, size_t batch):
 	_nsw(&nsw),
 	_kp(&kp),
-	_delay(delay) {
+	_delay(delay),
+	_batch(batch),
+	_base(0),
+	_ready(0),
+	_stats("signer"),
+	_sign_ns(_stats.histogram("sign_ns")) {
 
+	if (_batch) {
+		if (!hashfn) {
+			throw std::invalid_argument(
+				"hash function required for batched signatures");
+		}
+		_nodefn = hash::make(hashfn->algorithm());
+		_tree = std::make_unique<merkle_tree>(*_nodefn);
+	}
 	_thread = std::thread(_do_run, std::ref(*this));
 }
 
@@ -109,6 +207,46 @@ void event_signer::handle_event(uint64_t seqnum,
 	_cv.notify_one();
 }
 
+void event_signer::handle_leaf(uint64_t seqnum,
+	std::basic_string<unsigned char>&& leaf) {
+
+	bool notify = false;
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		if (seqnum < _base) {
+			throw horace_error(std::string("leaf ") +
+				std::to_string(seqnum) + " already signed");
+		}
+		size_t index = seqnum - _base;
+		if (index >= _leaves.size()) {
+			_leaves.resize(index + 1);
+		}
+		_leaves[index] = std::move(leaf);
+
+		// Wake the signing thread only when there are leaves for it
+		// to begin waiting on, or when a batch is complete.
+		size_t ready = _ready;
+		while ((_ready != _leaves.size()) && !_leaves[_ready].empty()) {
+			_ready += 1;
+		}
+		notify = ((ready == 0) && (_ready != 0)) ||
+			((ready < _batch) && (_ready >= _batch));
+	}
+	if (notify) {
+		_cv.notify_one();
+	}
+}
+
+std::vector<std::unique_ptr<record>> event_signer::make_batch_signatures() {
+	std::lock_guard<std::mutex> lk(_mutex);
+	std::vector<std::unique_ptr<record>> sigrecs;
+	while (_ready != 0) {
+		uint64_t first = _take_batch();
+		sigrecs.push_back(_make_batch_signature(first));
+	}
+	return sigrecs;
+}
+
 void event_signer::stop() {
 	// The thread may be waiting on the condition variable,
 	// so send it a notification. The mutex must be locked
@@ -9,14 +9,21 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <deque>
+#include <vector>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 
+#include "horace/stats_group.h"
+#include "horace/merkle_tree.h"
+
 namespace horace {
 
 class hash;
 class keypair;
+class record;
 class session_builder;
 class new_session_writer;
 
@@ -25,6 +32,14 @@ class new_session_writer;
  * avoid stalling the event capture thread(s) while a signature is being
  * computed, and to allow signature records to be written when indicated by
  * the timer even if the capture thread(s) are blocked at the time.
+ *
+ * Two modes of operation are supported. By default, event records are
+ * expected to form a hash chain, and only the most recent hash offered
+ * is signed. Alternatively, if a batch size is given, then each event
+ * record is hashed independently to form the leaf of a Merkle tree, and
+ * the root of the tree is signed once per batch. This allows any event
+ * to be verified using only the records in its own batch, and allows the
+ * leaf hashes to be calculated concurrently.
  */
 class event_signer {
 private:
@@ -53,6 +68,56 @@ private:
 	/** The most recent hash presented for potential signing. */
 	std::basic_string<unsigned char> _hash;
 
+	/** The maximum number of leaves per Merkle tree,
+	 * or 0 if events are chained instead. */
+	size_t _batch;
+
+	/** The hash function for the interior nodes of each Merkle tree,
+	 * or 0 if events are chained. */
+	std::unique_ptr<hash> _nodefn;
+
+	/** The sequence number of the first leaf in _leaves. */
+	uint64_t _base;
+
+	/** The leaf hashes awaiting signature, indexed by sequence number
+	 * relative to _base. Leaves may be offered out of order, so any
+	 * which have yet to arrive are represented by an empty string. */
+	std::deque<std::basic_string<unsigned char>> _leaves;
+
+	/** The number of leaves at the start of _leaves which are
+	 * contiguous, and therefore ready to be signed. */
+	size_t _ready;
+
+	/** The Merkle tree for the batch being signed. */
+	std::unique_ptr<merkle_tree> _tree;
+
+	/** Statistics for this event signer. */
+	stats_group _stats;
+
+	/** A histogram for recording the time taken to generate each
+	 * signature in the signing thread, in nanoseconds. */
+	stats_histogram& _sign_ns;
+
+	/** Sign a hash chain until the process is terminating. */
+	void _sign_chain();
+
+	/** Sign batches of Merkle tree leaves until the process is
+	 * terminating. */
+	void _sign_batches();
+
+	/** Move leaves which are ready to be signed into the Merkle tree.
+	 * The mutex must be held by the caller.
+	 * @return the sequence number of the first leaf moved
+	 */
+	uint64_t _take_batch();
+
+	/** Make a signature record for the current Merkle tree.
+	 * The tree is left empty.
+	 * @param first the sequence number of the first leaf
+	 * @return the signature record
+	 */
+	std::unique_ptr<record> _make_batch_signature(uint64_t first);
+
 	/** The function to be executed by the signing thread. */
 	void _run();
 
@@ -65,8 +130,21 @@ public:
 	 * @param nsw the new session writer for which signatures are required
 	 * @param kp the keypair with which to sign each event record
 	 * @param delay the day in milliseconds before signing.
+	 * @param hashfn the hash function applied to each event record,
+	 *  required if batch is non-zero
+	 * @param batch the maximum number of events per Merkle tree,
+	 *  or 0 to sign a hash chain
+	 */
+	event_signer(new_session_writer& nsw, keypair& kp, long delay,
+		const hash* hashfn = 0, size_t batch = 0);
+
+	/** Get the maximum number of events per Merkle tree.
+	 * @return the maximum number of events, or 0 if event records
+	 *  are chained
 	 */
-	event_signer(new_session_writer& nsw, keypair& kp, long delay);
+	size_t batch() const {
+		return _batch;
+	}
 
 	/** Add any required attributes to the session record.
 	 * @param sb a builder for the session record
@@ -89,6 +167,24 @@ public:
 	void handle_event(uint64_t seqnum,
 		const std::basic_string<unsigned char>& hash);
 
+	/** Handle leaf.
+	 * This offers the hash of an event record for inclusion in a Merkle
+	 * tree. Leaves may be offered out of order, but every sequence
+	 * number must eventually be offered exactly once. A leaf which
+	 * precedes those already signed is rejected with an exception.
+	 * @param seqnum the sequence number
+	 * @param leaf the leaf hash of the event record
+	 */
+	void handle_leaf(uint64_t seqnum,
+		std::basic_string<unsigned char>&& leaf);
+
+	/** Make signature records for any leaves not yet signed.
+	 * This is intended for use at the end of a session, once the
+	 * signing thread has been stopped.
+	 * @return the signature records
+	 */
+	std::vector<std::unique_ptr<record>> make_batch_signatures();
+
 	/** Stop signing events. */
 	void stop();
 };
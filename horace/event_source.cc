@@ -12,6 +12,7 @@
 #include "horace/logger.h"
 #include "horace/log_message.h"
 #include "horace/record.h"
+#include "horace/stats_timer.h"
 #include "horace/event_source.h"
 #include "horace/endpoint.h"
 #include "horace/event_reader_endpoint.h"
@@ -28,6 +29,8 @@ void event_source::_capture() {
 
 			// Read record from source, write to destination.
 			const record& rec = _er->read();
+			_events.add();
+			stats_timer timer(_write_ns);
 			_nsw->write_event(rec);
 		}
 	} catch (terminate_exception&) {
@@ -44,7 +47,10 @@ void event_source::_do_capture(event_source& es) {
 event_source::event_source(endpoint& ep, new_session_writer& nsw,
 	session_builder& sb):
 	_ep(dynamic_cast<event_reader_endpoint*>(&ep)),
-	_nsw(&nsw) {
+	_nsw(&nsw),
+	_stats("source." + std::string(ep.name())),
+	_events(_stats.counter("events")),
+	_write_ns(_stats.histogram("write_ns")) {
 
 	_er = _ep->make_event_reader(sb);
 }
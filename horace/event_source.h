@@ -9,6 +9,7 @@
 #include <thread>
 
 #include "horace/event_reader.h"
+#include "horace/stats_group.h"
 
 namespace horace {
 
@@ -30,6 +31,16 @@ private:
 	/** A new_session_writer for receiving the events. */
 	new_session_writer* _nsw;
 
+	/** Statistics for this event source. */
+	stats_group _stats;
+
+	/** A counter for recording events captured. */
+	stats_counter& _events;
+
+	/** A histogram for recording the time taken to hand each event
+	 * to the new_session_writer, in nanoseconds. */
+	stats_histogram& _write_ns;
+
 	/** A thread for capturing events. */
 	std::thread _thread;
 
@@ -92,6 +92,7 @@ void file_descriptor::write(const void* buf, size_t nbyte) {
 		if (count == -1) {
 			if ((errno == EWOULDBLOCK) || (errno == EAGAIN)) {
 				wait(POLLOUT);
+				continue;
 			} else {
 				throw libc_error();
 			}
@@ -101,6 +102,48 @@ void file_descriptor::write(const void* buf, size_t nbyte) {
 	}
 }
 
+size_t file_descriptor::readv(const struct iovec* iov, int iovcnt) {
+	ssize_t count = -1;
+	while (count < 0) {
+		count = ::readv(_fd, iov, iovcnt);
+		if (count == -1) {
+			if ((errno == EWOULDBLOCK) || (errno == EAGAIN)) {
+				wait(POLLIN);
+			} else {
+				throw libc_error();
+			}
+		}
+	}
+	return count;
+}
+
+void file_descriptor::writev(struct iovec* iov, int iovcnt) {
+	while (iovcnt > 0) {
+		ssize_t count = ::writev(_fd, iov, iovcnt);
+		if (count == -1) {
+			if ((errno == EWOULDBLOCK) || (errno == EAGAIN)) {
+				wait(POLLOUT);
+				continue;
+			} else {
+				throw libc_error();
+			}
+		}
+
+		// Skip over any buffers which have been written in full,
+		// then adjust the first remaining buffer to account for
+		// any partial write.
+		while ((iovcnt > 0) && (size_t(count) >= iov->iov_len)) {
+			count -= iov->iov_len;
+			++iov;
+			--iovcnt;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = static_cast<char*>(iov->iov_base) + count;
+			iov->iov_len -= count;
+		}
+	}
+}
+
 void file_descriptor::fsync() const {
 	if (::fsync(_fd) == -1) {
 		throw libc_error();
@@ -10,6 +10,8 @@
 #include <string>
 #include <utility>
 
+#include <sys/uio.h>
+
 namespace horace {
 
 /** A class to represent a file descriptor.
@@ -138,6 +140,23 @@ public:
 	 */
 	void write(const void* buf, size_t nbyte);
 
+	/** Read from file descriptor into a sequence of buffers.
+	 * This function has the same blocking behaviour as read.
+	 * @param iov the buffers to receive the result
+	 * @param iovcnt the number of buffers
+	 * @return the number of octets read
+	 */
+	size_t readv(const struct iovec* iov, int iovcnt);
+
+	/** Write a sequence of buffers to file descriptor.
+	 * This function has the same blocking behaviour as write. The
+	 * content of the iovec array is modified if the buffers cannot
+	 * be written by a single system call.
+	 * @param iov the buffers to be written
+	 * @param iovcnt the number of buffers
+	 */
+	void writev(struct iovec* iov, int iovcnt);
+
 	/** Flush file content to durable storage. */
 	void fsync() const;
 
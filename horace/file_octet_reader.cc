@@ -16,9 +16,21 @@ size_t file_octet_reader::_read_direct(void* buf, size_t nbyte) {
 	return _fd->read(buf, nbyte);
 }
 
+size_t file_octet_reader::_readv_direct(const struct iovec* iov,
+	int iovcnt) {
+
+	return _fd->readv(iov, iovcnt);
+}
+
 file_octet_reader::file_octet_reader(file_descriptor& fd, size_t bufsize):
 	buffer(bufsize),
 	octet_reader(buffer_ptr(), buffer_size(), 0),
 	_fd(&fd) {}
 
+file_octet_reader::file_octet_reader(file_descriptor& fd,
+	buffer_pool& pool):
+	buffer(pool),
+	octet_reader(buffer_ptr(), buffer_size(), 0),
+	_fd(&fd) {}
+
 } /* namespace horace */
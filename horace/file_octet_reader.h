@@ -22,6 +22,7 @@ private:
 	file_descriptor* _fd;
 protected:
 	virtual size_t _read_direct(void* buf, size_t nbyte);
+	virtual size_t _readv_direct(const struct iovec* iov, int iovcnt);
 public:
 	/** Construct file octet reader without a file descriptor. */
 	file_octet_reader() = default;
@@ -35,6 +36,12 @@ public:
 	 */
 	explicit file_octet_reader(file_descriptor& fd,
 		size_t bufsize = 0x40);
+
+	/** Construct file octet reader using a pooled buffer.
+	 * @param fd the file descriptor to be read from
+	 * @param pool the pool from which to acquire the buffer
+	 */
+	file_octet_reader(file_descriptor& fd, buffer_pool& pool);
 };
 
 } /* namespace horace */
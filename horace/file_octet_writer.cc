@@ -14,11 +14,21 @@ void file_octet_writer::_write_direct(const void* buf, size_t nbyte) {
 	_fd->write(buf, nbyte);
 }
 
+void file_octet_writer::_writev_direct(struct iovec* iov, int iovcnt) {
+	_fd->writev(iov, iovcnt);
+}
+
 file_octet_writer::file_octet_writer(file_descriptor& fd, size_t bufsize):
 	buffer(bufsize),
 	octet_writer(buffer_ptr(), buffer_size()),
 	_fd(&fd) {}
 
+file_octet_writer::file_octet_writer(file_descriptor& fd,
+	buffer_pool& pool):
+	buffer(pool),
+	octet_writer(buffer_ptr(), buffer_size()),
+	_fd(&fd) {}
+
 file_octet_writer::~file_octet_writer() {
 	try {
 		flush();
@@ -22,6 +22,7 @@ private:
 	file_descriptor* _fd;
 protected:
 	virtual void _write_direct(const void* buf, size_t nbyte);
+	virtual void _writev_direct(struct iovec* iov, int iovcnt);
 public:
 	/** Construct file octet writer without a file descriptor. */
 	file_octet_writer() = default;
@@ -36,6 +37,12 @@ public:
 	explicit file_octet_writer(file_descriptor& fd,
 		size_t bufsize = 0x40);
 
+	/** Construct file octet writer using a pooled buffer.
+	 * @param fd the file descriptor to be written to
+	 * @param pool the pool from which to acquire the buffer
+	 */
+	file_octet_writer(file_descriptor& fd, buffer_pool& pool);
+
 	file_octet_writer(const file_octet_writer& that) = delete;
 	file_octet_writer& operator=(const file_octet_writer& that) = delete;
 
@@ -0,0 +1,31 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/log_limiter.h"
+
+namespace horace {
+
+log_limiter::log_limiter(long interval):
+	_interval(std::chrono::milliseconds(interval)),
+	_next(std::chrono::steady_clock::now()),
+	_suppressed(0) {}
+
+bool log_limiter::permit() {
+	auto now = std::chrono::steady_clock::now();
+	if (now < _next) {
+		_suppressed += 1;
+		return false;
+	}
+	_next = now + _interval;
+	return true;
+}
+
+uint64_t log_limiter::suppressed() {
+	uint64_t count = _suppressed;
+	_suppressed = 0;
+	return count;
+}
+
+} /* namespace horace */
@@ -0,0 +1,57 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_LOG_LIMITER
+#define LIBHOLMES_HORACE_LOG_LIMITER
+
+#include <cstdint>
+#include <chrono>
+
+namespace horace {
+
+/** A class for limiting the rate at which a recurring message is logged.
+ * This is intended for messages which could otherwise be generated once
+ * per event, such as sequence number discontinuities. Messages which are
+ * not permitted are counted, so that the number suppressed can be
+ * reported alongside the next one which is.
+ *
+ * Instances of this class are not thread-safe, and should normally be
+ * local to the thread which makes use of them.
+ */
+class log_limiter {
+private:
+	/** The minimum interval between permitted messages. */
+	std::chrono::steady_clock::duration _interval;
+
+	/** The earliest time at which the next message is permitted. */
+	std::chrono::steady_clock::time_point _next;
+
+	/** The number of messages suppressed since the last one
+	 * permitted. */
+	uint64_t _suppressed;
+public:
+	/** Construct log limiter.
+	 * @param interval the minimum interval between permitted messages,
+	 *  in milliseconds
+	 */
+	explicit log_limiter(long interval = 1000);
+
+	/** Determine whether a message may be logged now.
+	 * If not, the message is counted as having been suppressed.
+	 * @return true if permitted, otherwise false
+	 */
+	bool permit();
+
+	/** Get the number of messages suppressed.
+	 * The count is reset to zero.
+	 * @return the number of messages suppressed since the last one
+	 *  permitted
+	 */
+	uint64_t suppressed();
+};
+
+} /* namespace horace */
+
+#endif
@@ -19,7 +19,8 @@ log_record_builder::log_record_builder(session_builder& session, int channel):
 	_procid_attr(session.define_attribute("syslog_procid", type_string), ""),
 	_msgid_attr(session.define_attribute("syslog_msgid", type_string), ""),
 	_sd_attr(session.define_attribute("syslog_sd", type_string), ""),
-	_message_attr(session.define_attribute("message", type_string), "") {}
+	_message_attr(session.define_attribute("message", type_string), ""),
+	_rpt_attr(session.define_attribute("repeat", type_unsigned_integer), 0) {}
 
 void log_record_builder::add_priority(unsigned int priority) {
 	_attrs.insert(_priority_attr = unsigned_integer_attribute(_priority_attr.attrid(), priority));
@@ -29,37 +30,45 @@ void log_record_builder::add_version(unsigned int version) {
 	_attrs.insert(_version_attr = unsigned_integer_attribute(_version_attr.attrid(), version));
 }
 
-void log_record_builder::add_timestamp(const std::string& timestamp) {
-	_attrs.insert(_timestamp_attr = string_attribute(_timestamp_attr.attrid(), timestamp));
+void log_record_builder::add_timestamp(std::string_view timestamp) {
+	_attrs.insert(_timestamp_attr = string_ref_attribute(_timestamp_attr.attrid(), timestamp));
 }
 
-void log_record_builder::add_hostname(const std::string& hostname) {
-	_attrs.insert(_hostname_attr = string_attribute(_hostname_attr.attrid(), hostname));
+void log_record_builder::add_hostname(std::string_view hostname) {
+	_attrs.insert(_hostname_attr = string_ref_attribute(_hostname_attr.attrid(), hostname));
 }
 
-void log_record_builder::add_appname(const std::string& appname) {
-	_attrs.insert(_appname_attr = string_attribute(_appname_attr.attrid(), appname));
+void log_record_builder::add_appname(std::string_view appname) {
+	_attrs.insert(_appname_attr = string_ref_attribute(_appname_attr.attrid(), appname));
 }
 
-void log_record_builder::add_procid(const std::string& procid) {
-	_attrs.insert(_procid_attr = string_attribute(_procid_attr.attrid(), procid));
+void log_record_builder::add_procid(std::string_view procid) {
+	_attrs.insert(_procid_attr = string_ref_attribute(_procid_attr.attrid(), procid));
 }
 
-void log_record_builder::add_msgid(const std::string& msgid) {
-	_attrs.insert(_msgid_attr = string_attribute(_msgid_attr.attrid(), msgid));
+void log_record_builder::add_msgid(std::string_view msgid) {
+	_attrs.insert(_msgid_attr = string_ref_attribute(_msgid_attr.attrid(), msgid));
 }
 
-void log_record_builder::add_structured_data(const std::string& sd) {
-	_attrs.insert(_sd_attr = string_attribute(_sd_attr.attrid(), sd));
+void log_record_builder::add_structured_data(std::string_view sd) {
+	_attrs.insert(_sd_attr = string_ref_attribute(_sd_attr.attrid(), sd));
 }
 
-void log_record_builder::add_message(const std::string& message) {
-	_attrs.insert(_message_attr = string_attribute(_message_attr.attrid(), message));
+void log_record_builder::add_message(std::string_view message) {
+	_attrs.insert(_message_attr = string_ref_attribute(_message_attr.attrid(), message));
 }
 
 const record& log_record_builder::build() {
 	_attrs.insert(_ts_attr = timestamp_attribute(_ts_attr.attrid()));
-	_built = record(_channel, std::move(_attrs));
+	_built.assign(_channel, std::move(_attrs));
+	return _built;
+}
+
+const record& log_record_builder::build_dropped(unsigned int dropped) {
+	attribute_list attrs;
+	attrs.insert(_ts_attr = timestamp_attribute(_ts_attr.attrid()));
+	attrs.insert(_rpt_attr = unsigned_integer_attribute(_rpt_attr.attrid(), dropped));
+	_built = record(_channel, std::move(attrs));
 	return _built;
 }
 
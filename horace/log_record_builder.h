@@ -8,7 +8,7 @@
 
 #include "horace/attribute_list.h"
 #include "horace/unsigned_integer_attribute.h"
-#include "horace/string_attribute.h"
+#include "horace/string_ref_attribute.h"
 #include "horace/timestamp_attribute.h"
 #include "horace/record.h"
 
@@ -18,6 +18,12 @@ class session_builder;
 
 /** A class for building HORACE log records.
  * A maximum of one attribute of each type may be added to each record.
+ *
+ * String attributes refer to the content passed to this builder without
+ * copying it, so that content must remain valid for as long as the
+ * resulting record. The storage used to build each record is reused for
+ * the next, so once the builder has warmed up, building a record does not
+ * require any dynamic memory allocation.
  */
 class log_record_builder {
 private:
@@ -34,25 +40,28 @@ private:
 	unsigned_integer_attribute _version_attr;
 
 	/** The syslog timestamp attribute. */
-	string_attribute _timestamp_attr;
+	string_ref_attribute _timestamp_attr;
 
 	/** The syslog hostname attribute. */
-	string_attribute _hostname_attr;
+	string_ref_attribute _hostname_attr;
 
 	/** The syslog appname attribute. */
-	string_attribute _appname_attr;
+	string_ref_attribute _appname_attr;
 
 	/** The syslog procid attribute. */
-	string_attribute _procid_attr;
+	string_ref_attribute _procid_attr;
 
 	/** The syslog msgid attribute. */
-	string_attribute _msgid_attr;
+	string_ref_attribute _msgid_attr;
 
 	/** The syslog structured data attribute. */
-	string_attribute _sd_attr;
+	string_ref_attribute _sd_attr;
 
 	/** The message attribute. */
-	string_attribute _message_attr;
+	string_ref_attribute _message_attr;
+
+	/** The repeat attribute, for reporting dropped messages. */
+	unsigned_integer_attribute _rpt_attr;
 
 	/** The attribute list under construction. */
 	attribute_list _attrs;
@@ -79,41 +88,49 @@ public:
 	/** Add syslog timestamp.
 	 * @param timestamp the timestamp to be added
 	 */
-	void add_timestamp(const std::string& timestamp);
+	void add_timestamp(std::string_view timestamp);
 
 	/** Add syslog hostname.
 	 * @param hostname the hostname to be added
 	 */
-	void add_hostname(const std::string& hostname);
+	void add_hostname(std::string_view hostname);
 
 	/** Add syslog appname.
 	 * @param appname the appname to be added
 	 */
-	void add_appname(const std::string& appname);
+	void add_appname(std::string_view appname);
 
 	/** Add syslog procid.
 	 * @param procid the procid to be added
 	 */
-	void add_procid(const std::string& procid);
+	void add_procid(std::string_view procid);
 
 	/** Add syslog msgid.
 	 * @param msgid the msgid to be added
 	 */
-	void add_msgid(const std::string& msgid);
+	void add_msgid(std::string_view msgid);
 
 	/** Add syslog structured data.
 	 * @param sd the structured data to be added
 	 */
-	void add_structured_data(const std::string& sd);
+	void add_structured_data(std::string_view sd);
 
 	/** Add message.
 	 * @param message the message to be added
 	 */
-	void add_message(const std::string& message);
+	void add_message(std::string_view message);
 
 	/** Build log record.
 	 */
 	const record& build();
+
+	/** Build record for dropped messages.
+	 * This is in the same format as used for dropped packets, with a
+	 * timestamp and a repeat count but no other content. Any attributes
+	 * added since the last record was built are retained for the next.
+	 * @param dropped the number of messages dropped
+	 */
+	const record& build_dropped(unsigned int dropped);
 };
 
 } /* namespace horace */
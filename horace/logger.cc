@@ -10,9 +10,13 @@ namespace horace {
 logger::logger():
 	_severity(log_warning) {}
 
-logger& logger::operator<<(const std::string& msg) {
+void logger::submit(const std::string& msg) {
 	std::lock_guard<std::mutex> lock(_log_mutex);
 	write(msg);
+}
+
+logger& logger::operator<<(const std::string& msg) {
+	submit(msg);
 	return *this;
 }
 
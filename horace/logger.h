@@ -46,6 +46,15 @@ protected:
 	 * @param msg the message to be written
 	 */
 	virtual void write(const std::string& msg) = 0;
+
+	/** Submit a message for writing to the log.
+	 * The default behaviour is to lock the mutex, then call write.
+	 * Subclasses may override this in order to avoid locking, in which
+	 * case they must provide their own means of ensuring thread safety.
+	 * Either way, this function must not throw any exceptions.
+	 * @param msg the message to be written
+	 */
+	virtual void submit(const std::string& msg);
 public:
 	/** Construct logger. */
 	logger();
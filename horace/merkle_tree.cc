@@ -0,0 +1,42 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/hash.h"
+#include "horace/merkle_tree.h"
+
+namespace horace {
+
+merkle_tree::merkle_tree(hash& hashfn):
+	_hashfn(&hashfn) {}
+
+std::basic_string<unsigned char> merkle_tree::root() {
+	// Combine adjacent pairs of nodes, level by level, promoting any
+	// unpaired node to the next level unchanged. This produces the
+	// same root as the recursive definition in RFC 6962.
+	size_t count = _leaves.size();
+	while (count > 1) {
+		size_t next = 0;
+		for (size_t i = 0; i + 1 < count; i += 2) {
+			_hashfn->write(static_cast<char>(node_prefix));
+			_hashfn->write(_leaves[i].data(), _leaves[i].length());
+			_hashfn->write(_leaves[i + 1].data(),
+				_leaves[i + 1].length());
+			const unsigned char* node =
+				static_cast<const unsigned char*>(_hashfn->final());
+			_leaves[next++].assign(node, _hashfn->length());
+		}
+		if (count % 2) {
+			_leaves[next++].swap(_leaves[count - 1]);
+		}
+		count = next;
+	}
+
+	std::basic_string<unsigned char> result;
+	result.swap(_leaves[0]);
+	_leaves.clear();
+	return result;
+}
+
+} /* namespace horace */
@@ -0,0 +1,69 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_MERKLE_TREE
+#define LIBHOLMES_HORACE_MERKLE_TREE
+
+#include <string>
+#include <vector>
+
+namespace horace {
+
+class hash;
+
+/** A class for calculating the root hash of a Merkle tree.
+ * The tree has the same shape as the one specified by RFC 6962: for
+ * n leaves, the left subtree holds the largest power of two which is
+ * less than n, and the right subtree holds the remainder. Leaf and
+ * interior node hashes are distinguished by a prefix octet of 0x00 or
+ * 0x01 respectively, so that one cannot be passed off as the other.
+ *
+ * Leaf hashes are supplied by the caller, having been calculated using
+ * leaf_prefix, because that allows them to be calculated concurrently
+ * by the threads which capture the events concerned.
+ */
+class merkle_tree {
+public:
+	/** The prefix octet for leaf hashes. */
+	static const unsigned char leaf_prefix = 0x00;
+
+	/** The prefix octet for interior node hashes. */
+	static const unsigned char node_prefix = 0x01;
+private:
+	/** The hash function for interior nodes. */
+	hash* _hashfn;
+
+	/** The leaf hashes. */
+	std::vector<std::basic_string<unsigned char>> _leaves;
+public:
+	/** Construct empty Merkle tree.
+	 * @param hashfn the hash function for interior nodes
+	 */
+	explicit merkle_tree(hash& hashfn);
+
+	/** Get the number of leaves.
+	 * @return the number of leaves
+	 */
+	size_t size() const {
+		return _leaves.size();
+	}
+
+	/** Add a leaf to the tree.
+	 * @param leaf the leaf hash
+	 */
+	void add(std::basic_string<unsigned char>&& leaf) {
+		_leaves.push_back(std::move(leaf));
+	}
+
+	/** Calculate the root hash, then remove all leaves.
+	 * There must be at least one leaf.
+	 * @return the root hash
+	 */
+	std::basic_string<unsigned char> root();
+};
+
+} /* namespace horace */
+
+#endif
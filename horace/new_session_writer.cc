@@ -3,18 +3,19 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
-#include <signal.h>
-#include <unistd.h>
+#include <chrono>
 
 #include "horace/libc_error.h"
 #include "horace/horace_error.h"
 #include "horace/terminate_exception.h"
+#include "horace/terminate_flag.h"
 #include "horace/logger.h"
 #include "horace/log_message.h"
 #include "horace/hash.h"
 #include "horace/keypair.h"
 #include "horace/compound_attribute.h"
 #include "horace/binary_attribute.h"
+#include "horace/binary_ref_attribute.h"
 #include "horace/unsigned_integer_attribute.h"
 #include "horace/string_attribute.h"
 #include "horace/timestamp_attribute.h"
@@ -25,19 +26,43 @@
 #include "horace/endpoint.h"
 #include "horace/session_writer_endpoint.h"
 #include "horace/session_writer.h"
+#include "horace/stats_timer.h"
+#include "horace/merkle_tree.h"
 #include "horace/event_signer.h"
 #include "horace/new_session_writer.h"
 
 namespace horace {
 
+namespace {
+
+/** The time to wait between attempts to write a record when the
+ * backlog is full. */
+const int stall_interval = 100;
+
+/** The minimum time between attempts to remake the session writer
+ * following an error. */
+const auto retry_interval = std::chrono::seconds(1);
+
+} /* anonymous namespace */
+
 new_session_writer::new_session_writer(endpoint& ep, session_builder& sb,
-	const std::string& srcid, hash* hashfn):
+	const std::string& srcid, hash* hashfn, size_t backlog,
+	const std::string& spilldir):
+	_inflight(0),
 	_ep(dynamic_cast<session_writer_endpoint*>(&ep)),
 	_srcid(srcid),
 	_srec(0),
 	_seqnum(0),
 	_hashfn(hashfn),
-	_signer(0) {
+	_signer(0),
+	_stats("capture"),
+	_events(_stats.counter("events")),
+	_signatures(_stats.counter("signatures")),
+	_retries(_stats.counter("retries")),
+	_write_ns(_stats.histogram("write_ns")),
+	_hash_ns(_stats.histogram("hash_ns")),
+	_stalls(_stats.counter("stalls")),
+	_backlog(_stats, backlog, spilldir) {
 
 	if (hashfn) {
 		sb.define_hash(*hashfn);
@@ -50,32 +75,127 @@ new_session_writer::new_session_writer(endpoint& ep, session_builder& sb,
 	_sw = _ep->make_session_writer(_srcid);
 }
 
-void new_session_writer::_write(const record& rec) {
-	bool retry = true;
-	while (retry) {
-		retry = false;
+void new_session_writer::_fail(std::exception& ex) {
+	_sw = 0;
+	_retry_time = std::chrono::steady_clock::now() + retry_interval;
+	_retries.add();
+	if (log->enabled(logger::log_err)) {
+		log_message msg1(*log, logger::log_err);
+		msg1 << ex.what();
+		log_message msg2(*log, logger::log_err);
+		msg2 << "error during capture (will retry)";
+	}
+}
+
+bool new_session_writer::_ready(bool force) {
+	try {
+		if (!_sw) {
+			if (std::chrono::steady_clock::now() < _retry_time) {
+				return false;
+			}
+
+			// The session continues where it left off, so the
+			// replacement session writer needs the same session
+			// record, but not the records which preceded it.
+			_sw = _ep->make_session_writer(_srcid);
+			if (_srec) {
+				_sw->write(*_srec);
+			}
+		}
+		return force || _sw->writable();
+	} catch (terminate_exception&) {
+		throw;
+	} catch (std::exception& ex) {
+		_fail(ex);
+	}
+	return false;
+}
 
+void new_session_writer::_drain(bool force) {
+	while (!_backlog.empty() && _ready(force)) {
 		try {
-			_sw->write(rec);
+			stats_timer timer(_write_ns);
+			_sw->write(_backlog.front());
 		} catch (terminate_exception&) {
 			throw;
 		} catch (std::exception& ex) {
-			_sw = 0;
-			retry = true;
-			if (log->enabled(logger::log_err)) {
-				log_message msg1(*log, logger::log_err);
-				msg1 << ex.what();
-				log_message msg2(*log, logger::log_err);
-				msg2 << "error during capture (will retry)";
-			}
+			_fail(ex);
+			return;
 		}
+		_backlog.pop();
+	}
+}
 
-		// Data capture should be suspended if the session writer
-		// is not able to accept it, however there is no mechanism
-		// for this yet so current behaviour is to terminate.
-		if (!_sw->writable()) {
-			kill(getpid(), SIGALRM);
-		}
+bool new_session_writer::_try_write(const record& rec, bool force) {
+	_drain(force);
+	if (!_backlog.empty() || !_ready(force)) {
+		return false;
+	}
+
+	try {
+		stats_timer timer(_write_ns);
+		_sw->write(rec);
+		return true;
+	} catch (terminate_exception&) {
+		throw;
+	} catch (std::exception& ex) {
+		_fail(ex);
+	}
+	return false;
+}
+
+void new_session_writer::_write(const record& rec) {
+	if (_try_write(rec) || _backlog.push(rec)) {
+		return;
+	}
+
+	// Neither the endpoint nor the backlog can accept the record,
+	// so stall until one of them can. Records are not discarded,
+	// but event sources will stop reading from their underlying
+	// buffers for the duration.
+	_stalls.add();
+	if (log->enabled(logger::log_warning)) {
+		log_message msg(*log, logger::log_warning);
+		msg << "backlog full (" << _backlog.count() <<
+			" records), suspending capture";
+	}
+	do {
+		terminating.millisleep(stall_interval);
+	} while (!_try_write(rec) && !_backlog.push(rec));
+	if (log->enabled(logger::log_notice)) {
+		log_message msg(*log, logger::log_notice);
+		msg << "resuming capture";
+	}
+}
+
+void new_session_writer::_end(const record& rec) {
+	// The process may be terminating, so this must not stall.
+	if (!_try_write(rec, true)) {
+		_backlog.push(rec);
+	}
+}
+
+std::basic_string<unsigned char> new_session_writer::_leaf_hash(
+	const std::string& algorithm,
+	const std::basic_string<unsigned char>& session_hash,
+	const std::string& encoding) {
+
+	thread_local std::unique_ptr<hash> hashfn;
+	if (!hashfn || (hashfn->algorithm() != algorithm)) {
+		hashfn = hash::make(algorithm);
+	}
+
+	hashfn->write(static_cast<char>(merkle_tree::leaf_prefix));
+	hashfn->write(session_hash.data(), session_hash.length());
+	hashfn->write(encoding.data(), encoding.length());
+	const unsigned char* leaf =
+		static_cast<const unsigned char*>(hashfn->final());
+	return std::basic_string<unsigned char>(leaf, hashfn->length());
+}
+
+void new_session_writer::_end_leaf() {
+	if (--_inflight == 0) {
+		_idle.notify_all();
 	}
 }
 
@@ -103,7 +223,16 @@ void new_session_writer::begin_session(const record& srec) {
 	std::lock_guard<std::mutex> lk(_mutex);
 
 	_srec = &srec;
-	_sw->write(*_srec);
+	_backlog.begin_session(*_srec);
+	try {
+		_sw->write(*_srec);
+	} catch (terminate_exception&) {
+		throw;
+	} catch (std::exception& ex) {
+		// The session record will be resent when the session
+		// writer is remade.
+		_fail(ex);
+	}
 	_srec->log(*log);
 
 	if (_hashfn) {
@@ -117,83 +246,156 @@ void new_session_writer::begin_session(const record& srec) {
 		if (_signer) {
 			auto sigrec = _signer->make_signature(0,
 				_session_hash);
-			_sw->write(*sigrec);
+			_write(*sigrec);
 		}
 	}
 }
 
 void new_session_writer::write_event(const record& rec) {
-	std::lock_guard<std::mutex> lk(_mutex);
+	std::unique_lock<std::mutex> lk(_mutex);
 
-	// Append sequence number to record.
-	// This is the same method as was previously used in
-	// spoolfile_writer, and is known to be inefficient.
-	// It was tolerable in that context because it was
-	// invoked only once per spoolfile. Here it is
-	// applied to every event record, and effectively
-	// undoes efforts made elsewhere to avoid copying.
-	// A more efficient solution would be desirable, but
-	// the current event reader API does not allow for one.
-	attribute_list attrs = rec.attributes();
+	// Append sequence number and hash attributes to the record.
+	// The original attributes are referred to rather than copied,
+	// since they remain valid until this function returns. The
+	// result is encoded once, and that encoding is then used both
+	// for writing to the endpoint and for hashing.
+	for (const attribute* attr : rec.attributes()) {
+		_attrs.insert(*attr);
+	}
 	unsigned_integer_attribute seqnum_attr(attrid_seqnum, _seqnum);
-	attrs.insert(seqnum_attr);
-	if (_hattr) {
-		attrs.insert(std::move(_hattr));
+	_attrs.insert(seqnum_attr);
+	binary_ref_attribute hash_attr(attrid_hash, _prev_hash.length(),
+		_prev_hash.data());
+	if (!_prev_hash.empty()) {
+		_attrs.insert(hash_attr);
 	}
-	record nrec(rec.channel_id(), std::move(attrs));
+	_nrec.assign(rec.channel_id(), std::move(_attrs));
+	uint64_t seqnum = _seqnum++;
+
+	// Write the record (with backlog). Nothing after this needs the
+	// attributes, only the encoding, so they are released before the
+	// storage to which they refer goes out of scope.
+	_write(_nrec);
+	_events.add();
+	_nrec.release_attributes(std::move(_attrs));
+
+	// If signing in batches then the leaf hash for this record does
+	// not depend on any other, so it can be calculated after the
+	// mutex has been released. This allows records captured by
+	// different event sources to be hashed concurrently. Everything
+	// needed is copied while the mutex is held, and the leaf is
+	// counted as in flight so that the session is not ended before
+	// it has been handled. The histogram is updated only once the
+	// mutex has been reacquired, since it is not thread-safe.
+	if (_signer && _signer->batch()) {
+		thread_local std::string encoding;
+		thread_local std::string algorithm;
+		thread_local std::basic_string<unsigned char> session_hash;
+		encoding = _nrec.encoding();
+		algorithm = _hashfn->algorithm();
+		session_hash = _session_hash;
+		_inflight += 1;
+		lk.unlock();
 
-	// Write the record (with retry).
-	_write(nrec);
+		auto start = std::chrono::steady_clock::now();
+		try {
+			_signer->handle_leaf(seqnum,
+				_leaf_hash(algorithm, session_hash, encoding));
+		} catch (...) {
+			lk.lock();
+			_end_leaf();
+			throw;
+		}
+		auto elapsed = std::chrono::steady_clock::now() - start;
 
-	// Hash and sign the record if appropriate.
+		lk.lock();
+		_hash_ns.add(std::chrono::duration_cast<
+			std::chrono::nanoseconds>(elapsed).count());
+		_end_leaf();
+		return;
+	}
+
+	// Hash and sign the record if appropriate. This must be done
+	// while holding the mutex, since the hash is needed by the
+	// next event record.
 	if (_hashfn) {
+		stats_timer timer(_hash_ns);
 		_hashfn->write(_session_hash.data(), _session_hash.length());
-		nrec.write(*_hashfn);
-		const void* hash = _hashfn->final();
-		size_t hash_len = _hashfn->length();
-
-		_hattr = std::make_unique<binary_attribute>(attrid_hash,
-			hash_len, hash);
+		_nrec.write(*_hashfn);
+		_prev_hash.assign(
+			static_cast<const unsigned char*>(_hashfn->final()),
+			_hashfn->length());
 
 		if (_signer) {
-			std::basic_string<unsigned char> hash_str(
-				static_cast<const unsigned char*>(hash),
-				hash_len);
-			_signer->handle_event(_seqnum, hash_str);
+			_signer->handle_event(seqnum, _prev_hash);
 		}
 	}
-
-	// Increment the sequence number.
-	// (This must not be done earlier, since its value is
-	// needed for signing.)
-	_seqnum++;
 }
 
 void new_session_writer::write_signature(const record& sigrec) {
 	std::lock_guard<std::mutex> lk(_mutex);
 
-	// Write the signature record (with retry).
+	// Write the signature record (with backlog).
 	_write(sigrec);
+	_signatures.add();
 }
 
-void new_session_writer::end_session() {
-	std::lock_guard<std::mutex> lk(_mutex);
+void new_session_writer::flush() {
+	// If another thread holds the lock then it may be stalled, in
+	// which case there is no purpose in waiting for it.
+	std::unique_lock<std::mutex> lk(_mutex, std::try_to_lock);
+	if (!lk) {
+		return;
+	}
+
+	_drain();
 	if (_sw) {
+		try {
+			_sw->flush();
+		} catch (terminate_exception&) {
+			throw;
+		} catch (std::exception& ex) {
+			// Any underlying problem with the endpoint will
+			// recur when the next record is written, and be
+			// handled then.
+			if (log->enabled(logger::log_err)) {
+				log_message msg(*log, logger::log_err);
+				msg << ex.what();
+			}
+		}
+	}
+}
+
+void new_session_writer::end_session() {
+	std::unique_lock<std::mutex> lk(_mutex);
+
+	// Leaf hashes which are still in flight must be handled by the
+	// signer before the final batch signatures are made.
+	_idle.wait(lk, [this]{ return _inflight == 0; });
+	if (_srec) {
 		attribute_list attrs;
 		attrs.insert(std::make_unique<timestamp_attribute>(attrid_ts));
 		attrs.insert(std::make_unique<unsigned_integer_attribute>(attrid_seqnum, _seqnum));
-		if (_hattr) {
-			attrs.insert(std::move(_hattr));
+		if (!_prev_hash.empty()) {
+			attrs.insert(std::make_unique<binary_attribute>(
+				attrid_hash, _prev_hash.length(), _prev_hash.data()));
+			_prev_hash.clear();
 		}
-		std::unique_ptr<record> erec = std::make_unique<record>(
-			channel_end, std::move(attrs));
-		_sw->write(*erec);
-		erec->log(*log);
+		encoded_record erec;
+		erec.assign(channel_end, std::move(attrs));
+		_end(erec);
+		erec.log(*log);
 
 		// Hash and sign the record if appropriate.
-		if (_hashfn) {
+		if (_signer && _signer->batch()) {
+			_signer->handle_leaf(_seqnum, _leaf_hash(
+				_hashfn->algorithm(), _session_hash, erec.encoding()));
+			for (auto& sigrec : _signer->make_batch_signatures()) {
+				_end(*sigrec);
+			}
+		} else if (_hashfn) {
 			_hashfn->write(_session_hash.data(), _session_hash.length());
-			erec->write(*_hashfn);
+			erec.write(*_hashfn);
 			const void* hash = _hashfn->final();
 			size_t hash_len = _hashfn->length();
 
@@ -203,11 +405,22 @@ void new_session_writer::end_session() {
 					hash_len);
 				auto sigrec = _signer->make_signature(
 					&_seqnum, hash_str);
-				_sw->write(*sigrec);
+				_end(*sigrec);
 			}
 		}
 
+		// Any records which remain in the backlog belong to this
+		// session, so they cannot be carried over into the next.
+		if (!_backlog.empty()) {
+			if (log->enabled(logger::log_err)) {
+				log_message msg(*log, logger::log_err);
+				msg << _backlog.count() << " records in backlog"
+					" could not be written";
+			}
+			_backlog.clear();
+		}
 		_sw = 0;
+		_srec = 0;
 	}
 }
 
@@ -7,13 +7,18 @@
 #define LIBHOLMES_HORACE_NEW_SESSION_WRITER
 
 #include <memory>
+#include <chrono>
 #include <cstdint>
 #include <ctime>
 #include <mutex>
+#include <condition_variable>
 
 #include "horace/source_id.h"
-#include "horace/binary_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/encoded_record.h"
 #include "horace/session_writer.h"
+#include "horace/stats_group.h"
+#include "horace/record_backlog.h"
 
 namespace horace {
 
@@ -25,12 +30,31 @@ class endpoint;
 class session_writer_endpoint;
 class event_signer;
 
-/** A class for writing newly-captured sessions to an endpoint. */
+/** A class for writing newly-captured sessions to an endpoint.
+ * If the endpoint is unable to accept records, either because it is not
+ * writable or because an error has occurred, then records are held in
+ * a bounded backlog until it recovers. If the backlog becomes full then
+ * the caller is blocked, with the effect that event sources stop reading
+ * from any underlying buffers (such as the ring buffer of a network
+ * interface) until there is space. This allows brief interruptions to
+ * be absorbed without ending the session.
+ */
 class new_session_writer {
+public:
+	/** The default backlog capacity, in octets. */
+	static const size_t default_backlog = 0x4000000;
 private:
 	/** A mutex to allow thread-safe capture from multiple sources. */
 	std::mutex _mutex;
 
+	/** A condition variable for waiting until there are no leaf
+	 * hashes in flight. */
+	std::condition_variable _idle;
+
+	/** The number of leaf hashes being calculated without holding
+	 * the mutex. */
+	unsigned int _inflight;
+
 	/** The destination endpoint, as a session_writer_endpoint. */
 	session_writer_endpoint* _ep;
 
@@ -40,18 +64,34 @@ private:
 	/** The session record, or 0 if not yet created. */
 	const record* _srec;
 
-	/** A session writer for the destination endpoint. */
+	/** A session writer for the destination endpoint,
+	 * or 0 if it must be remade. */
 	std::unique_ptr<session_writer> _sw;
 
+	/** The earliest time at which the session writer may be remade. */
+	std::chrono::steady_clock::time_point _retry_time;
+
 	/** The sequence number for the next event record. */
 	uint64_t _seqnum;
 
 	/** A hash for the most recent session record. */
 	std::basic_string<unsigned char> _session_hash;
 
-	/** A hash attribute for the most recent event record,
-	 * or 0 if none. */
-	std::unique_ptr<binary_attribute> _hattr;
+	/** The hash of the most recent event record,
+	 * or the empty string if none. */
+	std::basic_string<unsigned char> _prev_hash;
+
+	/** Storage for building the attribute list of each event record.
+	 * This is retained between records in order to avoid allocating
+	 * new storage for each one. */
+	attribute_list _attrs;
+
+	/** The most recent event record, with sequence number and hash
+	 * attributes appended. Its attributes refer to storage which is
+	 * valid only for the duration of the call to write_event, so they
+	 * are released once it has been written, however its encoding
+	 * remains valid until the next call. */
+	encoded_record _nrec;
 
 	/** The hash function to apply to each event record,
 	 * or 0 for none. */
@@ -60,10 +100,97 @@ private:
 	/** An event signer for signing event records, or 0 if none. */
 	event_signer* _signer;
 
-	/** Write any type of record to the endpoint (with retry).
+	/** Statistics for this new session writer. */
+	stats_group _stats;
+
+	/** A counter for recording event records written. */
+	stats_counter& _events;
+
+	/** A counter for recording signature records written. */
+	stats_counter& _signatures;
+
+	/** A counter for recording failed attempts to write a record. */
+	stats_counter& _retries;
+
+	/** A histogram for recording the time taken to write each record
+	 * to the session writer, in nanoseconds. */
+	stats_histogram& _write_ns;
+
+	/** A histogram for recording the time taken to hash each event
+	 * record, in nanoseconds. */
+	stats_histogram& _hash_ns;
+
+	/** A counter for recording the number of times that capture
+	 * was stalled because the backlog was full. */
+	stats_counter& _stalls;
+
+	/** Records which have not yet been written to the endpoint. */
+	record_backlog _backlog;
+
+	/** Handle an exception thrown by the session writer.
+	 * The session writer is discarded, to be remade when it is next
+	 * needed.
+	 * @param ex the exception
+	 */
+	void _fail(std::exception& ex);
+
+	/** Test whether the session writer is ready to accept records.
+	 * If there is no session writer then an attempt is made to remake
+	 * it, and to resend the session record.
+	 * @param force true to disregard whether the endpoint is writable,
+	 *  otherwise false
+	 * @return true if ready, otherwise false
+	 */
+	bool _ready(bool force = false);
+
+	/** Write as many records from the backlog as the endpoint
+	 * will accept.
+	 * @param force true to disregard whether the endpoint is writable,
+	 *  otherwise false
+	 */
+	void _drain(bool force = false);
+
+	/** Attempt to write a record without using the backlog.
+	 * This succeeds only if the backlog can be drained first.
+	 * @param rec the record to be written
+	 * @param force true to disregard whether the endpoint is writable,
+	 *  otherwise false
+	 * @return true if written, otherwise false
+	 */
+	bool _try_write(const record& rec, bool force = false);
+
+	/** Write any type of record to the endpoint or backlog.
+	 * If neither can accept the record then block until one can.
 	 * @param rec the record to be written
 	 */
 	void _write(const record& rec);
+
+	/** Calculate the Merkle tree leaf hash for a record.
+	 * This may be called concurrently by multiple threads, since
+	 * each thread uses its own instance of the hash function. It
+	 * does not refer to any member variables, so the mutex need not
+	 * be held.
+	 * @param algorithm the name of the hash algorithm
+	 * @param session_hash the hash of the session record
+	 * @param encoding the encoded record to be hashed
+	 * @return the leaf hash
+	 */
+	static std::basic_string<unsigned char> _leaf_hash(
+		const std::string& algorithm,
+		const std::basic_string<unsigned char>& session_hash,
+		const std::string& encoding);
+
+	/** Record that a leaf hash is no longer in flight.
+	 * The mutex must be held when this function is called.
+	 */
+	void _end_leaf();
+
+	/** Write a record at the end of the session.
+	 * This is similar to _write, except that it never blocks, and
+	 * it disregards whether the endpoint is writable.
+	 * @param rec the record to be written
+	 */
+	void _end(const record& rec);
 public:
 	/** Construct new session writer.
 	 * @param ep the destination endpoint
@@ -71,9 +198,15 @@ public:
 	 * @param srcid the required source ID
 	 * @param hashfn the hash function to apply to each event record,
 	 *  or 0 if none
+	 * @param backlog the maximum amount of memory to use for records
+	 *  which cannot yet be written, in octets
+	 * @param spilldir a directory in which to spill records which do
+	 *  not fit within the backlog, or the empty string if none
 	 */
 	new_session_writer(endpoint& ep, session_builder& sb,
-		const std::string& srcid, hash* hashfn);
+		const std::string& srcid, hash* hashfn,
+		size_t backlog = default_backlog,
+		const std::string& spilldir = std::string());
 
 	/** Test whether the endpoint is writable.
 	 * This function has the same behaviour as
@@ -92,17 +225,28 @@ public:
 	 */
 	void begin_session(const record& srec);
 
-	/** Write an event record to the endpoint (with retry).
+	/** Write an event record to the endpoint (with backlog).
 	 * @param rec the event record to be written
 	 */
 	void write_event(const record& rec);
 
-	/** Write an signature record to the endpoint (with retry).
+	/** Write an signature record to the endpoint (with backlog).
 	 * @param sigrec the event record to be written
 	 */
 	void write_signature(const record& sigrec);
 
-	/** End the session. */
+	/** Flush any records buffered by the endpoint or backlog.
+	 * This should be called periodically, so that records are not
+	 * held back indefinitely if the flow of events stops. It does
+	 * nothing if another thread is currently writing.
+	 */
+	void flush();
+
+	/** End the session.
+	 * Any records remaining in the backlog are written if possible,
+	 * disregarding whether the endpoint is writable, but this function
+	 * does not wait for the endpoint to recover from an error.
+	 */
 	void end_session();
 };
 
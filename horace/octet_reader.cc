@@ -35,11 +35,22 @@ void octet_reader::_read(void* buf, size_t nbyte) {
 			nbyte -= bcount;
 		} else if (nbyte * 2 >= _limit - _buffer) {
 			// If there is half a buffer-full or more remaining
-			// to be read then attempt to do so directly.
-			size_t rcount = _read_direct(bptr, nbyte);
+			// to be read then attempt to do so directly, but
+			// allow any excess to be read into the buffer.
+			struct iovec iov[2];
+			iov[0].iov_base = bptr;
+			iov[0].iov_len = nbyte;
+			iov[1].iov_base = _buffer;
+			iov[1].iov_len = _limit - _buffer;
+			size_t rcount = _readv_direct(iov, 2);
 			if (!rcount) {
 				throw eof_error();
 			}
+			if (rcount > nbyte) {
+				_ptr = _buffer;
+				_end = _buffer + (rcount - nbyte);
+				rcount = nbyte;
+			}
 			bptr += rcount;
 			nbyte -= rcount;
 		} else {
@@ -59,6 +70,10 @@ size_t octet_reader::_read_direct(void* buf, size_t nbyte) {
 	throw eof_error();
 }
 
+size_t octet_reader::_readv_direct(const struct iovec* iov, int iovcnt) {
+	return _read_direct(iov[0].iov_base, iov[0].iov_len);
+}
+
 uint64_t octet_reader::read_unsigned(size_t width) {
 	uint64_t result = 0;
 	while (width--) {
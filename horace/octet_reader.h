@@ -10,6 +10,8 @@
 #include <cstring>
 #include <string>
 
+#include <sys/uio.h>
+
 namespace horace {
 
 /** An abstract base class for reading octets from an octet stream.
@@ -76,6 +78,20 @@ protected:
 	 * @return the number of octets read
 	 */
 	virtual size_t _read_direct(void* buf, size_t nbyte);
+
+	/** Read up to a given number of octets directly from the stream
+	 * into a sequence of octet arrays.
+	 * This function is used when performing a direct read, so that
+	 * the buffer can be refilled at the same time. Arrays are filled
+	 * in order, and it is permissible to fill fewer than requested.
+	 *
+	 * If it is not overridden, the default behaviour of this function
+	 * is to call _read_direct for the first array only.
+	 * @param iov the octet arrays to be read into
+	 * @param iovcnt the number of octet arrays
+	 * @return the number of octets read
+	 */
+	virtual size_t _readv_direct(const struct iovec* iov, int iovcnt);
 public:
 	/** Construct octet reader with no buffer. */
 	octet_reader():
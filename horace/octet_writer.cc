@@ -15,23 +15,27 @@ void octet_writer::_write(const void* buf, size_t nbyte) {
 		// function is called directly.
 		memcpy(_ptr, buf, nbyte);
 		_ptr += nbyte;
-	} else {
-		// First flush the buffer if it is non-empty.
-		size_t bcount = _ptr - _buffer;
-		if (bcount) {
-			_write_direct(_buffer, bcount);
-			_ptr = _buffer;
-		}
-
-		// Now either copy the new data into the buffer, or if
-		// it would fill more than half of the buffer, write it
-		// directly.
-		if (nbyte * 2 >= _limit - _ptr) {
-			_write_direct(buf, nbyte);
+	} else if (nbyte * 2 >= _limit - _buffer) {
+		// If the new data would fill more than half of the buffer
+		// then write it directly, without copying, together with
+		// the current content of the buffer.
+		struct iovec iov[2];
+		iov[0].iov_base = _buffer;
+		iov[0].iov_len = _ptr - _buffer;
+		iov[1].iov_base = const_cast<void*>(buf);
+		iov[1].iov_len = nbyte;
+		if (iov[0].iov_len) {
+			_writev_direct(iov, 2);
 		} else {
-			memcpy(_ptr, buf, nbyte);
-			_ptr += nbyte;
+			_write_direct(buf, nbyte);
 		}
+		_ptr = _buffer;
+	} else {
+		// Otherwise flush the buffer, then copy the new data
+		// into it.
+		flush();
+		memcpy(_ptr, buf, nbyte);
+		_ptr += nbyte;
 	}
 }
 
@@ -39,6 +43,12 @@ void octet_writer::_write_direct(const void* buf, size_t nbyte) {
 	throw eof_error();
 }
 
+void octet_writer::_writev_direct(struct iovec* iov, int iovcnt) {
+	for (int i = 0; i != iovcnt; ++i) {
+		_write_direct(iov[i].iov_base, iov[i].iov_len);
+	}
+}
+
 void octet_writer::flush() {
 	size_t bcount = _ptr - _buffer;
 	if (bcount) {
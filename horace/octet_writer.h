@@ -10,6 +10,8 @@
 #include <cstring>
 #include <string>
 
+#include <sys/uio.h>
+
 namespace horace {
 
 /** An abstract base class for writing octets to an octet stream.
@@ -53,6 +55,33 @@ protected:
 	 * @param nbyte the number of octets to write
 	 */
 	virtual void _write_direct(const void* buf, size_t nbyte);
+
+	/** Write a sequence of octet arrays directly to the stream.
+	 * This function is used when flushing the buffer immediately
+	 * before a direct write, so that both can be performed together.
+	 * The content of the iovec array may be modified.
+	 *
+	 * If it is not overridden, the default behaviour of this
+	 * function is to call _write_direct for each array in turn.
+	 * @param iov the octet arrays to be written
+	 * @param iovcnt the number of octet arrays
+	 */
+	virtual void _writev_direct(struct iovec* iov, int iovcnt);
+
+	/** Replace the buffer.
+	 * This allows a subclass to retain some octets after a direct
+	 * write, by moving the buffer so that it begins after them. It
+	 * should only be called from within _write_direct or
+	 * _writev_direct, when the existing content of the buffer has
+	 * been consumed.
+	 * @param buffer the required buffer
+	 * @param size the required buffer size, in octets
+	 */
+	void _set_buffer(void* buffer, size_t size) {
+		_buffer = static_cast<char*>(buffer);
+		_limit = _buffer + size;
+		_ptr = _buffer;
+	}
 public:
 	/** Construct octet writer with no buffer. */
 	octet_writer():
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 
+#include "horace/endpoint_error.h"
 #include "horace/query_string.h"
 
 namespace horace {
@@ -78,6 +79,30 @@ std::optional<std::string> query_string::find<std::string>(const std::string& na
 	return f->second;
 }
 
+template<>
+std::optional<std::vector<std::string>> query_string::find<std::vector<std::string>>(const std::string& name) const {
+	auto f = _parameters.find(name);
+	if (f == _parameters.end()) {
+		return std::nullopt;
+	}
+
+	const std::string& value = f->second;
+	std::vector<std::string> result;
+	size_t start = 0;
+	while (start <= value.length()) {
+		size_t end = value.find(':', start);
+		if (end == std::string::npos) {
+			end = value.length();
+		}
+		if (end == start) {
+			throw endpoint_error("empty element in " + name);
+		}
+		result.push_back(value.substr(start, end - start));
+		start = end + 1;
+	}
+	return result;
+}
+
 template<>
 std::optional<long> query_string::find<long>(const std::string& name) const {
 	auto f = _parameters.find(name);
@@ -96,6 +121,15 @@ std::optional<long long> query_string::find<long long>(const std::string& name)
 	return stoll(f->second);
 }
 
+template<>
+std::optional<double> query_string::find<double>(const std::string& name) const {
+	auto f = _parameters.find(name);
+	if (f == _parameters.end()) {
+		return std::nullopt;
+	}
+	return stod(f->second);
+}
+
 template<>
 std::optional<bool> query_string::find<bool>(const std::string& name) const {
 	auto f = _parameters.find(name);
@@ -9,6 +9,7 @@
 #include <optional>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace horace {
 
@@ -32,7 +33,10 @@ public:
 	 * - bool (taking a string "true" or "false")
 	 * - long (taking a decimal string)
 	 * - long long (also taking a decimal string)
+	 * - double (taking a decimal or floating point string)
 	 * - std::string
+	 * - std::vector<std::string> (taking a colon-separated list of
+	 *   non-empty strings)
 	 * @param name the name of the parameter to be found
 	 */
 	template<typename T>
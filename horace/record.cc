@@ -8,12 +8,12 @@
 
 #include "horace/horace_error.h"
 #include "horace/logger.h"
-#include "horace/log_message.h"
 #include "horace/octet_reader.h"
 #include "horace/octet_writer.h"
 #include "horace/unsigned_base128_integer.h"
 #include "horace/signed_base128_integer.h"
 #include "horace/unsigned_integer_attribute.h"
+#include "horace/signed_integer_attribute.h"
 #include "horace/string_attribute.h"
 #include "horace/timestamp_attribute.h"
 #include "horace/compound_attribute.h"
@@ -24,30 +24,103 @@ namespace horace {
 
 std::unique_ptr<unsigned int> protocol_version;
 
+void record::_parse(session_context& session, int attr_id,
+	size_t attr_len, octet_reader& in) {
+
+	// References to the string dictionary are resolved without
+	// constructing an attribute, and without copying the entry.
+	if (attr_id == attrid_dict_ref) {
+		if (attr_len > 8) {
+			throw horace_error("invalid length for dict_ref attribute");
+		}
+		_attributes.insert_shared(session.get_dict_entry(
+			in.read_unsigned(attr_len)));
+		return;
+	}
+
+	std::unique_ptr<attribute> attr =
+		attribute::parse(session, attr_id, attr_len, in);
+	switch (attr_id) {
+	case attrid_attr_def:
+		session.handle_attr_def(
+			dynamic_cast<compound_attribute&>(*attr));
+		break;
+	case attrid_chan_def:
+		session.handle_channel_def(
+			dynamic_cast<compound_attribute&>(*attr));
+		break;
+	case attrid_delta_encoding:
+		// The marker is removed from the session record,
+		// so that it is identical to the one which was
+		// originally written (and hashed).
+		if (_channel == channel_session) {
+			session.deltas().handle_delta_encoding(*attr);
+			attr = 0;
+		}
+		break;
+	case attrid_ts_delta:
+		attr = session.deltas().decode_ts(
+			dynamic_cast<signed_integer_attribute&>(*attr));
+		break;
+	case attrid_record_template:
+		// Likewise for record templates, which are removed from
+		// the event records which declare them.
+		if (is_event()) {
+			session.handle_template(_channel,
+				dynamic_cast<compound_attribute&>(*attr));
+			attr = 0;
+		}
+		break;
+	case attrid_dict_def:
+		_attributes.insert_shared(session.handle_dict_def(
+			dynamic_cast<compound_attribute&>(*attr)));
+		attr = 0;
+		break;
+	default:
+		// no action
+		break;
+	}
+	if (attr) {
+		_attributes.insert(attr);
+	}
+}
+
 record::record(session_context& session, octet_reader& in) {
 	_channel = in.read_signed_base128();
+	if (_channel == channel_session) {
+		session.begin_session();
+	}
 	size_t remaining = in.read_unsigned_base128();
+
+	// If there is a template for this channel then the record begins
+	// with one slot for each attribute ID in the template. Each slot
+	// contains the content length plus one (or zero if absent),
+	// followed by the content.
+	if (const std::vector<int>* tmpl = session.get_template(_channel)) {
+		for (int attr_id : *tmpl) {
+			size_t hdr_len = 0;
+			size_t attr_len = in.read_unsigned_base128(hdr_len);
+			if (attr_len) {
+				attr_len -= 1;
+				_parse(session, attr_id, attr_len, in);
+			}
+
+			size_t length = hdr_len + attr_len;
+			if (length > remaining) {
+				throw horace_error(
+					"attribute extends beyond length of record");
+			}
+			remaining -= length;
+		}
+	}
+
+	// Any remaining attributes are encoded in full.
 	while (remaining) {
 		size_t hdr_len = 0;
 		int attr_id = in.read_signed_base128(hdr_len);
 		int attr_len = in.read_unsigned_base128(hdr_len);
 
-		std::unique_ptr<attribute> attr =
-			attribute::parse(session, attr_id, attr_len, in);
-		switch (attr->attrid()) {
-		case attrid_attr_def:
-			session.handle_attr_def(
-				dynamic_cast<compound_attribute&>(*attr));
-			break;
-		case attrid_chan_def:
-			session.handle_channel_def(
-				dynamic_cast<compound_attribute&>(*attr));
-			break;
-		default:
-			// no action
-			break;
-		}
-		_attributes.insert(attr);
+		_parse(session, attr_id, attr_len, in);
 
 		size_t length = hdr_len + attr_len;
 		if (length > remaining) {
@@ -56,6 +129,16 @@ record::record(session_context& session, octet_reader& in) {
 		}
 		remaining -= length;
 	}
+	if (is_event() && session.deltas().enabled()) {
+		session.deltas().end_event(_attributes);
+	}
+}
+
+size_t record::length() const {
+	size_t content_len = _attributes.length();
+	return signed_base128_integer(_channel).length() +
+		unsigned_base128_integer(content_len).length() +
+		content_len;
 }
 
 void record::write(octet_writer& out) const {
@@ -66,33 +149,33 @@ void record::write(octet_writer& out) const {
 
 void record::log(logger& log) const {
 	if (log.enabled(logger::log_info)) {
-		log_message msg(log, logger::log_info);
+		// This function may be called for every record forwarded,
+		// so the message is built directly as a string rather than
+		// by means of a log_message.
 		switch (_channel) {
 		case channel_error:
-			msg << "error record";
+			log << "error record";
 			break;
 		case channel_warning:
-			msg << "warning record";
+			log << "warning record";
 			break;
 		case channel_session:
-			msg << "session record";
+			log << "session record";
 			break;
 		case channel_end:
-			msg << "end record";
+			log << "end record";
 			break;
 		case channel_sync:
-			msg << "sync record";
+			log << "sync record";
 			break;
 		case channel_signature:
-			msg << "signature record";
+			log << "signature record";
 			break;
 		default:
-			if (_channel >= 0) {
-				msg << "event";
-			} else {
-				msg << "unrecognised";
-			}
-			msg << " record for channel " << _channel;
+			log << std::string((_channel >= 0) ?
+				"event" : "unrecognised") +
+				" record for channel " +
+				std::to_string(_channel);
 		}
 	}
 }
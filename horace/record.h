@@ -7,6 +7,7 @@
 #define LIBHOLMES_HORACE_RECORD
 
 #include <iosfwd>
+#include <memory>
 
 #include "horace/attribute_list.h"
 
@@ -37,6 +38,17 @@ private:
 
 	/** The attribute list. */
 	attribute_list _attributes;
+
+	/** Parse an attribute from an octet reader, then add it to this
+	 * record if appropriate.
+	 * The ID and length fields must already have been read.
+	 * @param session the applicable session information object
+	 * @param attr_id the attribute ID
+	 * @param attr_len the length of the content, in octets
+	 * @param in the octet reader
+	 */
+	void _parse(session_context& session, int attr_id, size_t attr_len,
+		octet_reader& in);
 public:
 	/** Construct empty record.
 	 * This is provided so that a record can be a member of a
@@ -63,11 +75,30 @@ public:
 
 	/** Construct record from octet reader.
 	 * The channel and length fields must not already have been read.
+	 * Attributes taken from the string dictionary of the session are
+	 * not copied, but the record shares ownership of them, so it
+	 * remains valid after a further session record has been read.
 	 * @param session the applicable session information object
 	 * @param in the octet reader
 	 */
 	record(session_context& session, octet_reader& in);
 
+	virtual ~record() = default;
+
+	/** Replace the content of this record.
+	 * This differs from assigning a newly-constructed record in that
+	 * the storage used by the previous attribute list is not released,
+	 * but is passed back by way of the attributes argument (which is
+	 * left empty). This allows a record builder to avoid allocating
+	 * new storage for each record it builds.
+	 * @param channel the channel ID
+	 * @param attributes the list of attributes
+	 */
+	void assign(int channel, attribute_list&& attributes) {
+		_channel = channel;
+		_attributes = std::move(attributes);
+	}
+
 	/** Get the channel ID for this record.
 	 * @return the channel ID
 	 */
@@ -121,10 +152,44 @@ public:
 		return _attributes.find_one<T>(attrid);
 	}
 
+	/** Find the source ID attribute.
+	 * @return the source ID attribute
+	 */
+	const string_attribute& find_source() const {
+		return _attributes.find_source();
+	}
+
+	/** Find the sequence number attribute.
+	 * @return the sequence number attribute
+	 */
+	const unsigned_integer_attribute& find_seqnum() const {
+		return _attributes.find_seqnum();
+	}
+
+	/** Find the timestamp attribute.
+	 * @return the timestamp attribute
+	 */
+	const timestamp_attribute& find_ts() const {
+		return _attributes.find_ts();
+	}
+
+	/** Find the hash attribute.
+	 * @return the hash attribute
+	 */
+	const binary_ref_attribute& find_hash() const {
+		return _attributes.find_hash();
+	}
+
+	/** Get the encoded length of this record.
+	 * The result includes the channel ID and length fields.
+	 * @return the length, in octets
+	 */
+	virtual size_t length() const;
+
 	/** Write this record to an octet writer.
 	 * @param out the octet writer
 	 */
-	void write(octet_writer& out) const;
+	virtual void write(octet_writer& out) const;
 
 	/** Test whether two records are equal.
 	 * @param lhs the left hand side
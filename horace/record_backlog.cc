@@ -0,0 +1,169 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "horace/libc_error.h"
+#include "horace/horace_error.h"
+#include "horace/logger.h"
+#include "horace/log_message.h"
+#include "horace/octet_reader.h"
+#include "horace/octet_writer.h"
+#include "horace/record_backlog.h"
+
+namespace horace {
+
+record_backlog::record_backlog(stats_group& stats, size_t capacity,
+	const std::string& spilldir):
+	_capacity(capacity),
+	_spilldir(spilldir),
+	_size(0),
+	_rdpos(0),
+	_wrpos(0),
+	_backlogged(stats.counter("backlogged")),
+	_spills(stats.counter("spilled")) {}
+
+std::string record_backlog::_serialise(const record& rec) {
+	std::string data(rec.length(), 0);
+	octet_writer out(data.data(), data.length());
+	rec.write(out);
+	return data;
+}
+
+std::unique_ptr<record> record_backlog::_decode(std::string& data) {
+	octet_reader in(data.data(), data.length(), data.length());
+	return std::make_unique<record>(_session, in);
+}
+
+void record_backlog::_spill(const std::string& data) {
+	if (!_spillfd) {
+		// The spillfile is anonymous, so that it does not outlive
+		// the process.
+		_spillfd = file_descriptor(_spilldir, O_RDWR | O_TMPFILE, 0600);
+	}
+
+	const char* ptr = data.data();
+	size_t remaining = data.length();
+	off_t offset = _wrpos;
+	while (remaining) {
+		ssize_t count = ::pwrite(_spillfd, ptr, remaining, offset);
+		if (count == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw libc_error();
+		}
+		ptr += count;
+		remaining -= count;
+		offset += count;
+	}
+	_wrpos = offset;
+	_spilled.push_back(data.length());
+}
+
+void record_backlog::begin_session(const record& srec) {
+	if (!empty()) {
+		throw horace_error("backlog not empty at start of session");
+	}
+	_session = session_context();
+	std::string data = _serialise(srec);
+	_decode(data);
+}
+
+bool record_backlog::push(const record& rec) {
+	std::string data = _serialise(rec);
+
+	if (_spilled.empty() && (_size + data.length() <= _capacity)) {
+		_size += data.length();
+		_queue.push_back(std::move(data));
+		_backlogged.add();
+		return true;
+	}
+
+	if (!_spilldir.empty()) {
+		try {
+			_spill(data);
+			_backlogged.add();
+			_spills.add();
+			return true;
+		} catch (libc_error& ex) {
+			if (log->enabled(logger::log_err)) {
+				log_message msg(*log, logger::log_err);
+				msg << "failed to write to spillfile: " <<
+					ex.what();
+			}
+		}
+	}
+	return false;
+}
+
+const record& record_backlog::front() {
+	if (!_head) {
+		if (!_queue.empty()) {
+			_head = _decode(_queue.front());
+		} else {
+			std::string data(_spilled.front(), 0);
+			char* ptr = data.data();
+			size_t remaining = data.length();
+			off_t offset = _rdpos;
+			while (remaining) {
+				ssize_t count = ::pread(_spillfd, ptr, remaining,
+					offset);
+				if (count == -1) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw libc_error();
+				} else if (count == 0) {
+					throw horace_error(
+						"unexpected end of spillfile");
+				}
+				ptr += count;
+				remaining -= count;
+				offset += count;
+			}
+			_head = _decode(data);
+		}
+	}
+	return *_head;
+}
+
+void record_backlog::pop() {
+	_head = 0;
+	if (!_queue.empty()) {
+		_size -= _queue.front().length();
+		_queue.pop_front();
+	} else {
+		_rdpos += _spilled.front();
+		_spilled.pop_front();
+		if (_spilled.empty()) {
+			// Release the space occupied by the spillfile, which
+			// would otherwise grow for as long as it remained in
+			// use.
+			if (::ftruncate(_spillfd, 0) == -1) {
+				throw libc_error();
+			}
+			_rdpos = 0;
+			_wrpos = 0;
+		}
+	}
+}
+
+void record_backlog::clear() {
+	_head = 0;
+	_queue.clear();
+	_size = 0;
+	if (!_spilled.empty()) {
+		_spilled.clear();
+		if (::ftruncate(_spillfd, 0) == -1) {
+			throw libc_error();
+		}
+		_rdpos = 0;
+		_wrpos = 0;
+	}
+}
+
+} /* namespace horace */
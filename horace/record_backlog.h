@@ -0,0 +1,147 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_RECORD_BACKLOG
+#define LIBHOLMES_HORACE_RECORD_BACKLOG
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <sys/types.h>
+
+#include "horace/file_descriptor.h"
+#include "horace/session_context.h"
+#include "horace/record.h"
+#include "horace/stats_group.h"
+
+namespace horace {
+
+/** A class for holding records which could not yet be written.
+ * Records are held in serialised form, so that they remain valid
+ * after any buffers to which they referred have been released (such
+ * as the ring buffer of a network interface). They are held in memory
+ * up to a given capacity, after which they can optionally be spilled
+ * to an anonymous temporary file.
+ *
+ * Records are returned in the order in which they were pushed. Once
+ * any record has been spilled, subsequent records are also spilled
+ * until the spillfile has been emptied, in order to preserve that
+ * ordering.
+ */
+class record_backlog {
+private:
+	/** The maximum amount of memory to use, in octets. */
+	size_t _capacity;
+
+	/** The directory in which to create the spillfile,
+	 * or the empty string if spilling is disabled. */
+	std::string _spilldir;
+
+	/** A session context for decoding records. */
+	session_context _session;
+
+	/** The serialised records held in memory. */
+	std::deque<std::string> _queue;
+
+	/** The total length of the records held in memory, in octets. */
+	size_t _size;
+
+	/** The spillfile, or -1 if not yet opened. */
+	file_descriptor _spillfd;
+
+	/** The lengths of the records held in the spillfile. */
+	std::deque<size_t> _spilled;
+
+	/** The offset of the next record to be read from the spillfile. */
+	off_t _rdpos;
+
+	/** The offset at which to write the next record to the spillfile. */
+	off_t _wrpos;
+
+	/** The decoded record at the front of the backlog, or 0 if not
+	 * yet decoded. */
+	std::unique_ptr<record> _head;
+
+	/** A counter for recording records pushed to the backlog. */
+	stats_counter& _backlogged;
+
+	/** A counter for recording records pushed to the spillfile. */
+	stats_counter& _spills;
+
+	/** Serialise a record.
+	 * @param rec the record to be serialised
+	 * @return the serialised record
+	 */
+	static std::string _serialise(const record& rec);
+
+	/** Decode a serialised record.
+	 * @param data the serialised record
+	 * @return the decoded record
+	 */
+	std::unique_ptr<record> _decode(std::string& data);
+
+	/** Append a serialised record to the spillfile.
+	 * @param data the serialised record
+	 */
+	void _spill(const std::string& data);
+public:
+	/** Construct record backlog.
+	 * @param stats the statistics group to which counters should be added
+	 * @param capacity the maximum amount of memory to use, in octets
+	 * @param spilldir the directory in which to create a spillfile,
+	 *  or the empty string if records should not be spilled
+	 */
+	record_backlog(stats_group& stats, size_t capacity,
+		const std::string& spilldir);
+
+	/** Begin a new session.
+	 * Records pushed to the backlog must be decodable in the context
+	 * of this session record. The backlog must be empty when this
+	 * function is called, since any records remaining in it would
+	 * belong to the previous session.
+	 * @param srec the session record
+	 */
+	void begin_session(const record& srec);
+
+	/** Test whether the backlog is empty.
+	 * @return true if empty, otherwise false
+	 */
+	bool empty() const {
+		return _queue.empty() && _spilled.empty();
+	}
+
+	/** Get the number of records in the backlog.
+	 * @return the number of records
+	 */
+	size_t count() const {
+		return _queue.size() + _spilled.size();
+	}
+
+	/** Push a record onto the back of the backlog.
+	 * @param rec the record to be pushed
+	 * @return true if the record was pushed, or false if there is
+	 *  insufficient space to hold it
+	 */
+	bool push(const record& rec);
+
+	/** Get the record at the front of the backlog.
+	 * The backlog must not be empty.
+	 * @return the record
+	 */
+	const record& front();
+
+	/** Remove the record at the front of the backlog.
+	 * The backlog must not be empty.
+	 */
+	void pop();
+
+	/** Remove all records from the backlog. */
+	void clear();
+};
+
+} /* namespace horace */
+
+#endif
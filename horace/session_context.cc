@@ -3,6 +3,8 @@
 // Redistribution and modification are permitted within the terms of the
 // BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
 
+#include <algorithm>
+
 #include "horace/horace_error.h"
 #include "horace/unsigned_integer_attribute.h"
 #include "horace/signed_integer_attribute.h"
@@ -14,59 +16,144 @@
 namespace horace {
 namespace {
 
-/** The reserved attribute labels applicable to all sessions,
- * indexed by attribute ID. */
-const std::map<int, std::string> _reserved_attr_labels = {
-	{ attrid_protocol, "protocol" },
-	{ attrid_attr_def, "attr_def" },
-	{ attrid_attr_id, "attr_id" },
-	{ attrid_attr_label, "attr_label" },
-	{ attrid_chan_def, "chan_def" },
-	{ attrid_chan_id, "chan_id" },
-	{ attrid_chan_label, "chan_label" },
-	{ attrid_type, "content_type" },
-	{ attrid_source, "source" },
-	{ attrid_seqnum, "seqnum" },
-	{ attrid_ts, "ts" },
-	{ attrid_time_system, "time_system" },
-	{ attrid_message, "message" },
-	{ attrid_hash, "hash" },
-	{ attrid_hash_alg, "hash_alg" },
-	{ attrid_sig, "hash_sig" },
-	{ attrid_sig_alg, "hash_sig_alg" },
-	{ attrid_sig_pubkey, "hash_sig_pubkey" }};
-
-/** The reserved attribute formats applicable to all sessions,
- * indexed by attribute ID. */
-const std::map<int, int> _reserved_attr_types = {
-	{ attrid_protocol, type_unsigned_integer },
-	{ attrid_attr_def, type_compound },
-	{ attrid_attr_id, type_signed_integer },
-	{ attrid_attr_label, type_string },
-	{ attrid_chan_def, type_compound },
-	{ attrid_chan_id, type_signed_integer },
-	{ attrid_chan_label, type_string },
-	{ attrid_type, type_unsigned_integer },
-	{ attrid_source, type_string },
-	{ attrid_seqnum, type_unsigned_integer },
-	{ attrid_ts, type_timestamp },
-	{ attrid_time_system, type_string },
-	{ attrid_message, type_string },
-	{ attrid_hash, type_binary },
-	{ attrid_hash_alg, type_string },
-	{ attrid_sig, type_binary },
-	{ attrid_sig_alg, type_string },
-	{ attrid_sig_pubkey, type_binary }};
-
-/** The reserved channel labels applicable to all sessions,
- * indexed by channel ID. */
-std::map<int, std::string> _reserved_chan_labels = {
+/** A structure to describe a reserved attribute. */
+struct reserved_attr {
+	/** The attribute ID. */
+	int attrid;
+
+	/** The attribute label. */
+	const char* label;
+
+	/** The attribute format. */
+	int type;
+};
+
+/** A structure to describe a reserved channel. */
+struct reserved_channel {
+	/** The channel ID. */
+	int channel_id;
+
+	/** The channel label. */
+	const char* label;
+};
+
+/** The reserved attributes applicable to all sessions. */
+constexpr reserved_attr _reserved_attrs[] = {
+	{ attrid_protocol, "protocol", type_unsigned_integer },
+	{ attrid_attr_def, "attr_def", type_compound },
+	{ attrid_attr_id, "attr_id", type_signed_integer },
+	{ attrid_attr_label, "attr_label", type_string },
+	{ attrid_chan_def, "chan_def", type_compound },
+	{ attrid_chan_id, "chan_id", type_signed_integer },
+	{ attrid_chan_label, "chan_label", type_string },
+	{ attrid_type, "content_type", type_unsigned_integer },
+	{ attrid_source, "source", type_string },
+	{ attrid_seqnum, "seqnum", type_unsigned_integer },
+	{ attrid_ts, "ts", type_timestamp },
+	{ attrid_time_system, "time_system", type_string },
+	{ attrid_message, "message", type_string },
+	{ attrid_hash, "hash", type_binary },
+	{ attrid_hash_alg, "hash_alg", type_string },
+	{ attrid_sig, "hash_sig", type_binary },
+	{ attrid_sig_alg, "hash_sig_alg", type_string },
+	{ attrid_sig_pubkey, "hash_sig_pubkey", type_binary },
+	{ attrid_hash_count, "hash_count", type_unsigned_integer },
+	{ attrid_ts_delta, "ts_delta", type_signed_integer },
+	{ attrid_delta_encoding, "delta_encoding", type_boolean },
+	{ attrid_record_template, "record_template", type_compound },
+	{ attrid_dict_def, "dict_def", type_compound },
+	{ attrid_dict_ref, "dict_ref", type_unsigned_integer }};
+
+/** The reserved channels applicable to all sessions. */
+constexpr reserved_channel _reserved_channels[] = {
 	{ channel_error, "error" },
 	{ channel_session, "session" },
 	{ channel_sync, "sync" }};
 
+/** The content type used to mark an undefined attribute ID. */
+const int type_undefined = -1;
+
+/** The largest attribute or channel ID which may be defined.
+ * This prevents a malformed definition from causing an excessively
+ * large table to be allocated.
+ */
+const int max_defined_id = 0xffff;
+
+/** The largest number of entries permitted in the string dictionary.
+ * This prevents a malformed stream from causing unbounded memory use.
+ */
+const size_t max_dict_entries = 0x10000;
+
+/** Calculate the offset needed to index the reserved attributes.
+ * @return the offset
+ */
+constexpr size_t attr_offset() {
+	int min_attrid = 0;
+	for (const auto& attr : _reserved_attrs) {
+		min_attrid = std::min(min_attrid, attr.attrid);
+	}
+	return -min_attrid;
+}
+
+/** Calculate the offset needed to index the reserved channels.
+ * @return the offset
+ */
+constexpr size_t chan_offset() {
+	int min_channel_id = 0;
+	for (const auto& chan : _reserved_channels) {
+		min_channel_id = std::min(min_channel_id, chan.channel_id);
+	}
+	return -min_channel_id;
+}
+
+/** Get the table index for a given attribute ID.
+ * Negative IDs less than the lowest reserved ID wrap around to give
+ * an index beyond the end of the table.
+ * @param attrid the attribute ID
+ * @return the table index
+ */
+inline size_t attr_index(int attrid) {
+	return static_cast<size_t>(attrid) + attr_offset();
+}
+
+/** Get the table index for a given channel ID.
+ * @param channel_id the channel ID
+ * @return the table index
+ */
+inline size_t chan_index(int channel_id) {
+	return static_cast<size_t>(channel_id) + chan_offset();
+}
+
+/** Report an attempt to parse an undefined attribute ID.
+ * This has the same signature as a parse function, so that it can
+ * be placed in the parse function table.
+ */
+std::unique_ptr<attribute> parse_undefined(session_context& session,
+	int attrid, size_t length, octet_reader& in) {
+
+	throw horace_error(std::string("unrecognised attribute ID ") +
+		std::to_string(attrid));
+}
+
 } /* anonymous namespace */
 
+session_context::session_context():
+	_attr_labels(attr_offset()),
+	_attr_types(attr_offset(), type_undefined),
+	_attr_parsers(attr_offset(), parse_undefined),
+	_chan_labels(chan_offset()) {
+
+	for (const auto& attr : _reserved_attrs) {
+		size_t index = attr_index(attr.attrid);
+		_attr_labels[index] = attr.label;
+		_attr_types[index] = attr.type;
+		_attr_parsers[index] = attribute::parser(attr.type);
+	}
+	for (const auto& chan : _reserved_channels) {
+		_chan_labels[chan_index(chan.channel_id)] = chan.label;
+	}
+}
+
 void session_context::handle_attr_def(const compound_attribute& attr) {
 	int64_t attrid = attr.content().find_one<signed_integer_attribute>(
 		attrid_attr_id).content();
@@ -74,8 +161,20 @@ void session_context::handle_attr_def(const compound_attribute& attr) {
 		attrid_attr_label).content();
 	uint64_t type = attr.content().find_one<unsigned_integer_attribute>(
 		attrid_type).content();
-	_attr_labels[attrid] = attrlabel;
-	_attr_types[attrid] = type;
+	if (attrid < 0 || attrid > max_defined_id) {
+		throw horace_error(std::string("attribute ID out of range ") +
+			std::to_string(attrid));
+	}
+
+	size_t index = attr_index(attrid);
+	if (index >= _attr_types.size()) {
+		_attr_labels.resize(index + 1);
+		_attr_types.resize(index + 1, type_undefined);
+		_attr_parsers.resize(index + 1, parse_undefined);
+	}
+	_attr_labels[index] = attrlabel;
+	_attr_types[index] = type;
+	_attr_parsers[index] = attribute::parser(type);
 }
 
 void session_context::handle_channel_def(const compound_attribute& attr) {
@@ -83,52 +182,102 @@ void session_context::handle_channel_def(const compound_attribute& attr) {
 		attrid_chan_id).content();
 	std::string label = attr.content().find_one<string_attribute>(
 		attrid_chan_label).content();
-	_chan_labels[chanid] = label;
+	if (chanid < 0 || chanid > max_defined_id) {
+		throw horace_error(std::string("channel ID out of range ") +
+			std::to_string(chanid));
+	}
+
+	size_t index = chan_index(chanid);
+	if (index >= _chan_labels.size()) {
+		_chan_labels.resize(index + 1);
+	}
+	_chan_labels[index] = label;
 }
 
-const std::string& session_context::get_attr_label(int attrid) {
-	if (attrid < 0) {
-		auto f = _reserved_attr_labels.find(attrid);
-		if (f != _reserved_attr_labels.end()) {
-			return f->second;
-		}
-	} else {
-		auto f = _attr_labels.find(attrid);
-		if (f != _attr_labels.end()) {
-			return f->second;
+void session_context::begin_session() {
+	_templates.clear();
+	_dictionary.clear();
+	_deltas.begin_session();
+}
+
+void session_context::handle_template(int channel_id,
+	const compound_attribute& attr) {
+
+	if (channel_id < 0 || channel_id > max_defined_id) {
+		throw horace_error(std::string("channel ID out of range ") +
+			std::to_string(channel_id));
+	}
+
+	if (static_cast<size_t>(channel_id) >= _templates.size()) {
+		_templates.resize(channel_id + 1);
+	}
+	std::vector<int>& tmpl = _templates[channel_id];
+	tmpl.clear();
+	for (const attribute* subattr : attr.content()) {
+		if (subattr->attrid() != attrid_attr_id) {
+			throw horace_error("invalid record template");
 		}
+		tmpl.push_back(dynamic_cast<const signed_integer_attribute&>(
+			*subattr).content());
+	}
+}
+
+const std::shared_ptr<const attribute>& session_context::handle_dict_def(
+	const compound_attribute& attr) {
+
+	if (_dictionary.size() >= max_dict_entries) {
+		throw horace_error("string dictionary full");
+	}
+	const auto& subattrs = attr.content().attributes();
+	if (subattrs.size() != 1) {
+		throw horace_error("invalid string dictionary definition");
+	}
+	_dictionary.push_back(subattrs.front()->clone());
+	return _dictionary.back();
+}
+
+const std::shared_ptr<const attribute>& session_context::get_dict_entry(
+	uint64_t index) const {
+
+	if (index >= _dictionary.size()) {
+		throw horace_error(std::string("undefined dictionary entry ") +
+			std::to_string(index));
+	}
+	return _dictionary[index];
+}
+
+const std::string& session_context::get_attr_label(int attrid) {
+	size_t index = attr_index(attrid);
+	if (index < _attr_types.size() &&
+		_attr_types[index] != type_undefined) {
+		return _attr_labels[index];
 	}
 	throw horace_error(std::string("unrecognised attribute ID ") +
 		std::to_string(attrid));
 }
 
 int session_context::get_attr_type(int attrid) {
-	if (attrid < 0) {
-		auto f = _reserved_attr_types.find(attrid);
-		if (f != _reserved_attr_types.end()) {
-			return f->second;
-		}
-	} else {
-		auto f = _attr_types.find(attrid);
-		if (f != _attr_types.end()) {
-			return f->second;
-		}
+	size_t index = attr_index(attrid);
+	if (index < _attr_types.size() &&
+		_attr_types[index] != type_undefined) {
+		return _attr_types[index];
 	}
 	throw horace_error(std::string("unrecognised attribute ID ") +
 		std::to_string(attrid));
 }
 
+attribute::parse_function* session_context::get_attr_parser(int attrid) {
+	size_t index = attr_index(attrid);
+	if (index < _attr_parsers.size()) {
+		return _attr_parsers[index];
+	}
+	return parse_undefined;
+}
+
 const std::string& session_context::get_channel_label(int channel_id) {
-	if (channel_id < 0) {
-		auto f = _reserved_chan_labels.find(channel_id);
-		if (f != _reserved_chan_labels.end()) {
-			return f->second;
-		}
-	} else {
-		auto f = _chan_labels.find(channel_id);
-		if (f != _chan_labels.end()) {
-			return f->second;
-		}
+	size_t index = chan_index(channel_id);
+	if (index < _chan_labels.size() && _chan_labels[index]) {
+		return *_chan_labels[index];
 	}
 	throw horace_error(std::string("unrecognised channel ID") +
 		std::to_string(channel_id));
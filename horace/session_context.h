@@ -6,25 +6,59 @@
 #ifndef LIBHOLMES_HORACE_SESSION_CONTEXT
 #define LIBHOLMES_HORACE_SESSION_CONTEXT
 
-#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+#include "horace/attribute.h"
+#include "horace/delta_decoder.h"
 
 namespace horace {
 
 class compound_attribute;
 
-/** A class for tracking the context of a HORACE session. */
+/** A class for tracking the context of a HORACE session.
+ * Attribute and channel definitions are held in dense tables, indexed
+ * by ID plus an offset which allows for the reserved (negative) IDs.
+ * This allows them to be looked up in constant time when parsing,
+ * but means that user-defined IDs must be allocated contiguously
+ * from zero (as they are by session_builder).
+ */
 class session_context {
 private:
-	/** The attribute labels for this session, indexed by ID. */
-	std::map<int, std::string> _attr_labels;
+	/** The attribute labels for this session, indexed by ID plus
+	 * offset. */
+	std::vector<std::string> _attr_labels;
+
+	/** The attribute formats for this session, indexed by ID plus
+	 * offset, or -1 if undefined. */
+	std::vector<int> _attr_types;
+
+	/** The attribute parse functions for this session, indexed by
+	 * ID plus offset. */
+	std::vector<attribute::parse_function*> _attr_parsers;
 
-	/** The attribute formats for this session, indexed by ID. */
-	std::map<int, int> _attr_types;
+	/** The channel labels for this session, indexed by ID plus
+	 * offset. */
+	std::vector<std::optional<std::string>> _chan_labels;
 
-	/** The channel labels for this session, indexed by ID. */
-	std::map<int, std::string> _chan_labels;
+	/** The record templates for this session, indexed by channel ID.
+	 * An empty template indicates that the channel does not have
+	 * one. */
+	std::vector<std::vector<int>> _templates;
+
+	/** The string dictionary for this session, indexed by entry
+	 * number. */
+	std::vector<std::shared_ptr<const attribute>> _dictionary;
+
+	/** The decoder for delta encoded records. */
+	delta_decoder _deltas;
 public:
+	/** Construct session context containing only the reserved
+	 * attribute and channel definitions. */
+	session_context();
+
 	/** Handle an attribute definition.
 	 * @param attr the attribute definition attribute to be handled
 	 */
@@ -35,6 +69,37 @@ public:
 	 */
 	void handle_channel_def(const compound_attribute& attr);
 
+	/** Handle the start of a session record.
+	 * This clears any state which applies only to the encoding of
+	 * the preceding session.
+	 */
+	void begin_session();
+
+	/** Handle a record template.
+	 * The template applies to subsequent records on the given channel.
+	 * @param channel_id the channel ID
+	 * @param attr the record template attribute to be handled
+	 */
+	void handle_template(int channel_id, const compound_attribute& attr);
+
+	/** Handle a string dictionary definition.
+	 * The attribute contained within the definition is added to the
+	 * dictionary as the next entry. Ownership is shared, so records
+	 * may refer to it rather than making a copy, and remain valid
+	 * after the dictionary has been cleared by the next session record.
+	 * @param attr the dict_def attribute to be handled
+	 * @return the attribute which has been added to the dictionary
+	 */
+	const std::shared_ptr<const attribute>& handle_dict_def(
+		const compound_attribute& attr);
+
+	/** Get an entry from the string dictionary.
+	 * @param index the required entry number
+	 * @return the corresponding attribute
+	 */
+	const std::shared_ptr<const attribute>& get_dict_entry(
+		uint64_t index) const;
+
 	/** Get the attribute label for a given attribute ID.
 	 * @param attrid the required attribute ID
 	 * @return the corresponding attribute label
@@ -47,11 +112,40 @@ public:
 	 */
 	int get_attr_type(int attrid);
 
+	/** Get the parse function for a given attribute ID.
+	 * If the attribute ID is undefined then the function returned
+	 * will throw a horace_error when called.
+	 * @param attrid the required attribute ID
+	 * @return the corresponding parse function
+	 */
+	attribute::parse_function* get_attr_parser(int attrid);
+
 	/** Get the channel label for a given channel ID.
 	 * @param channel_id the required channel ID
 	 * @return the corresponding channel label
 	 */
 	const std::string& get_channel_label(int channel_id);
+
+	/** Get the record template for a given channel ID.
+	 * @param channel_id the required channel ID
+	 * @return the attribute IDs in the template, or null if none
+	 */
+	const std::vector<int>* get_template(int channel_id) const {
+		if ((channel_id >= 0) &&
+			(static_cast<size_t>(channel_id) < _templates.size()) &&
+			!_templates[channel_id].empty()) {
+
+			return &_templates[channel_id];
+		}
+		return 0;
+	}
+
+	/** Get the decoder for delta encoded records.
+	 * @return the delta decoder
+	 */
+	delta_decoder& deltas() {
+		return _deltas;
+	}
 };
 
 } /* namespace horace */
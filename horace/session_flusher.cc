@@ -0,0 +1,63 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/terminate_exception.h"
+#include "horace/logger.h"
+#include "horace/log_limiter.h"
+#include "horace/log_message.h"
+#include "horace/session_writer.h"
+#include "horace/session_flusher.h"
+
+namespace horace {
+
+session_flusher::session_flusher(session_writer& sw,
+	std::chrono::milliseconds interval):
+	_sw(&sw),
+	_interval(interval),
+	_stopping(false) {
+
+	_thread = std::thread(&session_flusher::_run, this);
+}
+
+session_flusher::~session_flusher() {
+	{
+		std::lock_guard<std::mutex> lk(_mutex);
+		_stopping = true;
+	}
+	_cv.notify_one();
+	_thread.join();
+}
+
+void session_flusher::_run() {
+	log_limiter limiter;
+	std::unique_lock<std::mutex> lk(_mutex);
+	while (!_stopping) {
+		_cv.wait_for(lk, _interval);
+		if (_stopping) {
+			break;
+		}
+
+		try {
+			_sw->flush();
+		} catch (terminate_exception&) {
+			break;
+		} catch (std::exception& ex) {
+			// Any underlying problem with the session writer
+			// will recur when it is next used, and be handled
+			// by the owning thread. Flushing continues, since
+			// the problem may be transient, but the error is
+			// rate-limited in case it is not.
+			if (log->enabled(logger::log_err) && limiter.permit()) {
+				log_message msg(*log, logger::log_err);
+				msg << ex.what();
+				if (uint64_t count = limiter.suppressed()) {
+					msg << ", " << count << " more suppressed";
+				}
+			}
+		}
+	}
+}
+
+} /* namespace horace */
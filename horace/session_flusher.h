@@ -0,0 +1,73 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SESSION_FLUSHER
+#define LIBHOLMES_HORACE_SESSION_FLUSHER
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace horace {
+
+class session_writer;
+
+/** A class for flushing a session writer at regular intervals.
+ * Flushing is performed by a background thread. Since session writers
+ * are not thread-safe, any other use of the session writer must be
+ * made while holding the mutex provided by this class. It should not
+ * be held while blocked waiting for input from elsewhere, since that
+ * is when flushing is most likely to be needed.
+ */
+class session_flusher {
+private:
+	/** The session writer to be flushed. */
+	session_writer* _sw;
+
+	/** The interval between flushes. */
+	std::chrono::milliseconds _interval;
+
+	/** A mutex to protect the session writer and _stopping. */
+	std::mutex _mutex;
+
+	/** A condition variable for waking the background thread. */
+	std::condition_variable _cv;
+
+	/** True if the background thread should stop, otherwise false. */
+	bool _stopping;
+
+	/** The background thread. */
+	std::thread _thread;
+
+	/** Flush the session writer at regular intervals until asked
+	 * to stop. */
+	void _run();
+public:
+	/** Construct session flusher.
+	 * @param sw the session writer to be flushed
+	 * @param interval the interval between flushes
+	 */
+	session_flusher(session_writer& sw, std::chrono::milliseconds interval);
+
+	/** Destroy session flusher.
+	 * The background thread is stopped before the destructor returns.
+	 */
+	~session_flusher();
+
+	session_flusher(const session_flusher&) = delete;
+	session_flusher& operator=(const session_flusher&) = delete;
+
+	/** Get the mutex which protects the session writer.
+	 * @return the mutex
+	 */
+	std::mutex& mutex() {
+		return _mutex;
+	}
+};
+
+} /* namespace horace */
+
+#endif
@@ -10,4 +10,6 @@ namespace horace {
 session_writer::session_writer(const std::string& srcid):
 	_srcid(srcid) {}
 
+void session_writer::flush() {}
+
 } /* namespace horace */
@@ -38,18 +38,16 @@ public:
 	 * endpoint with a good prospect that they will be accepted.
 	 *
 	 * If the endpoint ceases to be writable during event capture
-	 * then the session should be ended, and capture suspended unless
-	 * and until the endpoint becomes writable again.
+	 * then records are held back (by new_session_writer, in its
+	 * backlog) unless and until the endpoint becomes writable again.
 	 *
-	 * Sessions should be ended promptly but gracefully. To facilitate
-	 * this, it is permissible for a limited number of records to be
-	 * written after the endpoint becomes unwritable, including event
-	 * records if that helps to establish an accurate end time. The
-	 * endpoint should accept such records if it is able to (or throw
-	 * an exception if it cannot).
+	 * It is permissible for a limited number of records to be written
+	 * after the endpoint becomes unwritable. The endpoint should accept
+	 * such records if it is able to (or throw an exception if it
+	 * cannot).
 	 *
 	 * Interruptions should be reported only if they are serious enough
-	 * to justify ending the session. Examples might include:
+	 * to justify holding records back. Examples might include:
 	 * - Insufficient free space for writing to spoolfiles.
 	 * - Inability to connect to a remote server.
 	 *
@@ -64,6 +62,16 @@ public:
 	 */
 	virtual void write(const record& rec) = 0;
 
+	/** Flush any records buffered by this session writer.
+	 * Session writers are permitted to buffer records in order to
+	 * reduce the number of system calls made, but should not hold
+	 * them indefinitely. This function is called periodically by
+	 * the caller so that records are delivered within a bounded
+	 * time when the flow of records stops. By default no action is
+	 * taken.
+	 */
+	virtual void flush();
+
 	/** Test whether the endpoint is readable.
 	 * Readable means that at least part of a record is available for
 	 * reading. It does not necessarily imply that a complete record can
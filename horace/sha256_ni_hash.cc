@@ -0,0 +1,214 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#include "horace/sha256_ni_hash.h"
+
+namespace horace {
+
+namespace {
+
+/** The initial hash value, as specified by FIPS PUB 180-4. */
+const uint32_t sha256_h0[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+/** The round constants, as specified by FIPS PUB 180-4. */
+const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/** Process one or more complete blocks using the SHA extensions.
+ * @param state the intermediate hash value
+ * @param data the blocks to be processed
+ * @param count the number of blocks
+ */
+__attribute__((target("sha,sse4.1")))
+void sha256_ni_compress(uint32_t* state, const unsigned char* data,
+	size_t count) {
+
+	// The SHA extensions expect the state to be held as ABEF and CDGH,
+	// and the message words to be byte-swapped.
+	const __m128i bswap = _mm_set_epi64x(
+		0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i tmp = _mm_loadu_si128(
+		reinterpret_cast<const __m128i*>(&state[0]));
+	__m128i state1 = _mm_loadu_si128(
+		reinterpret_cast<const __m128i*>(&state[4]));
+	tmp = _mm_shuffle_epi32(tmp, 0xb1);
+	state1 = _mm_shuffle_epi32(state1, 0x1b);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+	for (; count != 0; --count, data += 64) {
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+
+		// Each iteration performs four rounds. The message schedule
+		// is held as four vectors of four words, the oldest of which
+		// is replaced on each iteration once the first sixteen words
+		// have been loaded.
+		__m128i msg[4];
+		for (int i = 0; i != 16; ++i) {
+			__m128i w;
+			if (i < 4) {
+				w = _mm_shuffle_epi8(_mm_loadu_si128(
+					reinterpret_cast<const __m128i*>(
+					data + i * 16)), bswap);
+			} else {
+				w = _mm_sha256msg1_epu32(msg[i % 4],
+					msg[(i + 1) % 4]);
+				w = _mm_add_epi32(w, _mm_alignr_epi8(
+					msg[(i + 3) % 4], msg[(i + 2) % 4], 4));
+				w = _mm_sha256msg2_epu32(w, msg[(i + 3) % 4]);
+			}
+			msg[i % 4] = w;
+
+			__m128i wk = _mm_add_epi32(w, _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(
+				&sha256_k[i * 4])));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+			wk = _mm_shuffle_epi32(wk, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+		}
+
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+#endif
+
+} /* anonymous namespace */
+
+sha256_ni_hash::sha256_ni_hash() {
+	_reset();
+}
+
+void sha256_ni_hash::_reset() {
+	std::copy(sha256_h0, sha256_h0 + 8, _state);
+	_block_len = 0;
+	_total = 0;
+}
+
+void sha256_ni_hash::_compress(const unsigned char* data, size_t count) {
+#if defined(__x86_64__) || defined(__i386__)
+	sha256_ni_compress(_state, data, count);
+#endif
+}
+
+void sha256_ni_hash::_write_direct(const void* buf, size_t nbyte) {
+	const unsigned char* data = static_cast<const unsigned char*>(buf);
+	_total += nbyte;
+
+	// Complete any partial block left over from a previous call.
+	if (_block_len) {
+		size_t fill = std::min(sizeof(_block) - _block_len, nbyte);
+		std::memcpy(_block + _block_len, data, fill);
+		_block_len += fill;
+		data += fill;
+		nbyte -= fill;
+		if (_block_len != sizeof(_block)) {
+			return;
+		}
+		_compress(_block, 1);
+		_block_len = 0;
+	}
+
+	// Process complete blocks in place, then retain the remainder.
+	size_t count = nbyte / sizeof(_block);
+	if (count) {
+		_compress(data, count);
+		data += count * sizeof(_block);
+		nbyte -= count * sizeof(_block);
+	}
+	std::memcpy(_block, data, nbyte);
+	_block_len = nbyte;
+}
+
+const void* sha256_ni_hash::final() {
+	flush();
+
+	// Append the padding and the message length in bits.
+	uint64_t bit_len = _total * 8;
+	_block[_block_len++] = 0x80;
+	if (_block_len > 56) {
+		std::memset(_block + _block_len, 0, sizeof(_block) - _block_len);
+		_compress(_block, 1);
+		_block_len = 0;
+	}
+	std::memset(_block + _block_len, 0, 56 - _block_len);
+	for (int i = 0; i != 8; ++i) {
+		_block[56 + i] = bit_len >> (56 - i * 8);
+	}
+	_compress(_block, 1);
+
+	for (int i = 0; i != 8; ++i) {
+		_hash[i * 4 + 0] = _state[i] >> 24;
+		_hash[i * 4 + 1] = _state[i] >> 16;
+		_hash[i * 4 + 2] = _state[i] >> 8;
+		_hash[i * 4 + 3] = _state[i];
+	}
+	_reset();
+	return _hash;
+}
+
+const std::string& sha256_ni_hash::algorithm() const {
+	static const std::string name("sha256");
+	return name;
+}
+
+bool sha256_ni_hash::supported() {
+#if defined(__x86_64__) || defined(__i386__)
+	// SSE4.1 is reported by leaf 1 in ECX bit 19, and the SHA
+	// extensions by leaf 7 in EBX bit 29.
+	static const bool result = []() {
+		unsigned int eax, ebx, ecx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+			!(ecx & (1 << 19))) {
+			return false;
+		}
+		if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+			return false;
+		}
+		return (ebx & (1 << 29)) != 0;
+	}();
+	return result;
+#else
+	return false;
+#endif
+}
+
+} /* namespace horace */
@@ -0,0 +1,72 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_SHA256_NI_HASH
+#define LIBHOLMES_HORACE_SHA256_NI_HASH
+
+#include <cstdint>
+
+#include "horace/hash.h"
+
+namespace horace {
+
+/** An octet writer class for calculating a SHA256 hash using the
+ * Intel SHA extensions.
+ * This produces the same result as sha256_hash, but is several times
+ * faster on processors which support the SHA extensions. It must not be
+ * constructed unless supported() returns true.
+ */
+class sha256_ni_hash:
+	public hash {
+private:
+	/** The intermediate hash value. */
+	uint32_t _state[8];
+
+	/** A buffer for accumulating a partial block. */
+	unsigned char _block[64];
+
+	/** The number of octets in _block. */
+	size_t _block_len;
+
+	/** The total number of octets hashed. */
+	uint64_t _total;
+
+	/** The hashed result. */
+	unsigned char _hash[32];
+
+	/** Reset the hash context to its initial state. */
+	void _reset();
+
+	/** Process one or more complete blocks.
+	 * @param data the blocks to be processed
+	 * @param count the number of blocks
+	 */
+	void _compress(const unsigned char* data, size_t count);
+protected:
+	virtual void _write_direct(const void* buf, size_t nbyte);
+public:
+	/** Construct SHA256 octet writer. */
+	sha256_ni_hash();
+
+	sha256_ni_hash(const sha256_ni_hash& that) = delete;
+	sha256_ni_hash& operator=(const sha256_ni_hash& that) = delete;
+
+	virtual const void* final();
+
+	virtual size_t length() const {
+		return 32;
+	}
+
+	virtual const std::string& algorithm() const;
+
+	/** Test whether the SHA extensions are supported.
+	 * @return true if supported, otherwise false
+	 */
+	static bool supported();
+};
+
+} /* namespace horace */
+
+#endif
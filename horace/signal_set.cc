@@ -42,7 +42,6 @@ int signal_set::milliwait(int timeout) const {
 signal_set masked_signals = signal_set()
 	.add(SIGINT)
 	.add(SIGQUIT)
-	.add(SIGTERM)
-	.add(SIGALRM);
+	.add(SIGTERM);
 
 } /* namespace horace */
@@ -60,7 +60,7 @@ public:
 };
 
 /** The set of signals which should be masked.
- * These are SIGINT, SIGQUIT and SIGTERM and SIGALRM.
+ * These are SIGINT, SIGQUIT and SIGTERM.
  */
 extern signal_set masked_signals;
 
@@ -72,4 +72,8 @@ void signed_integer_attribute::write(octet_writer& out) const {
 	out.write_signed(_content, len);
 }
 
+void signed_integer_attribute::write_content(octet_writer& out) const {
+	out.write_signed(_content, length());
+}
+
 } /* namespace horace */
@@ -16,8 +16,7 @@ namespace horace {
 namespace {
 
 bool same_ts(const record& lhs, const record& rhs) {
-	return lhs.find_one<timestamp_attribute>(attrid_ts) ==
-		rhs.find_one<timestamp_attribute>(attrid_ts);
+	return lhs.find_ts() == rhs.find_ts();
 }
 
 } /* anonymous namespace */
@@ -31,7 +30,7 @@ void simple_session_writer::_process_session_record(const record& srec) {
 	// Check that the source ID is valid for this session writer.
 	// If not, the session record must be rejected.
 	std::string new_srcid =
-		srec.find_one<string_attribute>(attrid_source).content();
+		srec.find_source().content();
 	if (new_srcid != srcid()) {
 		throw horace_error("unexpected source ID in session record");
 	}
@@ -64,8 +63,8 @@ void simple_session_writer::_process_sync_record(const record& crec) {
 
 	// Construct synchronisation status record for return to caller.
 	attribute_list attrs;
-	attrs.insert(_srec->find_one<string_attribute>(attrid_source).clone());
-	attrs.insert(_srec->find_one<timestamp_attribute>(attrid_ts).clone());
+	attrs.insert(_srec->find_source().clone());
+	attrs.insert(_srec->find_ts().clone());
 	attrs.insert(std::make_unique<unsigned_integer_attribute>(
 		attrid_seqnum, _seqnum));
 	_reply = std::make_unique<record>(channel_sync, std::move(attrs));
@@ -114,8 +113,7 @@ void simple_session_writer::write(const record& rec) {
 	default:
 		if (rec.is_event()) {
 			handle_event(rec);
-			_seqnum = rec.find_one<unsigned_integer_attribute>(
-				attrid_seqnum).content() + 1;
+			_seqnum = rec.find_seqnum().content() + 1;
 		} else {
 			handle_control(rec);
 		}
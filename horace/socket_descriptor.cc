@@ -93,6 +93,23 @@ size_t socket_descriptor::recvmsg(struct msghdr* message, int flags) {
 	return count;
 }
 
+size_t socket_descriptor::recvmmsg(struct mmsghdr* messages,
+	unsigned int count, int flags) {
+
+	int result = -1;
+	while (result < 0) {
+		result = ::recvmmsg(*this, messages, count, flags, 0);
+		if (result == -1) {
+			if ((errno == EWOULDBLOCK) || (errno == EAGAIN)) {
+				wait(POLLIN);
+			} else {
+				throw libc_error();
+			}
+		}
+	}
+	return result;
+}
+
 size_t socket_descriptor::send(const void* buf, size_t nbyte) {
 	ssize_t count = -1;
 	while (count < 0) {
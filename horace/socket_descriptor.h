@@ -104,6 +104,20 @@ public:
 	 */
 	size_t recvmsg(struct msghdr* message, int flags);
 
+	/** Receive multiple messages from this socket.
+	 * This function will block if a message is not immediately
+	 * available. Otherwise, it returns as many messages as are
+	 * immediately available, up to the given limit, provided that
+	 * the socket is non-blocking.
+	 * @param messages an array of mmsghdr structures for receiving
+	 *  the messages
+	 * @param count the number of mmsghdr structures available
+	 * @param flags a bitwise combination of zero or more MSG_ flags
+	 * @return the number of messages received
+	 */
+	size_t recvmmsg(struct mmsghdr* messages, unsigned int count,
+		int flags);
+
 	/** Send a message from this socket.
 	 * If the requested number of octets cannot be sent immediately
 	 * then this function will block until either that has been done,
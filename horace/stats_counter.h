@@ -0,0 +1,50 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STATS_COUNTER
+#define LIBHOLMES_HORACE_STATS_COUNTER
+
+#include <cstdint>
+#include <atomic>
+
+namespace horace {
+
+/** A class to represent a statistics counter.
+ * A counter may be read by any thread, but must have no more than one
+ * writer at any one time (which is normally achieved by making it part
+ * of a stats_group belonging to a single thread). This allows it to be
+ * updated without any locking or atomic read-modify-write operations.
+ */
+class stats_counter {
+private:
+	/** The current value of this counter. */
+	std::atomic<uint64_t> _value;
+public:
+	/** Construct counter with value of zero. */
+	stats_counter():
+		_value(0) {}
+
+	stats_counter(const stats_counter&) = delete;
+	stats_counter& operator=(const stats_counter&) = delete;
+
+	/** Add to this counter.
+	 * @param count the amount to be added
+	 */
+	void add(uint64_t count = 1) {
+		_value.store(_value.load(std::memory_order_relaxed) + count,
+			std::memory_order_relaxed);
+	}
+
+	/** Get the value of this counter.
+	 * @return the value
+	 */
+	uint64_t value() const {
+		return _value.load(std::memory_order_relaxed);
+	}
+};
+
+} /* namespace horace */
+
+#endif
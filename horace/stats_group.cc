@@ -0,0 +1,113 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <set>
+
+#include "horace/stats_group.h"
+
+namespace horace {
+
+namespace {
+
+/** A structure to hold the process-wide registry of statistics groups. */
+struct stats_registry {
+	/** A mutex to protect the registry. */
+	std::mutex mutex;
+
+	/** The groups which currently exist. */
+	std::set<const stats_group*> groups;
+
+	/** The final counter values from groups which no longer exist,
+	 * indexed by qualified name. */
+	std::map<std::string, uint64_t> counters;
+
+	/** The final histogram content from groups which no longer exist,
+	 * indexed by qualified name. */
+	std::map<std::string, stats_histogram::snapshot> histograms;
+};
+
+/** Get the process-wide registry of statistics groups.
+ * @return the registry
+ */
+stats_registry& registry() {
+	static stats_registry reg;
+	return reg;
+}
+
+} /* anonymous namespace */
+
+stats_group::stats_group(const std::string& name):
+	_name(name) {
+
+	stats_registry& reg = registry();
+	std::lock_guard<std::mutex> lk(reg.mutex);
+	reg.groups.insert(this);
+}
+
+stats_group::~stats_group() {
+	stats_registry& reg = registry();
+	std::lock_guard<std::mutex> lk(reg.mutex);
+	reg.groups.erase(this);
+	for (const auto& [name, counter] : _counters) {
+		reg.counters[_name + "." + name] += counter->value();
+	}
+	for (const auto& [name, hist] : _histograms) {
+		reg.histograms[_name + "." + name] += hist->read();
+	}
+}
+
+stats_counter& stats_group::counter(const std::string& name) {
+	std::lock_guard<std::mutex> lk(_mutex);
+	auto& counter = _counters[name];
+	if (!counter) {
+		counter = std::make_unique<stats_counter>();
+	}
+	return *counter;
+}
+
+stats_histogram& stats_group::histogram(const std::string& name) {
+	std::lock_guard<std::mutex> lk(_mutex);
+	auto& hist = _histograms[name];
+	if (!hist) {
+		hist = std::make_unique<stats_histogram>();
+	}
+	return *hist;
+}
+
+void stats_group::report(std::ostream& out) {
+	std::map<std::string, uint64_t> counters;
+	std::map<std::string, stats_histogram::snapshot> histograms;
+	{
+		stats_registry& reg = registry();
+		std::lock_guard<std::mutex> lk(reg.mutex);
+		counters = reg.counters;
+		histograms = reg.histograms;
+		for (const stats_group* group : reg.groups) {
+			std::lock_guard<std::mutex> glk(group->_mutex);
+			for (const auto& [name, counter] : group->_counters) {
+				counters[group->_name + "." + name] +=
+					counter->value();
+			}
+			for (const auto& [name, hist] : group->_histograms) {
+				histograms[group->_name + "." + name] +=
+					hist->read();
+			}
+		}
+	}
+
+	for (const auto& [name, value] : counters) {
+		out << name << ' ' << value << std::endl;
+	}
+	for (const auto& [name, snap] : histograms) {
+		out << name << ".count " << snap.count() << std::endl;
+		out << name << ".sum " << snap.sum << std::endl;
+		out << name << ".p50 " << snap.quantile(0.5) << std::endl;
+		out << name << ".p90 " << snap.quantile(0.9) << std::endl;
+		out << name << ".p99 " << snap.quantile(0.99) << std::endl;
+		out << name << ".max " << snap.quantile(1.0) << std::endl;
+	}
+}
+
+} /* namespace horace */
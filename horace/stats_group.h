@@ -0,0 +1,91 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STATS_GROUP
+#define LIBHOLMES_HORACE_STATS_GROUP
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include "horace/stats_counter.h"
+#include "horace/stats_histogram.h"
+
+namespace horace {
+
+/** A class to represent a named group of statistics.
+ * Each group is normally owned by a single thread, which is then the
+ * only writer for the counters and histograms within it. All groups
+ * which currently exist are listed in a process-wide registry, from
+ * which they can be reported by any thread.
+ *
+ * When a group is destroyed its values are retained by the registry,
+ * and are added to those of any later group with the same name. This
+ * allows statistics to accumulate across sessions. Similarly, groups
+ * which exist concurrently with the same name are reported as one.
+ */
+class stats_group {
+private:
+	/** A mutex to protect _counters and _histograms. */
+	mutable std::mutex _mutex;
+
+	/** The name of this group. */
+	std::string _name;
+
+	/** The counters in this group, indexed by name. */
+	std::map<std::string, std::unique_ptr<stats_counter>> _counters;
+
+	/** The histograms in this group, indexed by name. */
+	std::map<std::string, std::unique_ptr<stats_histogram>> _histograms;
+public:
+	/** Construct statistics group, and add it to the registry.
+	 * @param name the name of the group
+	 */
+	explicit stats_group(const std::string& name);
+
+	/** Remove statistics group from the registry. */
+	~stats_group();
+
+	stats_group(const stats_group&) = delete;
+	stats_group& operator=(const stats_group&) = delete;
+
+	/** Get the name of this group.
+	 * @return the name
+	 */
+	const std::string& name() const {
+		return _name;
+	}
+
+	/** Get a counter, creating it if it does not already exist.
+	 * The reference returned remains valid for the lifetime of this
+	 * group.
+	 * @param name the name of the counter
+	 * @return the counter
+	 */
+	stats_counter& counter(const std::string& name);
+
+	/** Get a histogram, creating it if it does not already exist.
+	 * The reference returned remains valid for the lifetime of this
+	 * group.
+	 * @param name the name of the histogram
+	 * @return the histogram
+	 */
+	stats_histogram& histogram(const std::string& name);
+
+	/** Report the statistics from all groups.
+	 * Each counter is written on a separate line as a name-value pair,
+	 * with the name qualified by that of the group. Each histogram is
+	 * written as a count, a sum, and upper bounds for the median, the
+	 * 90th and 99th percentiles, and the maximum value.
+	 * @param out the stream to which the report should be written
+	 */
+	static void report(std::ostream& out);
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,61 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include "horace/stats_histogram.h"
+
+namespace horace {
+
+stats_histogram::snapshot::snapshot():
+	buckets{0},
+	sum(0) {}
+
+stats_histogram::snapshot& stats_histogram::snapshot::operator+=(
+	const snapshot& that) {
+
+	for (int i = 0; i != bucket_count; ++i) {
+		buckets[i] += that.buckets[i];
+	}
+	sum += that.sum;
+	return *this;
+}
+
+uint64_t stats_histogram::snapshot::count() const {
+	uint64_t total = 0;
+	for (int i = 0; i != bucket_count; ++i) {
+		total += buckets[i];
+	}
+	return total;
+}
+
+uint64_t stats_histogram::snapshot::quantile(double fraction) const {
+	uint64_t required = fraction * count();
+	uint64_t total = 0;
+	for (int i = 0; i != bucket_count; ++i) {
+		total += buckets[i];
+		if (total && (total >= required)) {
+			return uint64_t(1) << i;
+		}
+	}
+	return 0;
+}
+
+stats_histogram::stats_histogram():
+	_sum(0) {
+
+	for (int i = 0; i != bucket_count; ++i) {
+		_buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+stats_histogram::snapshot stats_histogram::read() const {
+	snapshot snap;
+	for (int i = 0; i != bucket_count; ++i) {
+		snap.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+	}
+	snap.sum = _sum.load(std::memory_order_relaxed);
+	return snap;
+}
+
+} /* namespace horace */
@@ -0,0 +1,95 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STATS_HISTOGRAM
+#define LIBHOLMES_HORACE_STATS_HISTOGRAM
+
+#include <cstdint>
+#include <atomic>
+
+namespace horace {
+
+/** A class to represent a statistics histogram.
+ * Values are recorded in buckets with one bucket for each power of two,
+ * which is sufficiently precise for latencies and sizes while being
+ * cheap enough to update for every record.
+ *
+ * As with stats_counter, a histogram may be read by any thread but must
+ * have no more than one writer at any one time.
+ */
+class stats_histogram {
+public:
+	/** The number of buckets. */
+	static const int bucket_count = 64;
+
+	/** A class to represent the content of a histogram at a given
+	 * point in time. */
+	class snapshot {
+	public:
+		/** The number of values in each bucket. */
+		uint64_t buckets[bucket_count];
+
+		/** The sum of all values. */
+		uint64_t sum;
+
+		/** Construct empty snapshot. */
+		snapshot();
+
+		/** Merge another snapshot into this one.
+		 * @param that the snapshot to be merged
+		 * @return a reference to this
+		 */
+		snapshot& operator+=(const snapshot& that);
+
+		/** Get the number of values recorded.
+		 * @return the number of values
+		 */
+		uint64_t count() const;
+
+		/** Get an upper bound for a given quantile.
+		 * @param fraction the required quantile, between 0 and 1
+		 * @return the power of two which bounds the quantile,
+		 *  or 0 if there are no values
+		 */
+		uint64_t quantile(double fraction) const;
+	};
+private:
+	/** The number of values in each bucket, indexed by the base-2
+	 * logarithm of the value rounded up. */
+	std::atomic<uint64_t> _buckets[bucket_count];
+
+	/** The sum of all values. */
+	std::atomic<uint64_t> _sum;
+public:
+	/** Construct empty histogram. */
+	stats_histogram();
+
+	stats_histogram(const stats_histogram&) = delete;
+	stats_histogram& operator=(const stats_histogram&) = delete;
+
+	/** Record a value.
+	 * @param value the value to be recorded
+	 */
+	void add(uint64_t value) {
+		int bucket = (value > 1) ? (64 - __builtin_clzll(value - 1)) : 0;
+		if (bucket >= bucket_count) {
+			bucket = bucket_count - 1;
+		}
+		std::atomic<uint64_t>& count = _buckets[bucket];
+		count.store(count.load(std::memory_order_relaxed) + 1,
+			std::memory_order_relaxed);
+		_sum.store(_sum.load(std::memory_order_relaxed) + value,
+			std::memory_order_relaxed);
+	}
+
+	/** Take a snapshot of this histogram.
+	 * @return the snapshot
+	 */
+	snapshot read() const;
+};
+
+} /* namespace horace */
+
+#endif
@@ -0,0 +1,114 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <cstdio>
+#include <sstream>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "horace/libc_error.h"
+#include "horace/logger.h"
+#include "horace/log_message.h"
+#include "horace/stats_group.h"
+#include "horace/stats_server.h"
+
+namespace horace {
+
+stats_server::stats_server(const std::string& pathname):
+	_pathname(pathname),
+	_sock(AF_UNIX, SOCK_STREAM, 0) {
+
+	// Construct address.
+	struct sockaddr_un addr = {0};
+	addr.sun_family = AF_UNIX;
+	if (snprintf(addr.sun_path, sizeof(addr.sun_path), "%s",
+		pathname.c_str()) >= sizeof(addr.sun_path)) {
+
+		throw libc_error(ENAMETOOLONG);
+	}
+
+	// If a socket already exists with the requested pathname, but
+	// nothing is listening on it, then it is presumed to have been
+	// left by an earlier instance and is removed.
+	struct stat statbuf;
+	if ((lstat(pathname.c_str(), &statbuf) == 0) &&
+		S_ISSOCK(statbuf.st_mode)) {
+
+		socket_descriptor probe(AF_UNIX, SOCK_STREAM, 0);
+		if (::connect(probe, reinterpret_cast<struct sockaddr*>(&addr),
+			sizeof(addr)) == -1) {
+
+			if (errno == ECONNREFUSED) {
+				unlink(pathname.c_str());
+			}
+		}
+	}
+
+	_sock.bind(addr);
+	_sock.listen();
+
+	int pipefd[2];
+	if (pipe(pipefd) == -1) {
+		throw libc_error();
+	}
+	_stop_rd = file_descriptor(pipefd[0]);
+	_stop_wr = file_descriptor(pipefd[1]);
+
+	_thread = std::thread(&stats_server::_run, this);
+
+	if (log->enabled(logger::log_info)) {
+		log_message msg(*log, logger::log_info);
+		msg << "serving statistics on " << _pathname;
+	}
+}
+
+stats_server::~stats_server() {
+	char c = 0;
+	while ((::write(_stop_wr, &c, 1) == -1) && (errno == EINTR)) {}
+	_thread.join();
+	unlink(_pathname.c_str());
+}
+
+void stats_server::_run() {
+	struct pollfd fds[2] = {{0}};
+	fds[0].fd = _stop_rd;
+	fds[0].events = POLLIN;
+	fds[1].fd = _sock;
+	fds[1].events = POLLIN;
+
+	while (true) {
+		if (::poll(fds, 2, -1) == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		if (fds[0].revents) {
+			break;
+		}
+		if (!(fds[1].revents & POLLIN)) {
+			continue;
+		}
+
+		socket_descriptor conn(::accept(_sock, 0, 0));
+		if (!conn) {
+			continue;
+		}
+
+		// The report is small enough to fit within the socket
+		// buffer, so it is sent without blocking in order that
+		// an unresponsive client cannot stall the server.
+		std::ostringstream out;
+		stats_group::report(out);
+		std::string report = out.str();
+		::send(conn, report.data(), report.length(),
+			MSG_DONTWAIT|MSG_NOSIGNAL);
+	}
+}
+
+} /* namespace horace */
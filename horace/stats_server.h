@@ -0,0 +1,61 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STATS_SERVER
+#define LIBHOLMES_HORACE_STATS_SERVER
+
+#include <string>
+#include <thread>
+
+#include "horace/file_descriptor.h"
+#include "horace/socket_descriptor.h"
+
+namespace horace {
+
+/** A class for serving statistics through a UNIX-domain socket.
+ * Each connection accepted by the server is sent a report of all
+ * statistics groups (in the format written by stats_group::report),
+ * then closed. This allows the statistics to be scraped using a tool
+ * such as socat, without otherwise interacting with the process.
+ *
+ * The server runs in its own thread. It does not respond to the
+ * process-wide termination flag (since that is also used to restart
+ * capture), and must instead be stopped by destroying it.
+ */
+class stats_server {
+private:
+	/** The pathname to which the socket is bound. */
+	std::string _pathname;
+
+	/** The listening socket. */
+	socket_descriptor _sock;
+
+	/** The read end of a pipe for stopping the server. */
+	file_descriptor _stop_rd;
+
+	/** The write end of a pipe for stopping the server. */
+	file_descriptor _stop_wr;
+
+	/** A thread for accepting connections. */
+	std::thread _thread;
+
+	/** Accept connections until asked to stop. */
+	void _run();
+public:
+	/** Construct statistics server.
+	 * @param pathname the pathname to which the socket should be bound
+	 */
+	explicit stats_server(const std::string& pathname);
+
+	/** Stop statistics server. */
+	~stats_server();
+
+	stats_server(const stats_server&) = delete;
+	stats_server& operator=(const stats_server&) = delete;
+};
+
+} /* namespace horace */
+
+#endif
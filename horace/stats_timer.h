@@ -0,0 +1,47 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STATS_TIMER
+#define LIBHOLMES_HORACE_STATS_TIMER
+
+#include <chrono>
+
+#include "horace/stats_histogram.h"
+
+namespace horace {
+
+/** A class for recording the duration of a scope in a histogram.
+ * The time elapsed between construction and destruction of the timer
+ * is recorded in nanoseconds.
+ */
+class stats_timer {
+private:
+	/** The histogram in which to record the duration. */
+	stats_histogram* _hist;
+
+	/** The time at which the timer was constructed. */
+	std::chrono::steady_clock::time_point _start;
+public:
+	/** Start timer.
+	 * @param hist the histogram in which to record the duration
+	 */
+	explicit stats_timer(stats_histogram& hist):
+		_hist(&hist),
+		_start(std::chrono::steady_clock::now()) {}
+
+	stats_timer(const stats_timer&) = delete;
+	stats_timer& operator=(const stats_timer&) = delete;
+
+	/** Stop timer and record duration. */
+	~stats_timer() {
+		auto elapsed = std::chrono::steady_clock::now() - _start;
+		_hist->add(std::chrono::duration_cast<
+			std::chrono::nanoseconds>(elapsed).count());
+	}
+};
+
+} /* namespace horace */
+
+#endif
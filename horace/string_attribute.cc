@@ -51,4 +51,8 @@ void string_attribute::write(octet_writer& out) const {
 	out.write_string(_content);
 }
 
+void string_attribute::write_content(octet_writer& out) const {
+	out.write_string(_content);
+}
+
 } /* namespace horace */
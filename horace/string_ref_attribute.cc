@@ -0,0 +1,54 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <iostream>
+
+#include "horace/octet_writer.h"
+#include "horace/unsigned_base128_integer.h"
+#include "horace/signed_base128_integer.h"
+#include "horace/string_ref_attribute.h"
+
+namespace horace {
+
+string_ref_attribute::string_ref_attribute(int attrid,
+	std::string_view content):
+	attribute(attrid),
+	_content(content) {}
+
+bool string_ref_attribute::operator==(const attribute& that) const {
+	if (this->attrid() != that.attrid()) {
+		return false;
+	}
+	const string_ref_attribute* _that =
+		dynamic_cast<const string_ref_attribute*>(&that);
+	if (!_that) {
+		return false;
+	}
+	return (_content == _that->_content);
+}
+
+size_t string_ref_attribute::length() const {
+	return _content.length();
+}
+
+std::unique_ptr<attribute> string_ref_attribute::clone() const {
+	return std::make_unique<string_ref_attribute>(attrid(), _content);
+}
+
+void string_ref_attribute::write(std::ostream& out) const {
+	out << "attr" << attrid() << "(" << _content << ")";
+}
+
+void string_ref_attribute::write(octet_writer& out) const {
+	signed_base128_integer(attrid()).write(out);
+	unsigned_base128_integer(length()).write(out);
+	out.write(_content.data(), _content.length());
+}
+
+void string_ref_attribute::write_content(octet_writer& out) const {
+	out.write(_content.data(), _content.length());
+}
+
+} /* namespace horace */
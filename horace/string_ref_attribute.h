@@ -0,0 +1,53 @@
+// This file is part of libholmes.
+// Copyright 2020 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_STRING_REF_ATTRIBUTE
+#define LIBHOLMES_HORACE_STRING_REF_ATTRIBUTE
+
+#include <string_view>
+
+#include "horace/attribute.h"
+
+namespace horace {
+
+/** A class to represent an attribute referring to a character string.
+ * This class allows an attribute to refer to a pre-existing character
+ * string without making a copy of it. It is encoded in the same way as
+ * a string_attribute, and is decoded as one.
+ */
+class string_ref_attribute:
+	public attribute {
+private:
+	/** The attribute content. */
+	std::string_view _content;
+public:
+	/** Construct string attribute.
+	 * The content is not copied, and must remain valid for the
+	 * lifetime of this attribute and of any record buffer derived
+	 * from it.
+	 * @param attrid the attribute ID
+	 * @param content the required content
+	 */
+	string_ref_attribute(int attrid, std::string_view content);
+
+	virtual bool operator==(const attribute& that) const;
+
+	/** Get attribute content.
+	 * @return the content
+	 */
+	std::string_view content() const {
+		return _content;
+	}
+
+	virtual size_t length() const;
+	virtual std::unique_ptr<attribute> clone() const;
+	virtual void write(std::ostream& out) const;
+	virtual void write(octet_writer& out) const;
+	virtual void write_content(octet_writer& out) const;
+};
+
+} /* namespace horace */
+
+#endif
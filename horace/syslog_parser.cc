@@ -8,9 +8,8 @@
 #include <string>
 
 #include "horace/log_record_builder.h"
-
-#include "syslog_error.h"
-#include "syslog_parser.h"
+#include "horace/syslog_error.h"
+#include "horace/syslog_parser.h"
 
 namespace horace {
 
@@ -115,7 +114,22 @@ unsigned int syslog_parser::read_version() {
 	}
 }
 
-std::string syslog_parser::read_token() {
+bool syslog_parser::has_version() const {
+	// This must match the conditions imposed by read_version.
+	size_t index = _index;
+	while ((index != _length) && (index - _index <= 3) &&
+		isdigit(_content[index])) {
+
+		index += 1;
+	}
+	size_t count = index - _index;
+	if ((count == 0) || (count > 3) || (_content[_index] == '0')) {
+		return false;
+	}
+	return (index == _length) || (_content[index] == ' ');
+}
+
+std::string_view syslog_parser::read_token() {
 	size_t restore = _index;
 	try {
 		size_t base = _index;
@@ -125,7 +139,7 @@ std::string syslog_parser::read_token() {
 		if (_index == base) {
 			throw syslog_error("token expected");
 		}
-		std::string token(_content + base, _index - base);
+		std::string_view token(_content + base, _index - base);
 		if ((_index != _length) && (_content[_index++] != ' ')) {
 			throw syslog_error("' ' expected");
 		}
@@ -136,7 +150,7 @@ std::string syslog_parser::read_token() {
 	}
 }
 
-std::string syslog_parser::read_rfc3164_timestamp() {
+std::string_view syslog_parser::read_rfc3164_timestamp() {
 	size_t restore = _index;
 	try {
 		if (_index + 15 > _length) {
@@ -188,7 +202,7 @@ std::string syslog_parser::read_rfc3164_timestamp() {
 			throw syslog_error("invalid second");
 		}
 
-		std::string timestamp(_content + restore, _index - restore);
+		std::string_view timestamp(_content + restore, _index - restore);
 		if ((_index != _length) && (_content[_index++] != ' ')) {
 			throw syslog_error("' ' expected");
 		}
@@ -199,7 +213,7 @@ std::string syslog_parser::read_rfc3164_timestamp() {
 	}
 }
 
-std::string syslog_parser::read_rfc5424_structured_data() {
+std::string_view syslog_parser::read_rfc5424_structured_data() {
 	size_t restore = _index;
 	try {
 		if ((_index != _length) && (_content[_index] == '-')) {
@@ -207,34 +221,38 @@ std::string syslog_parser::read_rfc5424_structured_data() {
 			if ((_index != _length) && (_content[_index++] != ' ')) {
 				throw syslog_error("' ' expected");
 			}
-			return "-";
+			return std::string_view(_content + restore, 1);
 		}
 
-		if ((_index == _length) || (_content[_index++] != '[')) {
-			throw syslog_error("'[' expected");
-		}
+		// There may be any number of SD-ELEMENTs (but at least one),
+		// with no separator between them.
+		do {
+			if ((_index == _length) || (_content[_index++] != '[')) {
+				throw syslog_error("'[' expected");
+			}
 
-		bool quote = false;
-		while ((_index != _length) && (_content[_index] != ']')) {
-			char ch = _content[_index++];
-			if (ch == '"') {
-				quote = !quote;
-			} else if (ch == '\\') {
-				if (quote) {
-					if (_index == _length) {
-						throw syslog_error("']' expected (2)");
+			bool quote = false;
+			while ((_index != _length) && (_content[_index] != ']')) {
+				char ch = _content[_index++];
+				if (ch == '"') {
+					quote = !quote;
+				} else if (ch == '\\') {
+					if (quote) {
+						if (_index == _length) {
+							throw syslog_error("']' expected (2)");
+						}
+						++_index;
 					}
-					++_index;
 				}
 			}
-		}
-		if (quote) {
-			throw syslog_error("'\"' expected");
-		}
-		if ((_index == _length) || (_content[_index++] != ']')) {
-			throw syslog_error("']' expected *3(");
-		}
-		std::string data(_content + restore, _index - restore);
+			if (quote) {
+				throw syslog_error("'\"' expected");
+			}
+			if ((_index == _length) || (_content[_index++] != ']')) {
+				throw syslog_error("']' expected *3(");
+			}
+		} while ((_index != _length) && (_content[_index] == '['));
+		std::string_view data(_content + restore, _index - restore);
 		if ((_index != _length) && (_content[_index++] != ' ')) {
 			throw syslog_error("' ' expected");
 		}
@@ -245,8 +263,8 @@ std::string syslog_parser::read_rfc5424_structured_data() {
 	}
 }
 
-std::string syslog_parser::read_remaining() {
-	std::string msg(_content + _index, _length - _index);
+std::string_view syslog_parser::read_remaining() {
+	std::string_view msg(_content + _index, _length - _index);
 	_index = _length;
 	return msg;
 }
@@ -270,31 +288,29 @@ void syslog_parser::read_message(log_record_builder& builder) {
 		// Since a version number number of 0 is not allowed,
 		// use that to represent the absence of a version number.
 		unsigned int version = 0;
-		try {
+		if (has_version()) {
 			version = read_version();
-		} catch (syslog_error&) {
-			_index = restore;
 		}
 
 		if (version == 0) {
 			// No version: assume RFC 3164.
 			// Parse the timestamp.
-			std::string timestamp = read_rfc3164_timestamp();
+			std::string_view timestamp = read_rfc3164_timestamp();
 			builder.add_timestamp(timestamp);
 			restore = _index;
 
 			// Parse the hostname.
-			std::string hostname = read_token();
+			std::string_view hostname = read_token();
 			builder.add_hostname(hostname);
 			restore = _index;
 		} else if (version == 1) {
 			// Version 1: RFC 5424
 			// Parse the header (all or nothing).
-			std::string timestamp = read_token();
-			std::string hostname = read_token();
-			std::string appname = read_token();
-			std::string procid = read_token();
-			std::string msgid = read_token();
+			std::string_view timestamp = read_token();
+			std::string_view hostname = read_token();
+			std::string_view appname = read_token();
+			std::string_view procid = read_token();
+			std::string_view msgid = read_token();
 			builder.add_version(version);
 			builder.add_timestamp(timestamp);
 			builder.add_hostname(hostname);
@@ -306,7 +322,7 @@ void syslog_parser::read_message(log_record_builder& builder) {
 			// Parse the structured data.
 			// (This ought to be present, but is more likely to
 			// be malformed.)
-			std::string sd = read_rfc5424_structured_data();
+			std::string_view sd = read_rfc5424_structured_data();
 			builder.add_structured_data(sd);
 			restore = _index;
 		}
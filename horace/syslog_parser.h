@@ -6,6 +6,8 @@
 #ifndef LIBHOLMES_HORACE_SYSLOG_PARSER
 #define LIBHOLMES_HORACE_SYSLOG_PARSER
 
+#include <string_view>
+
 namespace horace {
 
 class log_record_builder;
@@ -13,6 +15,9 @@ class log_record_builder;
 /** A class for parsing syslog messages.
  * In all cases, if a requested component cannot be parsed then a
  * syslog_error is thrown and the state of the parser left unchanged.
+ *
+ * Components are returned as views into the unparsed message content,
+ * without copying, so remain valid only for as long as that content.
  */
 class syslog_parser {
 private:
@@ -55,6 +60,13 @@ public:
 	 */
 	unsigned int read_version();
 
+	/** Test whether a version number can be read.
+	 * This allows the presence of a version number to be detected
+	 * without the cost of throwing an exception if there is none.
+	 * @return true if read_version would succeed, otherwise false
+	 */
+	bool has_version() const;
+
 	/** Read a space character. */
 	void read_space();
 
@@ -63,23 +75,23 @@ public:
 	 * characters, not including any space characters.
 	 * @return the token
 	 */
-	std::string read_token();
+	std::string_view read_token();
 
 	/** Read an RFC 3164 timestamp.
 	 * This is required to be of the form "Mmm dd hh:mm:ss".
 	 * @return the timestamp
 	 */
-	std::string read_rfc3164_timestamp();
+	std::string_view read_rfc3164_timestamp();
 
 	/** Read an RFC 5424 STRUCTURED-DATA field.
 	 * @return the structured data field content
 	 */
-	std::string read_rfc5424_structured_data();
+	std::string_view read_rfc5424_structured_data();
 
 	/** Read the remainder of the message.
 	 * @return the remainder of the message
 	 */
-	std::string read_remaining();
+	std::string_view read_remaining();
 
 	/** Read full message, pass to log record builder.
 	 * @param builder the log record builder
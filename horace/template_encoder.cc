@@ -0,0 +1,175 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <iterator>
+
+#include "horace/octet_writer.h"
+#include "horace/unsigned_base128_integer.h"
+#include "horace/signed_base128_integer.h"
+#include "horace/signed_integer_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/template_encoder.h"
+
+namespace horace {
+
+namespace {
+
+/** The largest channel ID for which a template will be declared.
+ * This matches the largest channel ID which may be defined. */
+const int max_channel_id = 0xffff;
+
+/** Test whether two attribute IDs should share a template slot when
+ * they occur in the same record. This is true for any repeated ID
+ * other than dict_ref, since each instance of dict_ref stands in for
+ * a different attribute and is therefore given a slot of its own.
+ * @param lhs the first attribute ID
+ * @param rhs the second attribute ID
+ * @return true if the IDs should share a slot, otherwise false
+ */
+bool same_slot(int lhs, int rhs) {
+	return (lhs == rhs) && (lhs != attrid_dict_ref);
+}
+
+} /* anonymous namespace */
+
+void template_encoder::templated_record::write(octet_writer& out) const {
+	out.write(_encoding.data(), _encoding.length());
+}
+
+void template_encoder::_declare(const std::vector<int>& tmpl,
+	const record& rec) {
+
+	// The new template is the union of the existing template and the
+	// attribute IDs of the current record, so that records which
+	// vary in which attributes they contain do not cause templates
+	// to be declared repeatedly. Both are in canonical order, and
+	// where dict_ref occurs more than once the union retains as many
+	// instances as either contains.
+	_recids.clear();
+	for (const attribute* attr : rec.attributes()) {
+		_recids.push_back(attr->attrid());
+	}
+	std::sort(_recids.begin(), _recids.end(), attribute_list::precedes);
+	_recids.erase(std::unique(_recids.begin(), _recids.end(), same_slot),
+		_recids.end());
+	_attrids.clear();
+	std::set_union(tmpl.begin(), tmpl.end(),
+		_recids.begin(), _recids.end(),
+		std::back_inserter(_attrids), attribute_list::precedes);
+
+	attribute_list subattrs;
+	for (int attrid : _attrids) {
+		subattrs.insert(std::make_unique<signed_integer_attribute>(
+			attrid_attr_id, attrid));
+	}
+	_template_attr.emplace(attrid_record_template, std::move(subattrs));
+}
+
+const record& template_encoder::encode(const record& rec) {
+	if (rec.channel_id() == channel_session) {
+		_templates.clear();
+		return rec;
+	}
+	if (!rec.is_event() || rec.channel_id() > max_channel_id) {
+		return rec;
+	}
+
+	int channel = rec.channel_id();
+	if (static_cast<size_t>(channel) >= _templates.size()) {
+		_templates.resize(channel + 1);
+	}
+	const std::vector<int>& tmpl = _templates[channel];
+
+	// Allocate attributes to slots. Both the attributes and the
+	// template are in canonical order, so each slot can be found by
+	// searching forward from the one previously allocated. Where
+	// an attribute ID occurs more than once, only the first instance
+	// is allocated to a slot, except that each dict_ref is allocated
+	// to a slot of its own if there are enough of them.
+	const auto& attrs = rec.attributes().attributes();
+	_slots.assign(tmpl.size(), -1);
+	_extras.clear();
+	bool fits = true;
+	auto next = tmpl.begin();
+	for (size_t i = 0; i != attrs.size(); ++i) {
+		int attrid = attrs[i]->attrid();
+		auto f = std::find(next, tmpl.end(), attrid);
+		if (f != tmpl.end()) {
+			_slots[f - tmpl.begin()] = i;
+			next = f + 1;
+		} else {
+			_extras.push_back(i);
+			if ((attrid == attrid_dict_ref) ||
+				(std::find(tmpl.begin(), tmpl.end(), attrid) ==
+				tmpl.end())) {
+
+				fits = false;
+			}
+		}
+	}
+
+	// Until a template has been declared, records are written in
+	// the usual form.
+	bool declare = !fits;
+	if (tmpl.empty() && !declare) {
+		return rec;
+	}
+	if (declare) {
+		_declare(tmpl, rec);
+	}
+
+	// Calculate the length of the templated encoding.
+	size_t len = 0;
+	for (int index : _slots) {
+		if (index < 0) {
+			len += 1;
+		} else {
+			size_t attr_len = attrs[index]->length();
+			len += unsigned_base128_integer(attr_len + 1).length() +
+				attr_len;
+		}
+	}
+	for (int index : _extras) {
+		size_t attr_len = attrs[index]->length();
+		len += signed_base128_integer(attrs[index]->attrid()).length() +
+			unsigned_base128_integer(attr_len).length() + attr_len;
+	}
+	if (declare) {
+		size_t attr_len = _template_attr->length();
+		len += signed_base128_integer(attrid_record_template).length() +
+			unsigned_base128_integer(attr_len).length() + attr_len;
+	}
+	signed_base128_integer channel_field(channel);
+	unsigned_base128_integer len_field(len);
+	size_t full_len = channel_field.length() + len_field.length() + len;
+
+	// Write the templated encoding. Slots are written without the
+	// attribute ID, so only the content of each attribute follows
+	// the slot header.
+	char* buf = _trec.assign(channel, full_len);
+	octet_writer out(buf, full_len);
+	channel_field.write(out);
+	len_field.write(out);
+	for (int index : _slots) {
+		if (index < 0) {
+			out.write(char(0));
+			continue;
+		}
+		const attribute& attr = *attrs[index];
+		unsigned_base128_integer(attr.length() + 1).write(out);
+		attr.write_content(out);
+	}
+	for (int index : _extras) {
+		attrs[index]->write(out);
+	}
+	if (declare) {
+		_template_attr->write(out);
+		_templates[channel].swap(_attrids);
+	}
+	return _trec;
+}
+
+} /* namespace horace */
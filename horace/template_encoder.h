@@ -0,0 +1,130 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#ifndef LIBHOLMES_HORACE_TEMPLATE_ENCODER
+#define LIBHOLMES_HORACE_TEMPLATE_ENCODER
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "horace/compound_attribute.h"
+#include "horace/record.h"
+
+namespace horace {
+
+/** A class for encoding a stream of records using record templates.
+ * A record template lists the attribute IDs which are expected to
+ * occur in the event records of a given channel, in canonical order.
+ * Once a channel has a template, each of its records begins with one
+ * slot per attribute ID in the template. Slots are encoded without
+ * the attribute ID: each consists of the content length plus one
+ * (or zero if the attribute is absent), followed by the content. Any
+ * attributes which do not fit the template follow in the usual form.
+ *
+ * Templates are derived from the records which are encoded. When a
+ * record contains an attribute ID which is not in the template for its
+ * channel, a new template is declared by adding a record_template
+ * attribute to that record. It takes effect from the next record on
+ * the same channel. Each session record clears all templates, so that
+ * a stream can be decoded starting from any session record.
+ *
+ * A repeated attribute ID normally has only one slot, with any further
+ * instances following the slots. The exception is dict_ref, which
+ * stands in for a different attribute each time it occurs in a record,
+ * so a template has as many dict_ref slots as there have been dict_ref
+ * attributes in any one record.
+ *
+ * Records are reconstructed exactly when they are read, therefore
+ * hashes and signatures are not affected.
+ */
+class template_encoder {
+private:
+	/** A class to represent a record which has been encoded using a
+	 * template. Only the channel ID and encoding are retained. */
+	class templated_record:
+		public record {
+	private:
+		/** The channel ID. */
+		int _channel;
+
+		/** The encoded record. */
+		std::string _encoding;
+	public:
+		/** Construct empty templated record. */
+		templated_record():
+			_channel(0) {}
+
+		/** Get a buffer for the encoded record.
+		 * @param channel the channel ID
+		 * @param length the length of the encoded record, in octets
+		 * @return the buffer, to be filled by the caller
+		 */
+		char* assign(int channel, size_t length) {
+			_channel = channel;
+			_encoding.resize(length);
+			return _encoding.data();
+		}
+
+		virtual int channel_id() const {
+			return _channel;
+		}
+
+		virtual size_t length() const {
+			return _encoding.length();
+		}
+
+		virtual void write(octet_writer& out) const;
+	};
+
+	/** The record templates, indexed by channel ID.
+	 * An empty template indicates that the channel does not have
+	 * one. */
+	std::vector<std::vector<int>> _templates;
+
+	/** The index of the attribute allocated to each slot of the
+	 * template, or -1 if absent. */
+	std::vector<int> _slots;
+
+	/** The indices of the attributes which do not fit the template. */
+	std::vector<int> _extras;
+
+	/** The attribute IDs of the current record, when declaring a new
+	 * template. */
+	std::vector<int> _recids;
+
+	/** The attribute IDs for a new template. */
+	std::vector<int> _attrids;
+
+	/** The record_template attribute for a new template, if any. */
+	std::optional<compound_attribute> _template_attr;
+
+	/** The encoded record. */
+	templated_record _trec;
+
+	/** Declare a new template for a channel.
+	 * This takes effect after the current record has been encoded.
+	 * @param tmpl the existing template
+	 * @param rec the record which did not fit the existing template
+	 */
+	void _declare(const std::vector<int>& tmpl, const record& rec);
+public:
+	/** Construct template encoder. */
+	template_encoder() = default;
+
+	template_encoder(const template_encoder&) = delete;
+	template_encoder& operator=(const template_encoder&) = delete;
+
+	/** Encode a record.
+	 * The result remains valid until this function is next called.
+	 * @param rec the record to be encoded
+	 * @return the encoded record
+	 */
+	const record& encode(const record& rec);
+};
+
+} /* namespace horace */
+
+#endif
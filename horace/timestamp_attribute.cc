@@ -109,4 +109,10 @@ void timestamp_attribute::write(octet_writer& out) const {
 	out.write_unsigned(_content.tv_nsec, 4);
 }
 
+void timestamp_attribute::write_content(octet_writer& out) const {
+	int len = length();
+	out.write_unsigned(_content.tv_sec, len - 4);
+	out.write_unsigned(_content.tv_nsec, 4);
+}
+
 } /* namespace horace */
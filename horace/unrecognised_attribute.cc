@@ -74,4 +74,8 @@ void unrecognised_attribute::write(octet_writer& out) const {
 	out.write(_content.get(), _length);
 }
 
+void unrecognised_attribute::write_content(octet_writer& out) const {
+	out.write(_content.get(), _length);
+}
+
 } /* namespace horace */
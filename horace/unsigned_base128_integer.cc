@@ -16,9 +16,10 @@ unsigned_base128_integer::unsigned_base128_integer(uint64_t value):
 	_length(1) {
 
 	// One encoded octet for every 7 unencoded bits, but with a
-	// minimum length of 1 octet.
+	// minimum length of 1 octet. (The shift count must be checked
+	// explicitly, because shifting by 64 or more bits is undefined.)
 	unsigned int size = 7;
-	while ((_value >> size) != 0) {
+	while ((size < 64) && ((_value >> size) != 0)) {
 		size += 7;
 		_length += 1;
 	}
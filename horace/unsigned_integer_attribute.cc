@@ -68,4 +68,8 @@ void unsigned_integer_attribute::write(octet_writer& out) const {
 	out.write_unsigned(_content, len);
 }
 
+void unsigned_integer_attribute::write_content(octet_writer& out) const {
+	out.write_unsigned(_content, length());
+}
+
 } /* namespace horace */
@@ -15,6 +15,8 @@
 #include "horace/logger.h"
 #include "horace/log_message.h"
 #include "horace/stderr_logger.h"
+#include "horace/async_logger.h"
+#include "horace/stats_server.h"
 #include "horace/signal_set.h"
 #include "horace/terminate_flag.h"
 #include "horace/hostname.h"
@@ -38,6 +40,9 @@
 
 using namespace horace;
 
+/** The interval at which buffered records are flushed, in milliseconds. */
+const int flush_interval = 100;
+
 /** Print help text.
  * @param out the ostream to which the help text should be written
  */
@@ -53,6 +58,10 @@ void write_help(std::ostream& out) {
 	out << "  -D  hash messages with given digest function" << std::endl;
 	out << "  -k  sign messages using key in given file" << std::endl;
 	out << "  -R  set minimum time in milliseconds between signed events" << std::endl;
+	out << "  -M  sign batches of up to given number of events as Merkle trees" << std::endl;
+	out << "  -B  set size of backlog in octets" << std::endl;
+	out << "  -O  spill backlog to given directory when full" << std::endl;
+	out << "  -s  serve statistics on UNIX domain socket" << std::endl;
 	out << "  -v  increase verbosity of log messages" << std::endl;
 }
 
@@ -70,14 +79,21 @@ int main2(int argc, char* argv[]) {
 	const char* hashfn_name = 0;
 	const char* keyfile_pathname = 0;
 	long sigdelay = 0;
+	long long sigbatch = 0;
 	std::string time_system = tsd.time_system();
 	address_filter addrfilt;
 	int severity = logger::log_warning;
+	const char* stats_pathname = 0;
+	long long backlog = new_session_writer::default_backlog;
+	std::string spilldir;
 
 	// Parse command line options.
 	int opt;
-	while ((opt = getopt(argc, argv, "+D:hk:R:S:T:vx:")) != -1) {
+	while ((opt = getopt(argc, argv, "+B:D:hk:M:O:R:s:S:T:vx:")) != -1) {
 		switch (opt) {
+		case 'B':
+			backlog = std::stoll(optarg);
+			break;
 		case 'D':
 			hashfn_name = optarg;
 			break;
@@ -87,9 +103,18 @@ int main2(int argc, char* argv[]) {
 		case 'k':
 			keyfile_pathname = optarg;
 			break;
+		case 'M':
+			sigbatch = std::stoll(optarg);
+			break;
+		case 'O':
+			spilldir = std::string(optarg);
+			break;
 		case 'R':
 			sigdelay = std::stol(optarg);
 			break;
+		case 's':
+			stats_pathname = optarg;
+			break;
 		case 'S':
 			srcid = std::string(optarg);
 			break;
@@ -113,8 +138,24 @@ int main2(int argc, char* argv[]) {
 		}
 	}
 
+	if (backlog < 0) {
+		std::cerr << "Backlog size must be non-negative." << std::endl;
+		exit(1);
+	}
+	if (sigbatch < 0) {
+		std::cerr << "Signature batch size must be non-negative."
+			<< std::endl;
+		exit(1);
+	}
+	if (sigbatch && !(hashfn_name && keyfile_pathname)) {
+		std::cerr << "Signature batches require both a hash function"
+			" and a keyfile." << std::endl;
+		exit(1);
+	}
+
 	// Initialise logger.
-	log = std::make_unique<stderr_logger>();
+	log = std::make_unique<async_logger>(
+		std::make_unique<stderr_logger>());
 	log->severity(severity);
 
 	// Select hash function.
@@ -154,97 +195,92 @@ int main2(int argc, char* argv[]) {
 	std::unique_ptr<endpoint> dst_ep = std::move(endpoints.back());
 	endpoints.pop_back();
 
-	while (true) {
-		// Make a new_session_writer for destination endpoint.
-		session_builder sb(vsrcid, time_system);
-		new_session_writer dst(*dst_ep, sb, vsrcid, hashfn.get());
-
-		if (!dst.writable()) {
-			if (log->enabled(logger::log_warning)) {
-				log_message msg(*log, logger::log_warning);
-				msg << "destination endpoint not ready (will retry)";
-			}
-			while (!dst.writable()) {
-				int raised = masked_signals.milliwait(1000);
-				if (raised != -1) {
-					std::cerr << strsignal(raised) << std::endl;
-					throw terminate_exception();
-				}
-			}
-		}
+	// Start statistics server if one has been requested.
+	std::unique_ptr<stats_server> stats_srv;
+	if (stats_pathname) {
+		stats_srv = std::make_unique<stats_server>(stats_pathname);
+	}
 
-		// Start a leap second monitor.
-		// This must be done before the event sources are created,
-		// so that they can register themselves with it.
-		lsmonitor = std::make_unique<leap_second_monitor>();
+	// Make a new_session_writer for destination endpoint.
+	session_builder sb(vsrcid, time_system);
+	new_session_writer dst(*dst_ep, sb, vsrcid, hashfn.get(),
+		backlog, spilldir);
 
-		// Attach an event signer to the new session writer if a
-		// keyfile was supplied.
-		std::unique_ptr<event_signer> signer;
-		if (kp) {
-			signer = std::make_unique<event_signer>(
-				dst, *kp, sigdelay);
-			signer->build_session(sb);
-			dst.attach_signer(*signer);
+	if (!dst.writable()) {
+		if (log->enabled(logger::log_warning)) {
+			log_message msg(*log, logger::log_warning);
+			msg << "destination endpoint not ready (will retry)";
 		}
-
-		// Make an event_source for each source endpoint.
-		// While doing this, attach the address filter if there
-		// is one.
-		std::vector<std::unique_ptr<event_source>> sources;
-		for (const auto& src_ep : endpoints) {
-			std::unique_ptr<event_source> src =
-				std::make_unique<event_source>(
-				*src_ep, dst, sb);
-			if (!addrfilt.empty()) {
-				src->attach(addrfilt);
+		while (!dst.writable()) {
+			int raised = masked_signals.milliwait(1000);
+			if (raised != -1) {
+				std::cerr << strsignal(raised) << std::endl;
+				throw terminate_exception();
 			}
-			sources.push_back(std::move(src));
 		}
+	}
 
-		// Start the session.
-		std::unique_ptr<record> srec = sb.build();
-		dst.begin_session(*srec);
+	// Start a leap second monitor.
+	// This must be done before the event sources are created,
+	// so that they can register themselves with it.
+	lsmonitor = std::make_unique<leap_second_monitor>();
 
-		// Start capturing events.
-		for (const auto& src : sources) {
-			src->start();
+	// Attach an event signer to the new session writer if a
+	// keyfile was supplied.
+	std::unique_ptr<event_signer> signer;
+	if (kp) {
+		signer = std::make_unique<event_signer>(
+			dst, *kp, sigdelay, hashfn.get(), sigbatch);
+		signer->build_session(sb);
+		dst.attach_signer(*signer);
+	}
+
+	// Make an event_source for each source endpoint.
+	// While doing this, attach the address filter if there
+	// is one.
+	std::vector<std::unique_ptr<event_source>> sources;
+	for (const auto& src_ep : endpoints) {
+		std::unique_ptr<event_source> src =
+			std::make_unique<event_source>(
+			*src_ep, dst, sb);
+		if (!addrfilt.empty()) {
+			src->attach(addrfilt);
 		}
+		sources.push_back(std::move(src));
+	}
 
-		// Wait for signal to be raised.
-		int raised = masked_signals.wait();
+	// Start the session.
+	std::unique_ptr<record> srec = sb.build();
+	dst.begin_session(*srec);
 
-		// Stop listening and exit.
-		if (raised == SIGALRM) {
-			if (log->enabled(logger::log_warning)) {
-				log_message msg(*log, logger::log_warning);
-				msg << "suspending capture";
-			}
-		} else {
-			std::cerr << strsignal(raised) << std::endl;
-		}
-		terminating = true;
-		for (const auto& src : sources) {
-			src->stop();
-		}
-		if (signer) {
-			signer->stop();
-		}
-		if (lsmonitor) {
-			lsmonitor->stop();
-		}
-		dst.end_session();
+	// Start capturing events.
+	for (const auto& src : sources) {
+		src->start();
+	}
 
-		if (raised != SIGALRM) {
-			break;
-		}
+	// Wait for signal to be raised, meanwhile flushing any
+	// records buffered by the destination endpoint at regular
+	// intervals.
+	int raised = masked_signals.milliwait(flush_interval);
+	while (raised == -1) {
+		dst.flush();
+		raised = masked_signals.milliwait(flush_interval);
+	}
 
-		// Cancel termination and consume any outstanding signals.
-		terminating = false;
-		while (raised == SIGALRM) {
-			raised = masked_signals.milliwait(0);
-		}
+	// Stop listening and exit.
+	std::cerr << strsignal(raised) << std::endl;
+	terminating = true;
+	for (const auto& src : sources) {
+		src->stop();
+	}
+	if (signer) {
+		signer->stop();
+	}
+	if (lsmonitor) {
+		lsmonitor->stop();
 	}
+	dst.end_session();
+	return 0;
 }
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,299 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+
+#include "horace/logger.h"
+#include "horace/log_message.h"
+#include "horace/stderr_logger.h"
+#include "horace/async_logger.h"
+#include "horace/horace_error.h"
+#include "horace/eof_error.h"
+#include "horace/signal_set.h"
+#include "horace/terminate_flag.h"
+#include "horace/buffer_pool.h"
+#include "horace/file_descriptor.h"
+#include "horace/file_octet_reader.h"
+#include "horace/string_attribute.h"
+#include "horace/session_context.h"
+#include "horace/record.h"
+#include "horace/session_writer.h"
+#include "horace/endpoint.h"
+#include "horace/session_writer_endpoint.h"
+
+using namespace horace;
+
+/** The interval at which to check for signals, in milliseconds. */
+const int poll_interval = 100;
+
+/** The size of the buffers used for reading spoolfiles, in octets. */
+const size_t read_bufsize = 0x100000;
+
+/** Print help text.
+ * @param out the ostream to which the help text should be written
+ */
+void write_help(std::ostream& out) {
+	out << "Usage: horace export [<args>] <spooldir> <destination>" << std::endl;
+	out << std::endl;
+	out << "Options:" << std::endl;
+	out << std::endl;
+	out << "  -h  display this help text then exit" << std::endl;
+	out << "  -j  set number of spoolfiles to convert concurrently" << std::endl;
+	out << "  -v  increase verbosity of log messages" << std::endl;
+}
+
+/** Find the spoolfiles beneath a spool directory.
+ * Spoolfiles are ordered by source ID then filenum, although this only
+ * affects the order in which conversion is started.
+ * @param pathname the pathname of the spool directory
+ * @return the pathnames of the spoolfiles
+ */
+std::vector<std::string> find_spoolfiles(const std::string& pathname) {
+	// Filenums may or may not be padded, so order by length first.
+	auto by_filenum = [](const std::string& lhs, const std::string& rhs) {
+		return (lhs.length() != rhs.length()) ?
+			(lhs.length() < rhs.length()) : (lhs < rhs);
+	};
+
+	std::vector<std::string> spoolfiles;
+	std::vector<std::string> srcids;
+	for (const auto& entry : std::filesystem::directory_iterator(pathname)) {
+		std::string srcid = entry.path().filename();
+		if (entry.is_directory() && (srcid[0] != '.')) {
+			srcids.push_back(srcid);
+		}
+	}
+	std::sort(srcids.begin(), srcids.end());
+
+	for (const auto& srcid : srcids) {
+		std::vector<std::string> filenames;
+		for (const auto& entry : std::filesystem::directory_iterator(
+			pathname + "/" + srcid)) {
+
+			std::string filename = entry.path().filename();
+			if (entry.is_regular_file() && (filename[0] != '.')) {
+				filenames.push_back(filename);
+			}
+		}
+		std::sort(filenames.begin(), filenames.end(), by_filenum);
+		for (const auto& filename : filenames) {
+			spoolfiles.push_back(pathname + "/" + srcid + "/" + filename);
+		}
+	}
+	return spoolfiles;
+}
+
+/** Convert a single spoolfile.
+ * Each spoolfile begins with a session record, so can be decoded without
+ * reference to any other spoolfile. The records are written to their own
+ * session writer, followed by a sync record to ensure that they have been
+ * delivered.
+ * @param pathname the pathname of the spoolfile
+ * @param dst_swep the destination
+ * @param pool the pool from which to acquire a read buffer
+ * @return the number of records converted
+ */
+uint64_t export_one(const std::string& pathname,
+	session_writer_endpoint& dst_swep, buffer_pool& pool) {
+
+	file_descriptor fd(pathname, O_RDONLY);
+	file_octet_reader in(fd, pool);
+	session_context session;
+
+	std::unique_ptr<record> srec = std::make_unique<record>(session, in);
+	if (srec->channel_id() != channel_session) {
+		throw horace_error("session record expected");
+	}
+	std::string srcid = srec->find_source().content();
+	std::unique_ptr<session_writer> dst_sw =
+		dst_swep.make_session_writer(srcid);
+	dst_sw->write(*srec);
+
+	uint64_t count = 1;
+	try {
+		while (true) {
+			terminating.poll();
+			record rec(session, in);
+			dst_sw->write(rec);
+			count += 1;
+		}
+	} catch (eof_error&) {
+		// No action: end of spoolfile.
+	}
+
+	attribute_list attrs;
+	dst_sw->write(record(channel_sync, std::move(attrs)));
+	while (true) {
+		std::unique_ptr<record> rec = dst_sw->read();
+		if (rec->channel_id() == channel_sync) {
+			break;
+		} else if (rec->channel_id() == channel_error) {
+			auto msgattr = rec->find_one<string_attribute>(
+				attrid_message);
+			throw horace_error("remote error: " + msgattr.content());
+		}
+	}
+	return count;
+}
+
+/** Convert spoolfiles until there are none remaining.
+ * @param spoolfiles the spoolfiles to be converted
+ * @param next the index of the next spoolfile to be converted
+ * @param dst_swep the destination
+ * @param failures the number of spoolfiles which could not be converted
+ * @param running the number of threads still running
+ */
+void export_some(const std::vector<std::string>& spoolfiles,
+	std::atomic<size_t>& next, session_writer_endpoint& dst_swep,
+	std::atomic<size_t>& failures, std::atomic<int>& running) {
+
+	buffer_pool pool(read_bufsize, 1);
+	try {
+		while (true) {
+			terminating.poll();
+			size_t index = next.fetch_add(1);
+			if (index >= spoolfiles.size()) {
+				break;
+			}
+
+			const std::string& pathname = spoolfiles[index];
+			try {
+				uint64_t count = export_one(pathname, dst_swep, pool);
+				if (log->enabled(logger::log_notice)) {
+					log_message msg(*log, logger::log_notice);
+					msg << "exported " << count <<
+						" records from " << pathname;
+				}
+			} catch (terminate_exception&) {
+				throw;
+			} catch (std::exception& ex) {
+				failures.fetch_add(1);
+				if (log->enabled(logger::log_err)) {
+					log_message msg(*log, logger::log_err);
+					msg << pathname << ": " << ex.what();
+				}
+			}
+		}
+	} catch (terminate_exception&) {
+		// No action.
+	}
+	running.fetch_sub(1);
+}
+
+int main2(int argc, char* argv[]) {
+	// Mask signals.
+	masked_signals.mask();
+
+	// Initialise default options.
+	int severity = logger::log_warning;
+	long jobs = std::thread::hardware_concurrency();
+
+	// Parse command line options.
+	int opt;
+	while ((opt = getopt(argc, argv, "+hj:v")) != -1) {
+		switch (opt) {
+		case 'h':
+			write_help(std::cout);
+			return 0;
+		case 'j':
+			jobs = std::stol(optarg);
+			break;
+		case 'v':
+			if (severity < logger::log_debug) {
+				severity += 1;
+			}
+			break;
+		}
+	}
+	if (jobs < 1) {
+		jobs = 1;
+	}
+
+	// Initialise logger.
+	log = std::make_unique<async_logger>(
+		std::make_unique<stderr_logger>());
+	log->severity(severity);
+
+	// Parse source spool directory.
+	if (optind == argc) {
+		std::cerr << "Spool directory not specified."
+			<< std::endl;
+		exit(1);
+	}
+	std::string spooldir = argv[optind++];
+
+	// Parse destination endpoint.
+	if (optind == argc) {
+		std::cerr << "Destination endpoint not specified."
+			<< std::endl;
+		exit(1);
+	}
+	std::unique_ptr<endpoint> dst_ep =
+		endpoint::make(argv[optind++]);
+	session_writer_endpoint* dst_swep =
+		dynamic_cast<session_writer_endpoint*>(dst_ep.get());
+	if (!dst_swep) {
+		std::cerr << "Destination endpoint is unable to receive sessions."
+			<< std::endl;
+		exit(1);
+	}
+
+	if (optind != argc) {
+		std::cerr << "Too many arguments on command line."
+			<< std::endl;
+	}
+
+	// Convert spoolfiles using the requested number of threads.
+	std::vector<std::string> spoolfiles = find_spoolfiles(spooldir);
+	std::atomic<size_t> next(0);
+	std::atomic<size_t> failures(0);
+	std::atomic<int> running(jobs);
+	std::vector<std::thread> threads;
+	for (long i = 0; i != jobs; ++i) {
+		threads.emplace_back(export_some, std::cref(spoolfiles),
+			std::ref(next), std::ref(*dst_swep), std::ref(failures),
+			std::ref(running));
+	}
+
+	// Wait for the threads to finish, or for a terminating signal
+	// to be raised.
+	bool interrupted = false;
+	while (running.load() && !interrupted) {
+		int raised = masked_signals.milliwait(poll_interval);
+		if (raised != -1) {
+			std::cerr << strsignal(raised) << std::endl;
+			terminating = true;
+			interrupted = true;
+		}
+	}
+	for (auto& th : threads) {
+		th.join();
+	}
+
+	if (failures.load()) {
+		std::cerr << failures.load() << " of " << spoolfiles.size() <<
+			" spoolfiles could not be exported." << std::endl;
+		return 1;
+	}
+	return (interrupted) ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+	try {
+		return main2(argc, argv);
+	} catch (const std::exception& ex) {
+		std::cerr << ex.what() << std::endl;
+		exit(1);
+	}
+}
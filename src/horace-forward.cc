@@ -12,7 +12,12 @@
 
 #include "horace/logger.h"
 #include "horace/log_message.h"
+#include "horace/log_limiter.h"
 #include "horace/stderr_logger.h"
+#include "horace/async_logger.h"
+#include "horace/stats_group.h"
+#include "horace/stats_timer.h"
+#include "horace/stats_server.h"
 #include "horace/horace_error.h"
 #include "horace/signal_set.h"
 #include "horace/terminate_flag.h"
@@ -23,6 +28,7 @@
 #include "horace/session_listener.h"
 #include "horace/session_reader.h"
 #include "horace/session_writer.h"
+#include "horace/session_flusher.h"
 #include "horace/endpoint.h"
 #include "horace/session_listener_endpoint.h"
 #include "horace/session_writer_endpoint.h"
@@ -32,6 +38,9 @@ using namespace horace;
 // Pointers to all forwarding threads.
 std::vector<std::thread> threads;
 
+/** The interval at which buffered records are flushed. */
+const auto flush_interval = std::chrono::milliseconds(100);
+
 /** Print help text.
  * @param out the ostream to which the help text should be written
  */
@@ -41,6 +50,7 @@ void write_help(std::ostream& out) {
 	out << "Options:" << std::endl;
 	out << std::endl;
 	out << "  -h  display this help text then exit" << std::endl;
+	out << "  -s  serve statistics on UNIX domain socket" << std::endl;
 	out << "  -v  increase verbosity of log messages" << std::endl;
 }
 
@@ -70,6 +80,7 @@ void handle_unexpected_record(session_reader& src_sr, const record& rec) {
 void forward_one(session_reader& src_sr, session_writer_endpoint& dst_swep) {
 	uint64_t expected_seqnum = 0;
 	bool initial_seqnum = true;
+	log_limiter discontinuity_limiter;
 
 	// Read the session record.
 	std::unique_ptr<record> srec = src_sr.read();
@@ -94,13 +105,24 @@ void forward_one(session_reader& src_sr, session_writer_endpoint& dst_swep) {
 
 	// Create a session writer using the source ID from the
 	// session record.
-	std::string srcid = srec->find_one<string_attribute>(
-		attrid_source).content();
+	std::string srcid = srec->find_source().content();
 	std::unique_ptr<session_writer> dst_sw = dst_swep.make_session_writer(srcid);
 
+	// Create statistics for this source ID.
+	stats_group stats("forward." + srcid);
+	stats_counter& records = stats.counter("records");
+	stats_counter& discontinuities = stats.counter("discontinuities");
+	stats_histogram& sync_rtt_ns = stats.histogram("sync_rtt_ns");
+
 	// Attempt to write the session record.
 	dst_sw->write(*srec);
 
+	// The destination may buffer records, so flush them at regular
+	// intervals in case the flow of records stops. Once the flusher
+	// has been started, the destination must only be used while
+	// holding its mutex.
+	session_flusher flusher(*dst_sw, flush_interval);
+
 	// Copy records from source to destination. Watch for
 	// session records and sync records, which require special
 	// handling.
@@ -111,41 +133,49 @@ void forward_one(session_reader& src_sr, session_writer_endpoint& dst_swep) {
 
 		// Check whether a record is readable from the destination
 		// endpoint (error or warning).
-		if (dst_sw->readable()) {
-			auto rec = dst_sw->read();
-			rec->log(*log);
-			handle_unexpected_record(src_sr, *rec);
+		{
+			std::lock_guard<std::mutex> lk(flusher.mutex());
+			if (dst_sw->readable()) {
+				auto rec = dst_sw->read();
+				rec->log(*log);
+				handle_unexpected_record(src_sr, *rec);
+			}
 		}
 
-		// Read record from source endpoint.
+		// Read record from source endpoint. (The mutex must not
+		// be held while doing this, since it may block.)
 		std::unique_ptr<record> rec = src_sr.read();
 
 		// Log the record.
 		rec->log(*log);
 
 		// Attempt to write record to destination.
+		std::lock_guard<std::mutex> lk(flusher.mutex());
 		dst_sw->write(*rec);
+		records.add();
 
 		// Perform any special handling required by specific
 		// record types.
 		switch (rec->channel_id()) {
 		case channel_sync:
 			// Sync records must be acknowledged.
-			while (true) {
-				auto rec = dst_sw->read();
-				rec->log(*log);
-				if (rec->channel_id() == channel_sync) {
-					src_sr.write(*rec);
-					break;
-				} else {
-					handle_unexpected_record(src_sr, *rec);
+			{
+				stats_timer timer(sync_rtt_ns);
+				while (true) {
+					auto rec = dst_sw->read();
+					rec->log(*log);
+					if (rec->channel_id() == channel_sync) {
+						src_sr.write(*rec);
+						break;
+					} else {
+						handle_unexpected_record(src_sr, *rec);
+					}
 				}
 			}
 		default:
 			if (rec->is_event()) {
 				// Update sequence number, log any discontinuties.
-				uint64_t seqnum = rec->find_one<unsigned_integer_attribute>(
-					attrid_seqnum).content();
+				uint64_t seqnum = rec->find_seqnum().content();
 				if (initial_seqnum) {
 					if (log->enabled(logger::log_notice)) {
 						log_message msg(*log, logger::log_notice);
@@ -153,11 +183,20 @@ void forward_one(session_reader& src_sr, session_writer_endpoint& dst_swep) {
 					}
 					initial_seqnum = false;
 				} else if (seqnum != expected_seqnum) {
-					if (log->enabled(logger::log_warning)) {
+					discontinuities.add();
+					if (log->enabled(logger::log_warning) &&
+						discontinuity_limiter.permit()) {
+
 						log_message msg(*log, logger::log_warning);
 						msg << "seqnum discontinuity (" <<
 							"expected=" << expected_seqnum << ", " <<
 							"observed=" << seqnum << ")";
+						if (uint64_t count =
+							discontinuity_limiter.suppressed()) {
+
+							msg << ", " << count <<
+								" more suppressed";
+						}
 					}
 				}
 				expected_seqnum = seqnum + 1;
@@ -256,14 +295,18 @@ int main(int argc, char* argv[]) {
 
 	// Initialise default options.
 	int severity = logger::log_warning;
+	const char* stats_pathname = 0;
 
 	// Parse command line options.
 	int opt;
-	while ((opt = getopt(argc, argv, "+hv")) != -1) {
+	while ((opt = getopt(argc, argv, "+hs:v")) != -1) {
 		switch (opt) {
 		case 'h':
 			write_help(std::cout);
 			return 0;
+		case 's':
+			stats_pathname = optarg;
+			break;
 		case 'v':
 			if (severity < logger::log_debug) {
 				severity += 1;
@@ -273,7 +316,8 @@ int main(int argc, char* argv[]) {
 	}
 
 	// Initialise logger.
-	log = std::make_unique<stderr_logger>();
+	log = std::make_unique<async_logger>(
+		std::make_unique<stderr_logger>());
 	log->severity(severity);
 
 	// Parse source endpoint.
@@ -317,6 +361,12 @@ int main(int argc, char* argv[]) {
 			<< std::endl;
 	}
 
+	// Start statistics server if one has been requested.
+	std::unique_ptr<stats_server> stats_srv;
+	if (stats_pathname) {
+		stats_srv = std::make_unique<stats_server>(stats_pathname);
+	}
+
 	// Forward events.
 	std::thread all_th(forward_all,
 		std::ref(*src_slep), std::ref(*dst_swep));
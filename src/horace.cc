@@ -28,6 +28,7 @@ void write_help(std::ostream& out) {
 	out << std::endl;
 	out << "  capture  capture data from host" << std::endl;
 	out << "  forward  forward data from one endpoint to another" << std::endl;
+	out << "  export   convert spoolfiles concurrently to another format" << std::endl;
 	out << "  genkey   generate keypair for signing" << std::endl;
 }
 
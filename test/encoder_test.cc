@@ -0,0 +1,218 @@
+// This file is part of libholmes.
+// Copyright 2019 Graham Shaw
+// Redistribution and modification are permitted within the terms of the
+// BSD-3-Clause licence as defined by v3.4 of the SPDX Licence List.
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "horace/unsigned_integer_attribute.h"
+#include "horace/string_attribute.h"
+#include "horace/timestamp_attribute.h"
+#include "horace/attribute_list.h"
+#include "horace/octet_reader.h"
+#include "horace/octet_writer.h"
+#include "horace/record.h"
+#include "horace/session_builder.h"
+#include "horace/session_context.h"
+#include "horace/dictionary_encoder.h"
+#include "horace/delta_encoder.h"
+#include "horace/template_encoder.h"
+
+using namespace horace;
+
+namespace {
+
+/** The number of sessions in the test stream. */
+const int session_count = 2;
+
+/** The number of event records in each session. */
+const int event_count = 1000;
+
+/** The labels of the attributes to which the dictionary applies. */
+const std::vector<std::string> dictionary_labels = {
+	"hostname", "syslog_appname" };
+
+/** Serialise a record.
+ * @param rec the record to be serialised
+ * @return the serialised record
+ */
+std::string serialise(const record& rec) {
+	std::string data(rec.length(), 0);
+	octet_writer out(data.data(), data.length());
+	rec.write(out);
+	return data;
+}
+
+/** Make a stream of records for testing.
+ * The event records vary in which attributes they contain, so that
+ * templates must be redeclared and some attributes fall outside them,
+ * and include repeated attributes which the dictionary must leave
+ * unchanged.
+ * @return the records, in the order in which they should be written
+ */
+std::vector<std::unique_ptr<record>> make_records() {
+	std::vector<std::unique_ptr<record>> records;
+	uint64_t seqnum = 0;
+	struct timespec ts = { 1577836800, 0 };
+	for (int s = 0; s != session_count; ++s) {
+		session_builder sb("test", "utc");
+		int host_attr = sb.define_attribute("hostname", type_string);
+		int app_attr = sb.define_attribute("syslog_appname",
+			type_string);
+		int procid_attr = sb.define_attribute("syslog_procid",
+			type_string);
+		int msg_attr = sb.define_attribute("message", type_string);
+		int channel = sb.define_channel("test", attribute_list());
+		records.push_back(sb.build());
+
+		for (int i = 0; i != event_count; ++i) {
+			// Mostly consecutive sequence numbers, with an
+			// occasional gap, and timestamps which mostly
+			// increase but occasionally step backwards.
+			seqnum += (i % 97 == 0) ? 3 : 1;
+			ts.tv_nsec += (i % 31 == 0) ? -1000 : 1234567;
+			if (ts.tv_nsec < 0) {
+				ts.tv_sec -= 1;
+				ts.tv_nsec += 1000000000;
+			} else if (ts.tv_nsec >= 1000000000) {
+				ts.tv_sec += 1;
+				ts.tv_nsec -= 1000000000;
+			}
+
+			attribute_list attrs;
+			attrs.insert(std::make_unique<unsigned_integer_attribute>(
+				attrid_seqnum, seqnum));
+			attrs.insert(std::make_unique<timestamp_attribute>(
+				attrid_ts, ts));
+			attrs.insert(std::make_unique<string_attribute>(host_attr,
+				"web-" + std::to_string(i % 8) + ".example.com"));
+			if (i % 5 == 0) {
+				attrs.insert(std::make_unique<string_attribute>(
+					host_attr, "relay.example.com"));
+			}
+			if (i % 7 != 0) {
+				attrs.insert(std::make_unique<string_attribute>(
+					app_attr, (i % 3) ? "nginx" : "sshd"));
+			}
+			if (i >= event_count / 2) {
+				attrs.insert(std::make_unique<string_attribute>(
+					procid_attr, std::to_string(i % 4)));
+			}
+			attrs.insert(std::make_unique<string_attribute>(msg_attr,
+				"message " + std::to_string(i)));
+			records.push_back(std::make_unique<record>(channel,
+				std::move(attrs)));
+		}
+	}
+	return records;
+}
+
+/** Encode and decode a stream of records using a given combination of
+ * encoders, then check that the decoded records are identical to the
+ * originals.
+ * @param records the records to be encoded
+ * @param dictionary true to use a string dictionary, otherwise false
+ * @param delta true to use delta encoding, otherwise false
+ * @param templates true to use record templates, otherwise false
+ * @param size a buffer to receive the size of the encoded stream
+ * @return true if the test passed, otherwise false
+ */
+bool round_trip(const std::vector<std::unique_ptr<record>>& records,
+	bool dictionary, bool delta, bool templates, size_t& size) {
+
+	std::unique_ptr<dictionary_encoder> senc;
+	if (dictionary) {
+		senc = std::make_unique<dictionary_encoder>(dictionary_labels);
+	}
+	std::unique_ptr<delta_encoder> denc;
+	if (delta) {
+		denc = std::make_unique<delta_encoder>();
+	}
+	std::unique_ptr<template_encoder> tenc;
+	if (templates) {
+		tenc = std::make_unique<template_encoder>();
+	}
+
+	std::string stream;
+	for (const auto& orig_rec : records) {
+		const record& srec = (senc) ? senc->encode(*orig_rec) : *orig_rec;
+		const record& drec = (denc) ? denc->encode(srec) : srec;
+		const record& rec = (tenc) ? tenc->encode(drec) : drec;
+		stream += serialise(rec);
+	}
+	size = stream.length();
+
+	// The decoded records are compared only once the whole stream has
+	// been decoded, so that records from the first session are still
+	// accessed after the second session record has been read.
+	session_context session;
+	octet_reader in(stream.data(), stream.length(), stream.length());
+	std::vector<std::unique_ptr<record>> decoded;
+	for (size_t i = 0; i != records.size(); ++i) {
+		decoded.push_back(std::make_unique<record>(session, in));
+	}
+	for (size_t i = 0; i != records.size(); ++i) {
+		if (serialise(*decoded[i]) != serialise(*records[i])) {
+			std::cerr << "record " << i << " differs" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+} /* anonymous namespace */
+
+int main() {
+	std::vector<std::unique_ptr<record>> records = make_records();
+
+	// Test every combination of encoders, indexed by a bit mask.
+	const int dictionary_bit = 1;
+	const int delta_bit = 2;
+	const int templates_bit = 4;
+	std::vector<size_t> sizes(8);
+	int failures = 0;
+	for (int mask = 0; mask != 8; ++mask) {
+		std::string name = "plain";
+		if (mask) {
+			name.clear();
+			if (mask & dictionary_bit) {
+				name += "+dictionary";
+			}
+			if (mask & delta_bit) {
+				name += "+delta";
+			}
+			if (mask & templates_bit) {
+				name += "+templates";
+			}
+			name.erase(0, 1);
+		}
+
+		bool passed = false;
+		try {
+			passed = round_trip(records, mask & dictionary_bit,
+				mask & delta_bit, mask & templates_bit, sizes[mask]);
+		} catch (std::exception& ex) {
+			std::cerr << ex.what() << std::endl;
+		}
+		std::cout << (passed ? "PASS " : "FAIL ") << name << " (" <<
+			sizes[mask] << " octets)" << std::endl;
+		if (!passed) {
+			failures += 1;
+		}
+	}
+
+	// Adding templates to any combination of the other encoders
+	// should make the stream smaller, not larger.
+	for (int mask = 0; mask != templates_bit; ++mask) {
+		if (sizes[mask | templates_bit] >= sizes[mask]) {
+			std::cout << "FAIL templates did not reduce size (mask " <<
+				mask << ")" << std::endl;
+			failures += 1;
+		}
+	}
+	return failures ? 1 : 0;
+}